@@ -13,8 +13,10 @@
 
 /********************************* Includes **********************************/
 #include "PeripheralInstances.h"
+#include "SystemConf.h"
 
 #include "HalUartInterface.h"
+#include "HalTimerInterface.h"
 #include "GpioInterfaceImpl.h"
 #include "OsInterfaceImpl.h"
 
@@ -25,13 +27,126 @@
 using dynamixel::Motor;
 using dynamixel::DaisyChain;
 using dynamixel::DaisyChainParams;
+using dynamixel::DirectionControl;
+using dynamixel::MotorGroup;
+using dynamixel::ReturnDelayTuner;
+using dynamixel::TelemetryScheduler;
+using dynamixel::Telemetry;
+using dynamixel::Protocol;
+using uart::CircularDmaBuffer;
 using uart::HalUartInterface;
+using timer::HalTimerInterface;
 using os::OsInterfaceImpl;
 using gpio::GpioInterfaceImpl;
 
 
 
 
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Size of each motor daisy chain's streaming reception buffer. This is
+ *        enough for a BULK_READ reply from a full group with room to spare
+ */
+constexpr size_t MOTOR_RX_BUFF_SIZE = 128;
+
+/**
+ * @brief Number of rounds of pings made to the motors on a daisy chain before
+ *        bring-up gives up on them. A round to motors that are still booting
+ *        lasts at least the UART's max block time per motor
+ */
+constexpr uint16_t BRING_UP_PING_ROUNDS = 100;
+
+/**
+ * @brief Rate at which the leg motor positions are read, in Hz. They are
+ *        needed for every control cycle
+ */
+constexpr uint32_t LEG_POSITION_RATE_HZ = 500;
+
+/**
+ * @brief Rate at which the head and arm motor positions are read, in Hz.
+ *        Nothing closes a loop on these yet, so they are read at a tenth of
+ *        the rate of the legs
+ */
+constexpr uint32_t ARM_POSITION_RATE_HZ = 50;
+
+/**
+ * @brief Rate at which the leg motor loads are read, in Hz. They're sent to
+ *        the PC with every state, which can't use them as fast as positions
+ */
+constexpr uint32_t LEG_LOAD_RATE_HZ = 100;
+
+/**
+ * @brief Rate at which every motor's temperature and supply voltage are read,
+ *        in Hz. Both change over seconds, and the PC watches the hottest and
+ *        lowest of them
+ */
+constexpr uint32_t HEALTH_RATE_HZ = 2;
+
+/**
+ * @brief The return delay time is the time the motor waits before sending
+ *        back data for a read request. We found that a value of 100 us worked
+ *        reliably while values lower than this would cause packets to be
+ *        dropped more frequently. The return delay tuner, when enabled, starts
+ *        from here
+ */
+constexpr uint16_t RETURN_DELAY_TIME = 100;
+
+/**
+ * @brief Time a motor UART waits for a transfer to complete beyond the time
+ *        the bytes take on the wire, in microseconds. This covers the return
+ *        delay time with room to spare. The waiting task is woken up by its
+ *        wakeup timer once it runs out (@see initWakeupTimers), so a motor
+ *        that does not answer costs about this long rather than the rest of
+ *        an OS tick
+ */
+constexpr uint32_t MOTOR_MAX_BLOCK_TIME_US = 300;
+
+/**
+ * @brief Time a motor UART waits for a transfer to complete until bring-up
+ *        sets the return delay time, in microseconds. This covers the factory
+ *        return delay time (500 us) with room to spare
+ */
+constexpr uint32_t MOTOR_BRING_UP_BLOCK_TIME_US = 2000;
+
+/** @brief Rate the wakeup timers count at, in Hz */
+constexpr uint32_t WAKEUP_TIMER_RATE_HZ = 1000000;
+
+/**
+ * @brief Priority of the wakeup timer interrupts. They notify threads, so
+ *        like the UART interrupts they must not be more urgent than
+ *        configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+ */
+constexpr uint32_t WAKEUP_TIMER_IRQ_PRIORITY = 5;
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+uint32_t readCycleCounter(){
+    return DWT->CYCCNT;
+}
+
+} // end anonymous namespace
+
+
+
+
+/********************************** Globals **********************************/
+// Variables
+// ----------------------------------------------------------------------------
+// Wake up the motor UART threads at their microsecond timeouts. Unlike the
+// other peripherals these aren't generated, and their interrupt handlers are
+// in stm32f*xx_it.c
+TIM_HandleTypeDef htim2;
+TIM_HandleTypeDef htim5;
+
+
+
+
 /********************************** periph ***********************************/
 namespace periph{
 // Variables
@@ -40,48 +155,116 @@ HalUartInterface uartif;
 OsInterfaceImpl osif;
 GpioInterfaceImpl gpioif;
 
+HalTimerInterface timerif;
+
+// The streaming receptions also signal their threads when the line goes idle,
+// which is once a status packet or the echo of a request has come in
+//
+// The bus direction pins are not on the UARTs' DE pins, so the bus is
+// released from the transmission complete interrupt rather than by the UARTs
+// themselves (DirectionControl::DRIVER_ENABLE)
 UartDriver upperLeftLegDriver(&osif, &uartif, UART_HANDLE_UpperLeftLeg);
+uint8_t upperLeftLegRxBuff[MOTOR_RX_BUFF_SIZE];
+CircularDmaBuffer upperLeftLegRxBuffer(
+    UART_HANDLE_UpperLeftLeg,
+    &uartif,
+    MOTOR_RX_BUFF_SIZE,
+    MOTOR_RX_BUFF_SIZE,
+    upperLeftLegRxBuff,
+    true
+);
 DaisyChainParams upperLeftLegParams = {
     &upperLeftLegDriver,
     &gpioif,
     GPIOA,
-    GPIO_PIN_8
+    GPIO_PIN_8,
+    Protocol::V1,
+    &upperLeftLegRxBuffer,
+    DirectionControl::TC_INTERRUPT
 };
 DaisyChain upperLeftLegDaisyChain(upperLeftLegParams);
 
 UartDriver lowerRightLegDriver(&osif, &uartif, UART_HANDLE_LowerRightLeg);
+uint8_t lowerRightLegRxBuff[MOTOR_RX_BUFF_SIZE];
+CircularDmaBuffer lowerRightLegRxBuffer(
+    UART_HANDLE_LowerRightLeg,
+    &uartif,
+    MOTOR_RX_BUFF_SIZE,
+    MOTOR_RX_BUFF_SIZE,
+    lowerRightLegRxBuff,
+    true
+);
 DaisyChainParams lowerRightLegParams = {
     &lowerRightLegDriver,
     &gpioif,
     GPIOA,
-    GPIO_PIN_4
+    GPIO_PIN_4,
+    Protocol::V1,
+    &lowerRightLegRxBuffer,
+    DirectionControl::TC_INTERRUPT
 };
 DaisyChain lowerRightLegDaisyChain(lowerRightLegParams);
 
 UartDriver headAndArmsDriver(&osif, &uartif, UART_HANDLE_HeadAndArms);
+uint8_t headAndArmsRxBuff[MOTOR_RX_BUFF_SIZE];
+CircularDmaBuffer headAndArmsRxBuffer(
+    UART_HANDLE_HeadAndArms,
+    &uartif,
+    MOTOR_RX_BUFF_SIZE,
+    MOTOR_RX_BUFF_SIZE,
+    headAndArmsRxBuff,
+    true
+);
 DaisyChainParams headAndArmsParams = {
     &headAndArmsDriver,
     &gpioif,
     GPIOB,
-    GPIO_PIN_2
+    GPIO_PIN_2,
+    Protocol::V1,
+    &headAndArmsRxBuffer,
+    DirectionControl::TC_INTERRUPT
 };
 DaisyChain headAndArmsDaisyChain(headAndArmsParams);
 
 UartDriver upperRightLegDriver(&osif, &uartif, UART_HANDLE_UpperRightLeg);
+uint8_t upperRightLegRxBuff[MOTOR_RX_BUFF_SIZE];
+CircularDmaBuffer upperRightLegRxBuffer(
+    UART_HANDLE_UpperRightLeg,
+    &uartif,
+    MOTOR_RX_BUFF_SIZE,
+    MOTOR_RX_BUFF_SIZE,
+    upperRightLegRxBuff,
+    true
+);
 DaisyChainParams upperRightLegParams = {
     &upperRightLegDriver,
     &gpioif,
     GPIOC,
-    GPIO_PIN_3
+    GPIO_PIN_3,
+    Protocol::V1,
+    &upperRightLegRxBuffer,
+    DirectionControl::TC_INTERRUPT
 };
 DaisyChain upperRightLegDaisyChain(upperRightLegParams);
 
 UartDriver lowerLeftLegDriver(&osif, &uartif, UART_HANDLE_LowerLeftLeg);
+uint8_t lowerLeftLegRxBuff[MOTOR_RX_BUFF_SIZE];
+CircularDmaBuffer lowerLeftLegRxBuffer(
+    UART_HANDLE_LowerLeftLeg,
+    &uartif,
+    MOTOR_RX_BUFF_SIZE,
+    MOTOR_RX_BUFF_SIZE,
+    lowerLeftLegRxBuff,
+    true
+);
 DaisyChainParams lowerLeftLegParams = {
     &lowerLeftLegDriver,
     &gpioif,
     GPIOC,
-    GPIO_PIN_8
+    GPIO_PIN_8,
+    Protocol::V1,
+    &lowerLeftLegRxBuffer,
+    DirectionControl::TC_INTERRUPT
 };
 DaisyChain lowerLeftLegDaisyChain(lowerLeftLegParams);
 
@@ -104,6 +287,30 @@ AX12A motor16(16, &headAndArmsDaisyChain);
 AX12A motor17(17, &headAndArmsDaisyChain);
 AX12A motor18(18, &headAndArmsDaisyChain);
 
+// Writes to these reach every motor on their daisy chain at once. They are
+// never answered, so each one costs a single packet
+MX28 lowerRightLegBroadcast(dynamixel::BROADCAST_ID, &lowerRightLegDaisyChain);
+MX28 upperRightLegBroadcast(dynamixel::BROADCAST_ID, &upperRightLegDaisyChain);
+MX28 upperLeftLegBroadcast(dynamixel::BROADCAST_ID, &upperLeftLegDaisyChain);
+MX28 lowerLeftLegBroadcast(dynamixel::BROADCAST_ID, &lowerLeftLegDaisyChain);
+AX12A headAndArmsBroadcast(dynamixel::BROADCAST_ID, &headAndArmsDaisyChain);
+
+std::array<Motor*, NUM_CHAINS> broadcastMotors = {
+    &lowerRightLegBroadcast,
+    &upperRightLegBroadcast,
+    &upperLeftLegBroadcast,
+    &lowerLeftLegBroadcast,
+    &headAndArmsBroadcast
+};
+
+std::array<UartDriver*, NUM_CHAINS> motorDrivers = {
+    &lowerRightLegDriver,
+    &upperRightLegDriver,
+    &upperLeftLegDriver,
+    &lowerLeftLegDriver,
+    &headAndArmsDriver
+};
+
 std::array<Motor*, 18> motors = {
     &motor1,
     &motor2,
@@ -125,6 +332,78 @@ std::array<Motor*, 18> motors = {
     &motor18
 };
 
+MotorGroup lowerRightLegGroup(
+    &lowerRightLegDaisyChain,
+    {&motor1, &motor2, &motor3}
+);
+MotorGroup upperRightLegGroup(
+    &upperRightLegDaisyChain,
+    {&motor4, &motor5, &motor6}
+);
+MotorGroup upperLeftLegGroup(
+    &upperLeftLegDaisyChain,
+    {&motor7, &motor8, &motor9}
+);
+MotorGroup lowerLeftLegGroup(
+    &lowerLeftLegDaisyChain,
+    {&motor10, &motor11, &motor12}
+);
+MotorGroup headAndArmsGroup(
+    &headAndArmsDaisyChain,
+    {&motor13, &motor14, &motor15, &motor16, &motor17, &motor18}
+);
+
+std::array<MotorGroup*, NUM_CHAINS> motorGroups = {
+    &lowerRightLegGroup,
+    &upperRightLegGroup,
+    &upperLeftLegGroup,
+    &lowerLeftLegGroup,
+    &headAndArmsGroup
+};
+
+ReturnDelayTuner lowerRightLegTuner(&lowerRightLegGroup, readCycleCounter);
+ReturnDelayTuner upperRightLegTuner(&upperRightLegGroup, readCycleCounter);
+ReturnDelayTuner upperLeftLegTuner(&upperLeftLegGroup, readCycleCounter);
+ReturnDelayTuner lowerLeftLegTuner(&lowerLeftLegGroup, readCycleCounter);
+ReturnDelayTuner headAndArmsTuner(&headAndArmsGroup, readCycleCounter);
+
+std::array<ReturnDelayTuner*, NUM_CHAINS> returnDelayTuners = {
+    &lowerRightLegTuner,
+    &upperRightLegTuner,
+    &upperLeftLegTuner,
+    &lowerLeftLegTuner,
+    &headAndArmsTuner
+};
+
+TelemetryScheduler lowerRightLegScheduler(
+    &lowerRightLegGroup,
+    TELEMETRY_CYCLE_RATE_HZ
+);
+TelemetryScheduler upperRightLegScheduler(
+    &upperRightLegGroup,
+    TELEMETRY_CYCLE_RATE_HZ
+);
+TelemetryScheduler upperLeftLegScheduler(
+    &upperLeftLegGroup,
+    TELEMETRY_CYCLE_RATE_HZ
+);
+TelemetryScheduler lowerLeftLegScheduler(
+    &lowerLeftLegGroup,
+    TELEMETRY_CYCLE_RATE_HZ
+);
+TelemetryScheduler headAndArmsScheduler(
+    &headAndArmsGroup,
+    TELEMETRY_CYCLE_RATE_HZ
+);
+
+std::array<TelemetryScheduler*, NUM_CHAINS> telemetrySchedulers = {
+    &lowerRightLegScheduler,
+    &upperRightLegScheduler,
+    &upperLeftLegScheduler,
+    &lowerLeftLegScheduler,
+    &headAndArmsScheduler
+};
+
 MPU6050 imuData(&hi2c1);
 
 
@@ -141,6 +420,14 @@ void initMotorIOType(IO_Type io_type){
     upperRightLegDriver.setMaxBlockTime(MOTOR_MAX_BLOCK_TIME);
     lowerLeftLegDriver.setMaxBlockTime(MOTOR_MAX_BLOCK_TIME);
 
+    // Timeouts in microseconds wait past the notifications a streaming
+    // reception sends its thread, where ones in OS ticks would be cut short
+    const uint32_t cyclesPerUs = SystemCoreClock / 1000000;
+    for(UartDriver* driver : motorDrivers){
+        driver->setCycleCounter(readCycleCounter, cyclesPerUs);
+        driver->setMaxBlockTimeUs(MOTOR_BRING_UP_BLOCK_TIME_US);
+    }
+
     upperLeftLegDaisyChain.setIOType(io_type);
     lowerRightLegDaisyChain.setIOType(io_type);
     headAndArmsDaisyChain.setIOType(io_type);
@@ -148,6 +435,218 @@ void initMotorIOType(IO_Type io_type){
     lowerLeftLegDaisyChain.setIOType(io_type);
 }
 
+void initMotorStreaming(){
+    constexpr size_t NUM_DAISY_CHAINS = 5;
+    DaisyChain* const chains[NUM_DAISY_CHAINS] = {
+        &upperLeftLegDaisyChain,
+        &lowerRightLegDaisyChain,
+        &headAndArmsDaisyChain,
+        &upperRightLegDaisyChain,
+        &lowerLeftLegDaisyChain
+    };
+    const UART_HandleTypeDef* const uarts[NUM_DAISY_CHAINS] = {
+        UART_HANDLE_UpperLeftLeg,
+        UART_HANDLE_LowerRightLeg,
+        UART_HANDLE_HeadAndArms,
+        UART_HANDLE_UpperRightLeg,
+        UART_HANDLE_LowerLeftLeg
+    };
+
+    for(size_t i = 0; i < NUM_DAISY_CHAINS; ++i){
+        // The receive DMA streams are generated in normal mode for the
+        // exact-size transfers used without streaming
+        DMA_HandleTypeDef* hdmarx = uarts[i]->hdmarx;
+        hdmarx->Init.Mode = DMA_CIRCULAR;
+        HAL_DMA_Init(hdmarx);
+
+        chains[i]->startStreaming();
+    }
+}
+
+bool initMotorDirectionControl(){
+    bool success = true;
+    success &= upperLeftLegDaisyChain.initDirectionControl();
+    success &= lowerRightLegDaisyChain.initDirectionControl();
+    success &= headAndArmsDaisyChain.initDirectionControl();
+    success &= upperRightLegDaisyChain.initDirectionControl();
+    success &= lowerLeftLegDaisyChain.initDirectionControl();
+    return success;
+}
+
+bool onMotorTransmitComplete(const UART_HandleTypeDef* huart){
+    if(huart == UART_HANDLE_UpperLeftLeg){
+        return upperLeftLegDaisyChain.onTransmitComplete();
+    }
+    else if(huart == UART_HANDLE_LowerRightLeg){
+        return lowerRightLegDaisyChain.onTransmitComplete();
+    }
+    else if(huart == UART_HANDLE_HeadAndArms){
+        return headAndArmsDaisyChain.onTransmitComplete();
+    }
+    else if(huart == UART_HANDLE_UpperRightLeg){
+        return upperRightLegDaisyChain.onTransmitComplete();
+    }
+    else if(huart == UART_HANDLE_LowerLeftLeg){
+        return lowerLeftLegDaisyChain.onTransmitComplete();
+    }
+
+    return true;
+}
+
+void onMotorStreamWrapped(const UART_HandleTypeDef* huart){
+    if(huart == UART_HANDLE_UpperLeftLeg){
+        upperLeftLegRxBuffer.onTransferComplete();
+    }
+    else if(huart == UART_HANDLE_LowerRightLeg){
+        lowerRightLegRxBuffer.onTransferComplete();
+    }
+    else if(huart == UART_HANDLE_HeadAndArms){
+        headAndArmsRxBuffer.onTransferComplete();
+    }
+    else if(huart == UART_HANDLE_UpperRightLeg){
+        upperRightLegRxBuffer.onTransferComplete();
+    }
+    else if(huart == UART_HANDLE_LowerLeftLeg){
+        lowerLeftLegRxBuffer.onTransferComplete();
+    }
+}
+
+bool bringUpChain(uint8_t chain){
+    if(chain >= NUM_CHAINS){
+        return false;
+    }
+
+    // Configure the motors even if some of them never answered, so that the
+    // rest are usable
+    bool success = motorGroups[chain]->waitUntilReady(BRING_UP_PING_ROUNDS);
+
+    // The settings below are the same for every motor, so each one goes out
+    // as a single broadcast write
+    Motor* all = broadcastMotors[chain];
+
+    // Configure motors to return status packets only for read commands
+    success &= all->setStatusReturnLevel(
+        dynamixel::StatusReturnLevel::READS_ONLY
+    );
+
+    success &= all->setReturnDelayTime(RETURN_DELAY_TIME);
+
+    // Until now the motors could have been using their factory return delay
+    // time, which the bring-up timeout covers. The tuner never tries delays
+    // longer than this timeout covers, so it applies either way
+    motorDrivers[chain]->setMaxBlockTimeUs(MOTOR_MAX_BLOCK_TIME_US);
+
+    success &= all->enableTorque(true);
+
+    if(chain == HEAD_AND_ARMS){
+        // AX12A-only config for controls
+        success &= headAndArmsBroadcast.setComplianceSlope(5);
+        success &= headAndArmsBroadcast.setComplianceMargin(1);
+    }
+
+    return success;
+}
+
+void initTelemetrySchedules(){
+    // Loads are only sent to the PC for the legs, so the arm loads are left
+    // unscheduled (rate 0)
+    for(uint8_t i = LOWER_RIGHT_LEG; i <= LOWER_LEFT_LEG; ++i){
+        telemetrySchedulers[i]->setRate(
+            Telemetry::POSITION,
+            LEG_POSITION_RATE_HZ
+        );
+        telemetrySchedulers[i]->setRate(Telemetry::LOAD, LEG_LOAD_RATE_HZ);
+    }
+
+    headAndArmsScheduler.setRate(Telemetry::POSITION, ARM_POSITION_RATE_HZ);
+
+    for(uint8_t i = 0; i < NUM_CHAINS; ++i){
+        telemetrySchedulers[i]->setRate(Telemetry::TEMPERATURE, HEALTH_RATE_HZ);
+        telemetrySchedulers[i]->setRate(Telemetry::VOLTAGE, HEALTH_RATE_HZ);
+    }
+}
+
+void initCycleCounter(){
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void initWakeupTimers(){
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    __HAL_RCC_TIM5_CLK_ENABLE();
+
+    // The APB1 timers are clocked at twice PCLK1, unless it is undivided
+    uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+    if((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1){
+        timerClock *= 2;
+    }
+
+    // Both are 32-bit timers, so they count freely for over an hour before
+    // wrapping around, which the one-shots cope with
+    htim2.Instance = TIM2;
+    htim5.Instance = TIM5;
+    TIM_HandleTypeDef* const timers[] = {&htim2, &htim5};
+    for(TIM_HandleTypeDef* htim : timers){
+        htim->Init.Prescaler = timerClock / WAKEUP_TIMER_RATE_HZ - 1;
+        htim->Init.CounterMode = TIM_COUNTERMODE_UP;
+        htim->Init.Period = 0xFFFFFFFF;
+        htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+        HAL_TIM_OC_Init(htim);
+    }
+
+    // The channels only raise their compare interrupts
+    TIM_OC_InitTypeDef sConfigOC = {0};
+    sConfigOC.OCMode = TIM_OCMODE_TIMING;
+    sConfigOC.Pulse = 0;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_1);
+    HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_2);
+    HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_3);
+    HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_4);
+    HAL_TIM_OC_ConfigChannel(&htim5, &sConfigOC, TIM_CHANNEL_1);
+
+    HAL_NVIC_SetPriority(TIM2_IRQn, WAKEUP_TIMER_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+    HAL_NVIC_SetPriority(TIM5_IRQn, WAKEUP_TIMER_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+
+    HAL_TIM_Base_Start(&htim2);
+    HAL_TIM_Base_Start(&htim5);
+
+    // Keep in sync with getWakeupTimerUart
+    upperLeftLegDriver.setWakeupTimer(&timerif, &htim2, TIM_CHANNEL_1);
+    lowerRightLegDriver.setWakeupTimer(&timerif, &htim2, TIM_CHANNEL_2);
+    headAndArmsDriver.setWakeupTimer(&timerif, &htim2, TIM_CHANNEL_3);
+    upperRightLegDriver.setWakeupTimer(&timerif, &htim2, TIM_CHANNEL_4);
+    lowerLeftLegDriver.setWakeupTimer(&timerif, &htim5, TIM_CHANNEL_1);
+}
+
+const UART_HandleTypeDef* getWakeupTimerUart(const TIM_HandleTypeDef* htim){
+    if(htim == &htim5){
+        return (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1) ?
+               UART_HANDLE_LowerLeftLeg : nullptr;
+    }
+
+    if(htim != &htim2){
+        return nullptr;
+    }
+
+    switch(htim->Channel){
+        case HAL_TIM_ACTIVE_CHANNEL_1:
+            return UART_HANDLE_UpperLeftLeg;
+        case HAL_TIM_ACTIVE_CHANNEL_2:
+            return UART_HANDLE_LowerRightLeg;
+        case HAL_TIM_ACTIVE_CHANNEL_3:
+            return UART_HANDLE_HeadAndArms;
+        case HAL_TIM_ACTIVE_CHANNEL_4:
+            return UART_HANDLE_UpperRightLeg;
+        default:
+            return nullptr;
+    }
+}
+
 } // end namespace periph
 
 
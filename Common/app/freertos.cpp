@@ -65,6 +65,7 @@
  */
 
 #include <math.h>
+#include <string.h>
 
 #include "uart_handler.h"
 #include "Notification.h"
@@ -79,6 +80,8 @@
 #include "HalUartInterface.h"
 #include "OsInterfaceImpl.h"
 #include "CircularDmaBuffer.h"
+#include "GoalFrameParser.h"
+#include "TrajectoryBuffer.h"
 /* USER CODE END Includes */
 
 /* Variables -----------------------------------------------------------------*/
@@ -86,19 +89,19 @@ osThreadId defaultTaskHandle;
 uint32_t defaultTaskBuffer[ 128 ];
 osStaticThreadDef_t defaultTaskControlBlock;
 osThreadId UpperLeftLegHandle;
-uint32_t UpperLeftLegBuffer[ 128 ];
+uint32_t UpperLeftLegBuffer[ 512 ];
 osStaticThreadDef_t UpperLeftLegControlBlock;
 osThreadId LowerRightLegHandle;
-uint32_t LowerRightLegBuffer[ 128 ];
+uint32_t LowerRightLegBuffer[ 512 ];
 osStaticThreadDef_t LowerRightLegControlBlock;
 osThreadId HeadAndArmsHandle;
-uint32_t HeadAndArmsBuffer[ 128 ];
+uint32_t HeadAndArmsBuffer[ 512 ];
 osStaticThreadDef_t HeadAndArmsControlBlock;
 osThreadId UpperRightLegHandle;
-uint32_t UpperRightLegBuffer[ 128 ];
+uint32_t UpperRightLegBuffer[ 512 ];
 osStaticThreadDef_t UpperRightLegControlBlock;
 osThreadId LowerLeftLegHandle;
-uint32_t LowerLeftLegBuffer[ 128 ];
+uint32_t LowerLeftLegBuffer[ 512 ];
 osStaticThreadDef_t LowerLeftLegControlBlock;
 osThreadId IMUTaskHandle;
 uint32_t IMUTaskBuffer[ 128 ];
@@ -142,8 +145,19 @@ osMutexId DATABUFFERHandle;
 osStaticMutexDef_t DATABUFFERControlBlock;
 
 /* USER CODE BEGIN Variables */
+SemaphoreHandle_t StagedGoalsHandle;
+StaticSemaphore_t StagedGoalsControlBlock;
+SemaphoreHandle_t ChainsReadyHandle;
+StaticSemaphore_t ChainsReadyControlBlock;
 
-constexpr size_t RX_BUFF_SIZE = 92;
+/** @brief Size of a RobotGoal frame from the PC */
+constexpr size_t RX_FRAME_SIZE = comm::FRAME_SIZE;
+
+/**
+ * @brief Size of the PC reception buffer. Several messages fit, so that RxTask
+ *        being late to run does not lose any
+ */
+constexpr size_t RX_BUFF_SIZE = 4 * RX_FRAME_SIZE;
 
 namespace{
 
@@ -153,6 +167,9 @@ buffer::BufferMaster BufferMaster;
 os::OsInterfaceImpl osInterfaceImpl;
 uart::HalUartInterface uartInterface;
 uart::UartDriver uartDriver(&osInterfaceImpl, &uartInterface, UART_HANDLE_PC);
+uint8_t rxRaw[RX_BUFF_SIZE];
+uart::CircularDmaBuffer rxBuffer(UART_HANDLE_PC, &uartInterface, RX_FRAME_SIZE,
+        RX_BUFF_SIZE, rxRaw, true);
 
 bool setupIsDone = false;
 static volatile uint32_t error;
@@ -162,6 +179,56 @@ static volatile uint32_t error;
  * message size of 92 bytes is 4ms. Give an extra millisecond to allow for any
  * scheduling delays, so this is set to 5ms. */
 constexpr TickType_t TX_CYCLE_TIME_MS = 5;
+
+#if defined(USE_GOAL_TRAJECTORIES)
+/* Set the period at which CommandTask samples the goal trajectory and sends
+ * the result to the motors while it is moving. This is the rate the PC's
+ * setpoints are interpolated to, and leaves the chains time to stage and
+ * trigger each command (or to sync write it) before the next one. */
+constexpr TickType_t TRAJECTORY_CYCLE_TIME_MS = 10;
+#endif
+
+/**
+ * @brief Returns the command queue serviced by the thread that owns a daisy
+ *        chain
+ * @param chain The daisy chain, indexed the same way as periph::motorGroups
+ * @return The queue handle
+ */
+osMessageQId getChainQueue(uint8_t chain){
+    switch(chain){
+        case periph::LOWER_RIGHT_LEG:
+            return LowerRightLeg_reqHandle;
+        case periph::UPPER_RIGHT_LEG:
+            return UpperRightLeg_reqHandle;
+        case periph::UPPER_LEFT_LEG:
+            return UpperLeftLeg_reqHandle;
+        case periph::LOWER_LEFT_LEG:
+            return LowerLeftLeg_reqHandle;
+        case periph::HEAD_AND_ARMS:
+        default:
+            return HeadAndArms_reqHandle;
+    }
+}
+
+#if defined(USE_GOAL_TRAJECTORIES)
+/**
+ * @brief Limits a joint angle taken from the goal trajectory to the range the
+ *        motors accept. An angle out of range would get the motor group to
+ *        reject its whole chain's goals, so the joint stops at the limit
+ *        instead
+ * @param angle The joint angle, in degrees
+ * @return The angle, within [MIN_ANGLE, MAX_ANGLE]
+ */
+float limitJointAngle(float angle){
+    if(angle < dynamixel::MIN_ANGLE){
+        return dynamixel::MIN_ANGLE;
+    }
+    if(angle > dynamixel::MAX_ANGLE){
+        return dynamixel::MAX_ANGLE;
+    }
+    return angle;
+}
+#endif
 }
 
 /* USER CODE END Variables */
@@ -239,6 +306,11 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_SEMAPHORES */
   /* add semaphores, ... */
+  /* definition and creation of StagedGoals */
+  StagedGoalsHandle = xSemaphoreCreateCountingStatic(periph::NUM_CHAINS, 0, &StagedGoalsControlBlock);
+
+  /* definition and creation of ChainsReady (bring-up and tuning per chain) */
+  ChainsReadyHandle = xSemaphoreCreateCountingStatic(2 * periph::NUM_CHAINS, 0, &ChainsReadyControlBlock);
   /* USER CODE END RTOS_SEMAPHORES */
 
   /* USER CODE BEGIN RTOS_TIMERS */
@@ -251,23 +323,23 @@ void MX_FREERTOS_Init(void) {
   defaultTaskHandle = osThreadCreate(osThread(defaultTask), NULL);
 
   /* definition and creation of UpperLeftLeg */
-  osThreadStaticDef(UpperLeftLeg, StartUpperLeftLeg, osPriorityBelowNormal, 0, 128, UpperLeftLegBuffer, &UpperLeftLegControlBlock);
+  osThreadStaticDef(UpperLeftLeg, StartUpperLeftLeg, osPriorityBelowNormal, 0, 512, UpperLeftLegBuffer, &UpperLeftLegControlBlock);
   UpperLeftLegHandle = osThreadCreate(osThread(UpperLeftLeg), NULL);
 
   /* definition and creation of LowerRightLeg */
-  osThreadStaticDef(LowerRightLeg, StartLowerRightLeg, osPriorityBelowNormal, 0, 128, LowerRightLegBuffer, &LowerRightLegControlBlock);
+  osThreadStaticDef(LowerRightLeg, StartLowerRightLeg, osPriorityBelowNormal, 0, 512, LowerRightLegBuffer, &LowerRightLegControlBlock);
   LowerRightLegHandle = osThreadCreate(osThread(LowerRightLeg), NULL);
 
   /* definition and creation of HeadAndArms */
-  osThreadStaticDef(HeadAndArms, StartHeadAndArms, osPriorityBelowNormal, 0, 128, HeadAndArmsBuffer, &HeadAndArmsControlBlock);
+  osThreadStaticDef(HeadAndArms, StartHeadAndArms, osPriorityBelowNormal, 0, 512, HeadAndArmsBuffer, &HeadAndArmsControlBlock);
   HeadAndArmsHandle = osThreadCreate(osThread(HeadAndArms), NULL);
 
   /* definition and creation of UpperRightLeg */
-  osThreadStaticDef(UpperRightLeg, StartUpperRightLeg, osPriorityBelowNormal, 0, 128, UpperRightLegBuffer, &UpperRightLegControlBlock);
+  osThreadStaticDef(UpperRightLeg, StartUpperRightLeg, osPriorityBelowNormal, 0, 512, UpperRightLegBuffer, &UpperRightLegControlBlock);
   UpperRightLegHandle = osThreadCreate(osThread(UpperRightLeg), NULL);
 
   /* definition and creation of LowerLeftLeg */
-  osThreadStaticDef(LowerLeftLeg, StartLowerLeftLeg, osPriorityBelowNormal, 0, 128, LowerLeftLegBuffer, &LowerLeftLegControlBlock);
+  osThreadStaticDef(LowerLeftLeg, StartLowerLeftLeg, osPriorityBelowNormal, 0, 512, LowerLeftLegBuffer, &LowerLeftLegControlBlock);
   LowerLeftLegHandle = osThreadCreate(osThread(LowerLeftLeg), NULL);
 
   /* definition and creation of IMUTask */
@@ -363,43 +435,78 @@ void StartDefaultTask(void const * argument)
   */
 void StartCommandTask(void const * argument)
 {
-    // Wait for the motors to turn on
-    osDelay(osKernelSysTickMicroSec(100000));
-
     uartDriver.setIOType(uart::IO_Type::DMA);
     uartDriver.setMaxBlockTime(pdMS_TO_TICKS(TX_CYCLE_TIME_MS));
 
-    // Use polled IO here for 2 reasons:
-    //   1. Have to initialize the motors from this one thread, so using DMA
-    //      doesn't gain us anything
-    //   2. The UART callbacks are hardcoded to wake up their corresponding
-    //      UART threads used later in the flow
+    periph::initCycleCounter();
+    periph::initWakeupTimers();
+    periph::initMotorDirectionControl();
+
+#if defined(USE_BAUD_RATE_NEGOTIATION)
+    // This comes first since the motors may still be at the rate negotiated
+    // on a previous boot, in which case nothing else would reach them. Polled
+    // IO is used since the UART callbacks are hardcoded to wake up the UART
+    // threads. The motors may still be booting, so negotiation is retried
+    // until they answer. A chain on which it keeps failing keeps the last
+    // rate that worked
+    constexpr uint8_t NEGOTIATION_ATTEMPTS = 10;
     periph::initMotorIOType(IO_Type::POLL);
+    for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+        for(uint8_t attempt = 0; attempt < NEGOTIATION_ATTEMPTS; ++attempt){
+            if(periph::motorGroups[i]->negotiateBaudRate()){
+                break;
+            }
+        }
+    }
+#endif
 
-    // The return delay time is the time the motor waits before sending back
-    // data for a read request. We found that a value of 100 us worked reliably
-    // while values lower than this would cause packets to be dropped more
-    // frequently
-    constexpr uint16_t RETURN_DELAY_TIME = 100;
+    // Goals equal to the last ones sent are skipped, but are re-sent after
+    // this many cycles in a row (1 s at TX_CYCLE_TIME_MS) in case a write was
+    // lost on the bus
+    constexpr uint16_t SHADOW_REFRESH_PERIOD = 200;
     for(uint8_t i = periph::MOTOR1; i <= periph::MOTOR18; ++i) {
-        // Configure motor to return status packets only for read commands
-        periph::motors[i]->setStatusReturnLevel(
-            dynamixel::StatusReturnLevel::READS_ONLY
-        );
+        periph::motors[i]->setShadowRefreshPeriod(SHADOW_REFRESH_PERIOD);
+    }
 
-        periph::motors[i]->setReturnDelayTime(RETURN_DELAY_TIME);
-        periph::motors[i]->enableTorque(true);
+    // All other communication with the motors occurs in the UART threads, so
+    // we can use DMA now
+    periph::initMotorIOType(IO_Type::DMA);
 
-        if(i >= periph::MOTOR13){
-            // AX12A-only config for controls
-            static_cast<dynamixel::AX12A*>(periph::motors[i])->setComplianceSlope(5);
-            static_cast<dynamixel::AX12A*>(periph::motors[i])->setComplianceMargin(1);
-        }
+#if defined(USE_STREAMING_RECEPTION)
+    periph::initMotorStreaming();
+#endif
+
+    // Queue the bring-up so that it is the first thing the UART threads do
+    // once they are unblocked below. Each thread waits for the motors on its
+    // chain to boot and configures them, so all the chains are brought up at
+    // the same time
+    UARTcmd_t bringUpCmd;
+    bringUpCmd.type = cmdBringUp;
+    for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+        bringUpCmd.value = i;
+        bringUpCmd.qHandle = getChainQueue(i);
+
+        xQueueSend(bringUpCmd.qHandle, &bringUpCmd, 0);
     }
- 
-    // The only other communication with the motors will occur in the UART
-    // threads, so we can use DMA now.
-    periph::initMotorIOType(IO_Type::DMA);
+
+#if defined(USE_RETURN_DELAY_TUNING)
+    // Queue the tuning right after the bring-up. The results are left in
+    // periph::returnDelayTuners for inspection with the debugger
+    UARTcmd_t tuneCmd;
+    tuneCmd.type = cmdTuneReturnDelay;
+    tuneCmd.value = 1;
+    for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+        tuneCmd.groupHandle = periph::motorGroups[i];
+        tuneCmd.tunerHandle = periph::returnDelayTuners[i];
+        tuneCmd.qHandle = getChainQueue(i);
+
+        xQueueSend(tuneCmd.qHandle, &tuneCmd, 0);
+    }
+#endif
+
+#if defined(USE_TELEMETRY_SCHEDULER)
+    periph::initTelemetrySchedules();
+#endif
 
     // Configure the IMU to use the tightest filter bandwidth
     constexpr uint8_t IMU_DIGITAL_LOWPASS_FILTER_SETTING = 6;
@@ -422,46 +529,161 @@ void StartCommandTask(void const * argument)
     osSignalSet(UpperRightLegHandle, NOTIFIED_FROM_TASK);
     osSignalSet(LowerLeftLegHandle, NOTIFIED_FROM_TASK);
 
-    UARTcmd_t cmd;
-    cmd.type = cmdWritePosition;
-    float positions[18];
+    // Hold off the first control cycle until every chain is brought up (and
+    // tuned)
+    for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+        xSemaphoreTake(ChainsReadyHandle, portMAX_DELAY);
+#if defined(USE_RETURN_DELAY_TUNING)
+        xSemaphoreTake(ChainsReadyHandle, portMAX_DELAY);
+#endif
+    }
+
+    // The task's stack is only 128 words, so anything sizeable is kept off
+    // it. The trajectory alone takes up 1.6 kB
+    static UARTcmd_t cmd;
+    static float positions[periph::NUM_MOTORS] = {};
+#if defined(USE_GOAL_TRAJECTORIES)
+    static trajectory::TrajectoryBuffer goalTrajectory;
+    static float sampled[comm::NUM_GOAL_JOINTS];
+    static trajectory::Setpoint setpoint;
+    uint32_t nowMs = 0;
+
+    // Joints that have been sent a position, which the trajectory moves them
+    // on from
+    uint32_t commandedJoints = 0;
+    const uint32_t allJoints = (1u << comm::NUM_GOAL_JOINTS) - 1;
+#endif
     while(1){
+#if defined(USE_GOAL_TRAJECTORIES)
+        // While the trajectory is moving, wake up every cycle to sample it
+        // even if no goal arrives
+        osSignalWait(
+            NOTIFIED_FROM_TASK,
+            goalTrajectory.isMoving(nowMs) ? TRAJECTORY_CYCLE_TIME_MS : osWaitForever
+        );
+        nowMs = xTaskGetTickCount() * portTICK_PERIOD_MS;
+#else
         osSignalWait(NOTIFIED_FROM_TASK, osWaitForever);
+#endif
 
-        // Convert raw bytes from robotGoal received from PC into floats
-        uint8_t* ptr = NULL;
-        for(uint8_t i = 0; i < 18; i++){
-            ptr = (uint8_t*)&positions[i];
-            for(uint8_t j = 0; j < 4; j++){
-                *ptr = robotGoal.msg[i * 4 + j];
-                ptr++;
+        // Convert raw bytes from robotGoal received from PC into floats. Only
+        // the joints the goals carried are copied, so the others keep the
+        // positions last sent to them
+        uint32_t changedJoints = takeChangedJoints();
+        for(uint8_t i = 0; i < comm::NUM_GOAL_JOINTS; i++){
+            if(changedJoints & (1u << i)){
+                memcpy(&positions[i], &robotGoal.msg[i * sizeof(float)], sizeof(float));
             }
         }
 
-        // Send each goal position to the queue, where the UART handler
-        // thread that's listening will receive it and send it to the motor
-        for(uint8_t i = periph::MOTOR1; i < periph::NUM_MOTORS; ++i){
-            cmd.motorHandle = periph::motors[i];
-            cmd.value = positions[i];
+#if defined(USE_GOAL_TRAJECTORIES)
+        // A direct goal takes over from the trajectory, which stops where it
+        // is. Timed goals queued afterwards move on from there
+        if(changedJoints != 0){
+            goalTrajectory.hold(positions, nowMs);
+            commandedJoints |= changedJoints;
+        }
 
-            if(i <= periph::MOTOR3){
-                cmd.qHandle = LowerRightLeg_reqHandle;
+        while(takeSetpoint(setpoint)){
+            // The first setpoint is moved to over its duration from the
+            // positions last sent, like any other. Joints never sent one
+            // have nowhere known to move from, so they're sent straight to it
+            if(commandedJoints != allJoints){
+                for(uint8_t i = 0; i < comm::NUM_GOAL_JOINTS; i++){
+                    if(!(commandedJoints & (1u << i))){
+                        positions[i] = limitJointAngle(setpoint.angles[i]);
+                    }
+                }
+                changedJoints |= allJoints & ~commandedJoints;
+                commandedJoints = allJoints;
+                goalTrajectory.hold(positions, nowMs);
             }
-            else if(i <= periph::MOTOR6){
-                cmd.qHandle = UpperRightLeg_reqHandle;
+
+            goalTrajectory.push(setpoint, nowMs);
+        }
+
+        if(changedJoints == 0){
+            if(!goalTrajectory.sample(nowMs, sampled)){
+                continue;
+            }
+
+            for(uint8_t i = 0; i < comm::NUM_GOAL_JOINTS; i++){
+                sampled[i] = limitJointAngle(sampled[i]);
+                if(sampled[i] != positions[i]){
+                    positions[i] = sampled[i];
+                    changedJoints |= 1u << i;
+                }
+            }
+            if(changedJoints == 0){
+                continue;
+            }
+        }
+#endif
+
+#if defined(USE_SYNCHRONIZED_MOTION)
+        // Discard any staging acknowledgements that arrived after we stopped
+        // waiting for them last time
+        xQueueReset(StagedGoalsHandle);
+
+        cmd.type = cmdStageWritePosition;
+#else
+        cmd.type = cmdSyncWritePosition;
+#endif
+
+        // Send the goal positions for each daisy chain to its queue as a
+        // single command, where the UART handler thread that's listening will
+        // send them to all the motors on the chain. The positions are copied
+        // into the command, since a chain that falls behind may still be
+        // working through it when the next goal (or trajectory cycle)
+        // overwrites positions. Chains none of whose joints changed (e.g.
+        // after a sparse goal) are left alone
+        bool commandedChains[periph::NUM_CHAINS] = {};
+        size_t offset = 0;
+        for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+            cmd.groupHandle = periph::motorGroups[i];
+            cmd.qHandle = getChainQueue(i);
+
+            const size_t size = cmd.groupHandle->size();
+            const uint32_t chainJoints = ((1u << size) - 1) << offset;
+            if(changedJoints & chainJoints){
+                memcpy(cmd.values, &positions[offset], size * sizeof(float));
+                xQueueSend(cmd.qHandle, &cmd, 0);
+                commandedChains[i] = true;
             }
-            else if(i <= periph::MOTOR9){
-                cmd.qHandle = UpperLeftLeg_reqHandle;
+
+            offset += size;
+        }
+
+#if defined(USE_SYNCHRONIZED_MOTION)
+        // Wait for every commanded chain to register its goals. If a chain
+        // takes too long, trigger the others anyway rather than stall the
+        // whole robot
+        for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+            if(!commandedChains[i]){
+                continue;
             }
-            else if(i <= periph::MOTOR12){
-                cmd.qHandle = LowerLeftLeg_reqHandle;
+            if(xSemaphoreTake(StagedGoalsHandle, MAX_DELAY_TIME) != pdTRUE){
+                break;
             }
-            else{
-                cmd.qHandle = HeadAndArms_reqHandle;
+        }
+
+        // A chain whose goals are staged skips any reads queued in the
+        // meantime (@see MotorGroup::isActionPending), so it's idle by now,
+        // and its ACTION jumps ahead of those reads. This thread outranks the
+        // UART threads, so every ACTION is queued before any of them runs,
+        // and they go out back to back
+        cmd.type = cmdAction;
+        for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+            if(!commandedChains[i]){
+                continue;
             }
 
-            xQueueSend(cmd.qHandle, &cmd, 0);
+            cmd.groupHandle = periph::motorGroups[i];
+            cmd.qHandle = getChainQueue(i);
+
+            xQueueSendToFront(cmd.qHandle, &cmd, 0);
         }
+#endif
     }
 }
 
@@ -666,37 +888,37 @@ void StartRxTask(void const * argument) {
 
     initializeVars();
 
-    const uint32_t RX_CYCLE_TIME = osKernelSysTickMicroSec(1000);
-    uint32_t xLastWakeTime = osKernelSysTick();
+    // The DMA's half-transfer and transfer complete interrupts, the idle line
+    // interrupt at the end of each message and UART errors all wake this
+    // thread. The timeout is only a backstop for error recovery
+    const uint32_t RX_ERROR_CHECK_PERIOD_MS = 100;
 
     bool parse_out = 0;
-    uint8_t raw[RX_BUFF_SIZE];
-    uint8_t processingBuff[RX_BUFF_SIZE];
-    uart::CircularDmaBuffer rxBuffer = uart::CircularDmaBuffer(UART_HANDLE_PC,
-            &uartInterface, RX_BUFF_SIZE, RX_BUFF_SIZE, raw);
 
     rxBuffer.initiate();
 
     for (;;) {
-        osDelayUntil(&xLastWakeTime, RX_CYCLE_TIME);
+        osSignalWait(NOTIFIED_FROM_RX_ISR, RX_ERROR_CHECK_PERIOD_MS);
 
+        // Parsed in place, straight out of the DMA buffer. Several goals may
+        // have arrived since the last wakeup, so keep going until all the
+        // bytes are used up. The parser may still hold bytes back after a
+        // goal, so it gets another pass even if the DMA buffer is empty
         rxBuffer.updateHead();
-        if(rxBuffer.dataAvail()){
-            uint8_t numBytesReceived = rxBuffer.readBuff(processingBuff);
-
-            parseByteSequence(processingBuff, numBytesReceived, parse_out);
-        }
-
-        rxBuffer.reinitiateIfError();
-
-        if (parse_out) {
+        do {
+            const uart::ReadSpans spans = rxBuffer.peekSpans();
             parse_out = false;
+            rxBuffer.consume(
+                parseByteSequence(spans.first, spans.first_size, parse_out)
+            );
 
-            copyParsedData();
+            if (parse_out && copyParsedData()) {
+                osSignalSet(TxTaskHandle, NOTIFIED_FROM_TASK);
+                osSignalSet(CommandTaskHandle, NOTIFIED_FROM_TASK);
+            }
+        } while (parse_out || rxBuffer.dataAvail());
 
-            osSignalSet(TxTaskHandle, NOTIFIED_FROM_TASK);
-            osSignalSet(CommandTaskHandle, NOTIFIED_FROM_TASK);
-        }
+        rxBuffer.reinitiateIfError();
     }
 }
 
@@ -705,7 +927,7 @@ void StartRxTask(void const * argument) {
  *         thread. This thread is blocked until all sensor data
  *         has been received through the sensor queue. After this
  *         time, the UARTx_ and IMUTask will be blocked. Then, a
- *         DMA-based transmission of a RobotState is sent to the
+ *         DMA-based transmission of a state frame is sent to the
  *         PC via UART5.
  *
  *         This function never returns.
@@ -713,6 +935,8 @@ void StartRxTask(void const * argument) {
  * @ingroup Threads
  */
 void StartTxTask(void const * argument) {
+    // Holds each state frame until its transmission is done
+    static uint8_t txFrame[comm::STATE_FRAME_SIZE];
 
     // TxTask waits for first time setup complete.
     osSignalWait(0, osWaitForever);
@@ -722,10 +946,11 @@ void StartTxTask(void const * argument) {
         osSignalWait(0, osWaitForever);
 
         copySensorDataToSend(&BufferMaster);
+        const size_t txFrameSize = encodeStateFrame(txFrame);
 
         // TODO: should have a way to back out of a failed transmit and reinitiate
         // (e.g. timeout), number of attempts, ..., rather than infinitely loop.
-        while(!uartDriver.transmit((uint8_t*) &robotState, sizeof(RobotState))) {;}
+        while(!uartDriver.transmit(txFrame, txFrameSize)) {;}
     }
 }
 
@@ -760,8 +985,24 @@ void StartBuffWriterTask(void const * argument)
                 // Each type of buffer could have its own mutex but this will probably
                 // only improve efficiency if there are multiple writer/reader threads
                 // and BufferWrite queues.
-                if (motorDataPtr->id <= periph::NUM_MOTORS) {
-                    BufferMaster.MotorBufferArray[motorDataPtr->id - 1].write(*motorDataPtr);
+                if ((motorDataPtr->id == 0) || (motorDataPtr->id > periph::NUM_MOTORS)) {
+                    break;
+                }
+                switch (motorDataPtr->item) {
+                    case dynamixel::Telemetry::POSITION:
+                        BufferMaster.MotorBufferArray[motorDataPtr->id - 1].write(*motorDataPtr);
+                        break;
+                    case dynamixel::Telemetry::LOAD:
+                        BufferMaster.MotorLoadBufferArray[motorDataPtr->id - 1].write(*motorDataPtr);
+                        break;
+                    case dynamixel::Telemetry::TEMPERATURE:
+                        BufferMaster.MotorTemperatureBufferArray[motorDataPtr->id - 1].write(*motorDataPtr);
+                        break;
+                    case dynamixel::Telemetry::VOLTAGE:
+                        BufferMaster.MotorVoltageBufferArray[motorDataPtr->id - 1].write(*motorDataPtr);
+                        break;
+                    default:
+                        break;
                 }
                 break;
             case eIMUData:
@@ -793,37 +1034,36 @@ void StartMotorCmdGenTask(void const * argument){
 
     constexpr uint32_t CYCLE_TIME_MS = osKernelSysTickMicroSec(2000);
     TickType_t xLastWakeTime = osKernelSysTick();
+
     UARTcmd_t cmd;
-    cmd.type = cmdReadPosition;
+#if defined(USE_TELEMETRY_SCHEDULER)
+    cmd.type = cmdReadTelemetry;
+#else
+    cmd.type = cmdReadGroupPosition;
+#endif
 
     for(;;)
     {
         vTaskDelayUntil(&xLastWakeTime, CYCLE_TIME_MS);
 
-        for(uint8_t i = periph::MOTOR1; i < periph::NUM_MOTORS; ++i){
-            cmd.motorHandle = periph::motors[i];
+#if defined(USE_TELEMETRY_SCHEDULER)
+        // Every chain's scheduler decides what is due this cycle. The leg
+        // positions are due every cycle and still go out as one BULK_READ
+        for(uint8_t i = 0; i < periph::NUM_CHAINS; ++i){
+            cmd.schedulerHandle = periph::telemetrySchedulers[i];
+            cmd.qHandle = getChainQueue(i);
 
-            if(i <= periph::MOTOR3){
-                cmd.qHandle = LowerRightLeg_reqHandle;
-            }
-            else if(i <= periph::MOTOR6){
-                cmd.qHandle = UpperRightLeg_reqHandle;
-            }
-            else if(i <= periph::MOTOR9){
-                cmd.qHandle = UpperLeftLeg_reqHandle;
-            }
-            else if(i <= periph::MOTOR12){
-                cmd.qHandle = LowerLeftLeg_reqHandle;
-            }
-            else{
-                cmd.qHandle = HeadAndArms_reqHandle;
-            }
+            xQueueSend(cmd.qHandle, &cmd, 0);
+        }
+#else
+        // Only read from legs. Each leg chain is read with a single BULK_READ
+        for(uint8_t i = periph::LOWER_RIGHT_LEG; i <= periph::LOWER_LEFT_LEG; ++i){
+            cmd.groupHandle = periph::motorGroups[i];
+            cmd.qHandle = getChainQueue(i);
 
-            // Only read from legs
-            if(i <= periph::MOTOR12){
-                xQueueSend(cmd.qHandle, &cmd, 0);
-            }
+            xQueueSend(cmd.qHandle, &cmd, 0);
         }
+#endif
     }
 }
 
@@ -870,7 +1110,12 @@ void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
   * @ingroup Callbacks
   */
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart){
-    if(setupIsDone){
+    // Release the bus first, since the status packet may start arriving
+    // within microseconds. A thread that sent a request with transceive is
+    // woken up by the reception instead
+    const bool notify = periph::onMotorTransmitComplete(huart);
+
+    if(setupIsDone && notify){
         BaseType_t xHigherPriorityTaskWoken = pdFALSE;
         if(huart == UART_HANDLE_PC){
             xTaskNotifyFromISR(TxTaskHandle, NOTIFIED_FROM_TX_ISR, eSetBits, &xHigherPriorityTaskWoken);
@@ -909,6 +1154,23 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart){
   */
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef * huart) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if(huart == UART_HANDLE_PC){
+        if(huart->hdmarx->Init.Mode == DMA_CIRCULAR){
+            rxBuffer.onTransferComplete();
+        }
+        xTaskNotifyFromISR(RxTaskHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        return;
+    }
+
+    if(huart->hdmarx->Init.Mode == DMA_CIRCULAR){
+        // For a streaming reception from the motors, this only means the DMA
+        // wrapped around. The thread is still notified, so that it reads the
+        // stream before the DMA catches up to it. A thread waiting for a
+        // transmission instead goes back to waiting
+        periph::onMotorStreamWrapped(huart);
+    }
+
     if(huart == UART_HANDLE_UpperLeftLeg){
         xTaskNotifyFromISR(UpperLeftLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
     }
@@ -927,11 +1189,122 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef * huart) {
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
+/**
+  * @brief  This function is called when a DMA-based reception from a UART
+  *         module is half-way done. For this program, only the circular
+  *         receptions use it, to wake the thread reading them before the
+  *         DMA catches up to the data it has not read yet.
+  * @param  huart pointer to a UART_HandleTypeDef structure that contains
+  *         the configuration information for UART module corresponding to
+  *         the callback
+  * @return None
+  *
+  * @ingroup Callbacks
+  */
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart){
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if(huart == UART_HANDLE_PC){
+        xTaskNotifyFromISR(RxTaskHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_UpperLeftLeg){
+        xTaskNotifyFromISR(UpperLeftLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_LowerRightLeg){
+        xTaskNotifyFromISR(LowerRightLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_HeadAndArms){
+        xTaskNotifyFromISR(HeadAndArmsHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_UpperRightLeg){
+        xTaskNotifyFromISR(UpperRightLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_LowerLeftLeg){
+        xTaskNotifyFromISR(LowerLeftLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+  * @brief  This function is called whenever the line goes idle during a
+  *         reception started with UartDriver::receiveToIdle, i.e. once a
+  *         message of unknown length has ended, and after each message
+  *         from the PC or the motors on a streaming daisy chain. For this program, the callback behaviour is the
+  *         same as for a completed reception.
+  * @param  huart pointer to a UART_HandleTypeDef structure that contains
+  *         the configuration information for UART module corresponding to
+  *         the callback
+  * @param  Size number of bytes received so far
+  * @return None
+  *
+  * @ingroup Callbacks
+  */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size){
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if(huart == UART_HANDLE_PC){
+        xTaskNotifyFromISR(RxTaskHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_UpperLeftLeg){
+        xTaskNotifyFromISR(UpperLeftLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_LowerRightLeg){
+        xTaskNotifyFromISR(LowerRightLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_HeadAndArms){
+        xTaskNotifyFromISR(HeadAndArmsHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_UpperRightLeg){
+        xTaskNotifyFromISR(UpperRightLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_LowerLeftLeg){
+        xTaskNotifyFromISR(LowerLeftLegHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+  * @brief  This function is called whenever a compare of a timer channel in
+  *         output compare mode matches. For this program, the callback
+  *         behaviour consists of waking up the motor UART thread whose
+  *         microsecond timeout the channel was timing, the same way its
+  *         UART's interrupts do.
+  * @param  htim pointer to a TIM_HandleTypeDef structure that contains
+  *         the configuration information for the timer, and the channel
+  *         that matched
+  * @return None
+  *
+  * @ingroup Callbacks
+  */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef* htim){
+    const UART_HandleTypeDef* huart = periph::getWakeupTimerUart(htim);
+    if(huart == nullptr){
+        return;
+    }
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if(huart == UART_HANDLE_UpperLeftLeg){
+        xTaskNotifyFromISR(UpperLeftLegHandle, NOTIFIED_FROM_TIMER_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_LowerRightLeg){
+        xTaskNotifyFromISR(LowerRightLegHandle, NOTIFIED_FROM_TIMER_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_HeadAndArms){
+        xTaskNotifyFromISR(HeadAndArmsHandle, NOTIFIED_FROM_TIMER_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_UpperRightLeg){
+        xTaskNotifyFromISR(UpperRightLegHandle, NOTIFIED_FROM_TIMER_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    else if(huart == UART_HANDLE_LowerLeftLeg){
+        xTaskNotifyFromISR(LowerLeftLegHandle, NOTIFIED_FROM_TIMER_ISR, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
 /**
   * @brief  This function is called whenever an error is encountered in
   *         association with a UART module. For this program, the callback
   *         behaviour consists of storing the error code in a local
-  *         variable.
+  *         variable, and waking RxTask if the PC's reception failed so it
+  *         can restart it.
   * @param  huart pointer to a UART_HandleTypeDef structure that contains
   *         the configuration information for UART module corresponding to
   *         the callback
@@ -942,6 +1315,12 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef * huart) {
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
     error = HAL_UART_GetError(huart);
+
+    if(huart == UART_HANDLE_PC){
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        xTaskNotifyFromISR(RxTaskHandle, NOTIFIED_FROM_RX_ISR, eSetBits, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
 }
 
 /* USER CODE END Application */
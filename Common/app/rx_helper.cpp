@@ -13,16 +13,60 @@
 
 /********************************* Includes **********************************/
 #include "rx_helper.h"
+#include "SystemConf.h"
 #include "Notification.h"
 #include "cmsis_os.h"
 #include "robotGoal.h"
 #include "robotState.h"
 #include "Communication.h"
 #include "usart.h"
+#include "GoalFrameParser.h"
+#include "StaticSpscRing.h"
+#include <atomic>
+
+static_assert(
+    trajectory::NUM_JOINTS == comm::NUM_GOAL_JOINTS,
+    "Setpoints must carry every goal joint"
+);
 
 /***************************** Private Variables *****************************/
-static uint8_t robotGoalData[sizeof(RobotGoal)];
-static uint8_t *robotGoalDataPtr;
+#ifdef CRC
+/**
+ * @brief   Computes the CRC of a payload with the CRC unit, which is left in
+ *          its reset configuration. @see comm::Crc32Function
+ */
+static uint32_t crc32Hardware(const uint8_t *data, size_t numBytes) {
+    const uint32_t *words = reinterpret_cast<const uint32_t*>(data);
+
+    CRC->CR = CRC_CR_RESET;
+    for (size_t i = 0; i < numBytes / 4; i++) {
+        CRC->DR = words[i];
+    }
+    return CRC->DR;
+}
+
+static comm::GoalFrameParser parser(crc32Hardware);
+#else
+static comm::GoalFrameParser parser;
+#endif
+
+/**
+ * @brief   Joints whose goals have been received but not yet taken by
+ *          CommandTask. @see takeChangedJoints
+ */
+static std::atomic<uint32_t> changedJoints(0);
+
+/**
+ * @brief   Whether a full goal has been received. Sparse goals are dropped
+ *          until then, since the other joints' goals would be made up
+ */
+static bool haveFullGoal = false;
+
+/**
+ * @brief   Timed goals received but not yet taken by CommandTask, which owns
+ *          the trajectory they are queued in. @see takeSetpoint
+ */
+static buffer::StaticSpscRing<trajectory::Setpoint, trajectory::TRAJECTORY_CAPACITY> setpoints;
 
 /********************************  Functions  ********************************/
 /*****************************************************************************/
@@ -53,69 +97,104 @@ static uint8_t *robotGoalDataPtr;
  * @return  None
  */
 void initializeVars(void) {
+#ifdef CRC
+    __HAL_RCC_CRC_CLK_ENABLE();
+#endif
     //sending
     robotGoal.id = 0;
-    robotGoalDataPtr = robotGoalData;
+    parser.reset();
+    changedJoints = 0;
+    haveFullGoal = false;
     //receiving
     robotState.id = 0;
     robotState.start_seq = UINT32_MAX;
     robotState.end_seq = 0;
 }
 
-// TODO: refactor this after researching more standard parsing techniques.
-static RxParseState readByte(const uint8_t byte_in, bool& complete_out) {
-    constexpr size_t SIZE_START_SEQ = 4;
-    constexpr size_t SIZE_DATA = sizeof(RobotGoal);
-    static RxParseState state = RxParseState::CHECKING_HEADER;
-    static size_t startSeqCount = 0;
-    static size_t dataBytesRead = 0;
-    RxParseState prevState = state;
-
-    switch(byte_in) {
-    case 0xFF:
-        if (state == RxParseState::CHECKING_HEADER) {
-            startSeqCount++;
-        }
-        if (state == RxParseState::READING_DATA) {
-            dataBytesRead++;
-        }
-        break;
-    default:
-        if (state == RxParseState::READING_DATA) {
-            dataBytesRead++;
+/**
+ * @brief   Parses received bytes, stopping early once a goal frame with a
+ *          valid CRC is complete. @see comm::GoalFrameParser
+ * @param   in_buff The received bytes
+ * @param   in_buff_size The number of received bytes
+ * @param   complete Set to true once a goal frame is complete
+ * @return  The number of bytes parsed. Those after a complete goal frame are
+ *          left for the next call
+ */
+size_t parseByteSequence(const uint8_t *in_buff, size_t in_buff_size, bool& complete) {
+    return parser.parse(in_buff, in_buff_size, complete);
+}
+
+/**
+ * @brief   Decodes the goal of the last complete frame into robotGoal, with
+ *          the joint angles as floats in robotGoal.msg. A sparse goal only
+ *          updates the joints it carries. A timed goal is queued for
+ *          CommandTask instead, and leaves robotGoal.msg alone
+ * @return  false if the goal could not be decoded, or is sparse and no full
+ *          goal has been received yet, or is timed and the queue is full, in
+ *          which case robotGoal is left alone, otherwise true.
+ *          @see comm::decodeGoal
+ */
+bool copyParsedData(void) {
+    uint16_t id = 0;
+    uint32_t jointMask = 0;
+    float angles[comm::NUM_GOAL_JOINTS];
+
+#if defined(USE_GOAL_TRAJECTORIES)
+    uint16_t durationMs = 0;
+    uint8_t flags = 0;
+    trajectory::Setpoint setpoint;
+    if (comm::decodeTimedGoal(parser.getGoal(), parser.getGoalSize(), id, durationMs, flags, setpoint.angles)) {
+        setpoint.durationMs = durationMs;
+        setpoint.replace = (flags & comm::TIMED_GOAL_REPLACE) != 0;
+        if (!setpoints.push(setpoint)) {
+            return false;
         }
-        break;
-    }
 
-    if (state == RxParseState::CHECKING_HEADER && startSeqCount == SIZE_START_SEQ) {
-        state = RxParseState::READING_DATA;
+        // Every joint is set, so sparse goals may follow
+        haveFullGoal = true;
+        robotState.id = robotGoal.id;
+        robotGoal.id = id;
+        return true;
     }
-    else if (state == RxParseState::READING_DATA && dataBytesRead == SIZE_DATA) {
-        complete_out = true;
-        state = RxParseState::CHECKING_HEADER;
-        startSeqCount = 0;
-        dataBytesRead = 0;
+#endif
+
+    if (!comm::decodeGoal(parser.getGoal(), parser.getGoalSize(), id, jointMask, angles)) {
+        return false;
     }
 
-    return prevState;
-}
+    if (jointMask == comm::ALL_GOAL_JOINTS) {
+        haveFullGoal = true;
+    }
+    else if (!haveFullGoal) {
+        return false;
+    }
 
-void parseByteSequence(uint8_t *in_buff, size_t in_buff_size, bool& complete) {
-    for (size_t i = 0; i < in_buff_size; i++) {
-        if (readByte(in_buff[i], complete) == RxParseState::READING_DATA) {
-            *(robotGoalDataPtr++) = in_buff[i];
-        }
-        if (complete) {
-            // Reset the variables to help with reception of a RobotGoal
-            robotGoalDataPtr = robotGoalData;
-            break;
+    robotState.id = robotGoal.id;
+    robotGoal.id = id;
+    for (uint8_t i = 0; i < comm::NUM_GOAL_JOINTS; i++) {
+        if (jointMask & (1u << i)) {
+            memcpy(&robotGoal.msg[i * sizeof(float)], &angles[i], sizeof(float));
         }
     }
+    changedJoints |= jointMask;
+    return true;
 }
 
-void copyParsedData(void) {
-    robotState.id = robotGoal.id;
-    memcpy(&robotGoal, robotGoalData, sizeof(RobotGoal));
+/**
+ * @brief   Returns the joints whose goals have changed since the last call,
+ *          bit i set for joint i
+ */
+uint32_t takeChangedJoints(void) {
+    return changedJoints.exchange(0);
+}
+
+/**
+ * @brief   Takes the oldest timed goal not yet taken, in the order received
+ * @param   setpoint Set to the timed goal, if there is one
+ * @return  false if there are none, otherwise true
+ */
+bool takeSetpoint(trajectory::Setpoint& setpoint) {
+    return setpoints.pop(setpoint);
 }
 
 /**
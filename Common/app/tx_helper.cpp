@@ -16,6 +16,8 @@
 #include "MPU6050.h"
 #include "Notification.h"
 #include "BufferBase.h"
+#include "GoalFrameParser.h"
+#include <math.h>
 
 /***************************** Private Variables *****************************/
 static MotorData_t readMotorData;
@@ -25,6 +27,10 @@ static char* const pIMUXGyroData = &robotState.msg[
     ROBOT_STATE_MPU_DATA_OFFSET
 ];
 
+// robotState.msg has no room left, so these are kept beside it
+static float jointLoads[comm::NUM_STATE_JOINTS];
+static float motorHealth[comm::NUM_STATE_HEALTH];
+
 /******************************** Functions **********************************/
 /*  StartTxTask Helper Functions                                             */
 /*                                                                           */
@@ -61,7 +67,63 @@ void copySensorDataToSend(buffer::BufferMaster* BufferMasterPtr) {
                &readMotorData.payload,
                sizeof(float)
         );
+
+        jointLoads[i] = BufferMasterPtr->MotorLoadBufferArray[i].read().payload;
+    }
+
+    // The hottest and lowest readings of every motor that has answered. A
+    // buffer that was never written holds ID 0
+    float hottest = 0.0f;
+    float lowest = 0.0f;
+    for(int i = 0; i < periph::NUM_MOTORS; ++i)
+    {
+        readMotorData = BufferMasterPtr->MotorTemperatureBufferArray[i].read();
+        if((readMotorData.id != 0) && !isnan(readMotorData.payload) &&
+           (readMotorData.payload > hottest))
+        {
+            hottest = readMotorData.payload;
+        }
+
+        readMotorData = BufferMasterPtr->MotorVoltageBufferArray[i].read();
+        if((readMotorData.id != 0) && !isnan(readMotorData.payload) &&
+           ((lowest == 0.0f) || (readMotorData.payload < lowest)))
+        {
+            lowest = readMotorData.payload;
+        }
     }
+    motorHealth[comm::STATE_HEALTH_TEMPERATURE] = hottest;
+    motorHealth[comm::STATE_HEALTH_VOLTAGE] = lowest;
+}
+
+/**
+ * @brief   Encodes robotState, the joint loads and the motor health into a
+ *          frame for the PC. @see comm::encodeState
+ * @details The CRC is computed in software, since the CRC unit belongs to
+ *          RxTask, which may preempt this task
+ * @param   out The frame, comm::STATE_FRAME_SIZE bytes
+ * @return  The size of the frame
+ */
+size_t encodeStateFrame(uint8_t* out) {
+    float angles[comm::NUM_STATE_JOINTS];
+    float imu[comm::NUM_STATE_IMU];
+    memcpy(angles, robotState.msg, sizeof(angles));
+    memcpy(imu, pIMUXGyroData, sizeof(imu));
+
+    uint32_t message[comm::STATE_MESSAGE_SIZE / 4];
+    comm::encodeState(
+        static_cast<uint16_t>(robotState.id),
+        angles,
+        imu,
+        jointLoads,
+        motorHealth,
+        reinterpret_cast<uint8_t*>(message)
+    );
+
+    return comm::writeFrame(
+        reinterpret_cast<const uint8_t*>(message),
+        sizeof(message),
+        out
+    );
 }
 
 /*****************************************************************************/
@@ -16,6 +16,7 @@
 
 /********************************* Includes **********************************/
 #include "uart_handler.h"
+#include "PeripheralInstances.h"
 #include <math.h>
 
 
@@ -28,6 +29,20 @@
  */
 extern osMessageQId BufferWriteQueueHandle;
 
+/**
+ * Counts the daisy chains whose goal positions have been staged. This module
+ * gives it once per cmdStageWritePosition processed, and the command thread
+ * takes it before broadcasting ACTION
+ */
+extern SemaphoreHandle_t StagedGoalsHandle;
+
+/**
+ * Counts the boot steps completed by the daisy chains. This module gives it
+ * once per cmdBringUp and cmdTuneReturnDelay processed, and the command thread
+ * waits on it before its first control cycle
+ */
+extern SemaphoreHandle_t ChainsReadyHandle;
+
 
 
 
@@ -49,6 +64,13 @@ void UART_ProcessEvent(UARTcmd_t* cmdPtr){
     dataToSend.eDataType = eMotorData;
     dataToSend.pData = &data;
 
+    float groupPos[dynamixel::MAX_GROUP_SIZE];
+    bool groupPosValid[dynamixel::MAX_GROUP_SIZE];
+    size_t groupSize;
+
+    dynamixel::TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    size_t numReads;
+
     switch(cmdPtr->type){
         case cmdReadPosition:
             success = cmdPtr->motorHandle->getPosition(pos);
@@ -57,6 +79,7 @@ void UART_ProcessEvent(UARTcmd_t* cmdPtr){
             data.payload = success ? pos : NAN;
             data.id = cmdPtr->motorHandle->id();
             data.type = MotorData_t::T_FLOAT;
+            data.item = dynamixel::Telemetry::POSITION;
 
             xQueueSend(BufferWriteQueueHandle, &dataToSend, 0);
             break;
@@ -66,6 +89,85 @@ void UART_ProcessEvent(UARTcmd_t* cmdPtr){
         case cmdWriteTorque:
             cmdPtr->motorHandle->enableTorque(cmdPtr->value);
             break;
+        case cmdSyncWritePosition:
+            cmdPtr->groupHandle->setGoalPositions(
+                cmdPtr->values,
+                cmdPtr->groupHandle->size()
+            );
+            break;
+        case cmdReadGroupPosition:
+            // The chain's goals are staged and its ACTION is on the way. A
+            // read started now would hold up the ACTION, so this one is
+            // skipped and the next cycle reads the chain instead
+            if(cmdPtr->groupHandle->isActionPending()){
+                break;
+            }
+
+            groupSize = cmdPtr->groupHandle->size();
+            cmdPtr->groupHandle->getPositions(
+                groupPos,
+                groupPosValid,
+                groupSize
+            );
+
+            // The sensor queue is read by a higher-priority thread, so data
+            // is consumed before the next iteration overwrites it
+            for(size_t i = 0; i < groupSize; ++i){
+                // issue #130: send NAN upon read failure
+                data.payload = groupPosValid[i] ? groupPos[i] : NAN;
+                data.id = cmdPtr->groupHandle->motor(i)->id();
+                data.type = MotorData_t::T_FLOAT;
+                data.item = dynamixel::Telemetry::POSITION;
+
+                xQueueSend(BufferWriteQueueHandle, &dataToSend, 0);
+            }
+            break;
+        case cmdStageWritePosition:
+            cmdPtr->groupHandle->stageGoalPositions(
+                cmdPtr->values,
+                cmdPtr->groupHandle->size()
+            );
+
+            // Give even upon failure so that the command thread doesn't hold
+            // up the other chains waiting for this one
+            xSemaphoreGive(StagedGoalsHandle);
+            break;
+        case cmdAction:
+            cmdPtr->groupHandle->action();
+            break;
+        case cmdTuneReturnDelay:
+            cmdPtr->tunerHandle->tune(cmdPtr->value != 0);
+            xSemaphoreGive(ChainsReadyHandle);
+            break;
+        case cmdBringUp:
+            periph::bringUpChain(static_cast<uint8_t>(cmdPtr->value));
+            xSemaphoreGive(ChainsReadyHandle);
+            break;
+        case cmdReadTelemetry:
+            // Same as for cmdReadGroupPosition
+            if(cmdPtr->schedulerHandle->group()->isActionPending()){
+                break;
+            }
+
+            cmdPtr->schedulerHandle->runCycle(
+                reads,
+                dynamixel::MAX_TELEMETRY_READS,
+                numReads
+            );
+
+            // Same as for cmdReadGroupPosition
+            for(size_t i = 0; i < numReads; ++i){
+                // issue #130: send NAN upon read failure
+                data.payload = reads[i].isValid ? reads[i].value : NAN;
+                data.id = cmdPtr->schedulerHandle->group()->motor(
+                    reads[i].motorIdx
+                )->id();
+                data.type = MotorData_t::T_FLOAT;
+                data.item = reads[i].item;
+
+                xQueueSend(BufferWriteQueueHandle, &dataToSend, 0);
+            }
+            break;
         default:
             break;
     }
@@ -15,6 +15,7 @@
 
 /********************************* Includes **********************************/
 #include "CircularDmaBuffer.h"
+#include <cstring>
 
 
 
@@ -23,26 +24,14 @@
 namespace{
 // Functions
 // ----------------------------------------------------------------------------
-static size_t readBuffImpl(const uint8_t*   buff_p,
-                           const size_t&    size,
-                           const size_t&    head,
-                           size_t&          tail,
-                           uint8_t*         out_buff)
+static size_t copySpans(const uart::ReadSpans& spans, uint8_t* out_buff, const size_t max_bytes = SIZE_MAX)
 {
-    size_t numReceived = 0;
+    const size_t first_size = (spans.first_size < max_bytes) ? spans.first_size : max_bytes;
+    const size_t second_size = (spans.second_size < max_bytes - first_size) ? spans.second_size : max_bytes - first_size;
 
-    if (tail > head) {
-        while (tail < size) {
-            out_buff[numReceived++] = buff_p[tail++];
-        }
-        tail = 0;
-    }
-
-    while (tail < head) {
-        out_buff[numReceived++] = buff_p[tail++];
-    }
-
-    return numReceived;
+    memcpy(out_buff, spans.first, first_size);
+    memcpy(&out_buff[first_size], spans.second, second_size);
+    return first_size + second_size;
 }
 
 } // end anonymous namespace
@@ -63,38 +52,77 @@ CircularDmaBuffer::CircularDmaBuffer(
     const UartInterface* hw_if_in,
     const uint16_t transmission_size_in,
     const size_t buff_size_in,
-    uint8_t *buff_p_in
+    uint8_t *buff_p_in,
+    const bool notify_on_idle_in
 ) :
     m_uart_handle(uart_handle_in),
     m_hw_if(hw_if_in),
     m_transmission_size(transmission_size_in),
     m_buff_size(buff_size_in),
-    m_buff_p(buff_p_in) {
+    m_buff_p(buff_p_in),
+    m_notify_on_idle(notify_on_idle_in) {
 
 }
 
 /**
- * @brief Checks for failing conditions that make the buffer inoperable.
+ * @brief Checks for failing conditions that make the buffer inoperable. m_buff_size must either hold exactly one
+ *        transmission, or at least two so that one can arrive while the other is being read.
  * @return true if no failing conditions detected, false if one or more failing conditions are detected.
  */
 bool CircularDmaBuffer::selfCheck() const {
-    bool ok = m_transmission_size == m_buff_size; // TODO: should support m_buff_size > m_transmission_size as well.
+    bool ok = (m_buff_p != nullptr) && (m_transmission_size != 0) && (m_buff_size <= UINT16_MAX); // NDTR is 16 bits
+    ok = ok && ((m_buff_size == m_transmission_size) || (m_buff_size >= 2 * static_cast<size_t>(m_transmission_size)));
     return ok;
 }
 
 /**
- * @brief Updates m_buff_head to point to 1 past the last entry written to m_buffer_p by the DMA transfer.
+ * @brief Updates m_buff_head to point to 1 past the last entry written to m_buffer_p by the DMA transfer. If the DMA
+ *        has lapped m_buff_tail since the last update, the unread bytes were overwritten: they are all discarded and
+ *        counted as lost (@see getNumOverruns, getNumBytesLost). Laps are counted by onTransferComplete, and also
+ *        inferred from m_buff_head moving backwards, so an overrun of less than a lap is caught even without it.
  * @return The index that m_buff_head is at after updating.
  */
 size_t CircularDmaBuffer::updateHead() {
-    return (m_buff_head = m_buff_size - static_cast<size_t>(m_hw_if->getDmaRxInstanceNDTR(m_uart_handle))); // TODO: NDTR should come through the UartInterface so can test this
+    // Sample the lap count on both sides of NDTR, in case the transfer complete interrupt fires in between
+    uint32_t laps_isr;
+    size_t head;
+    do {
+        laps_isr = m_num_laps_isr;
+        head = m_buff_size - static_cast<size_t>(m_hw_if->getDmaRxInstanceNDTR(m_uart_handle));
+    } while (laps_isr != m_num_laps_isr);
+
+    if (static_cast<int32_t>(laps_isr - m_num_laps) > 0) {
+        m_num_laps = laps_isr;
+    }
+
+    uint32_t written = m_num_laps * m_buff_size + head;
+    if (static_cast<int32_t>(written - m_bytes_written) < 0) {
+        // The DMA wrapped around, but the lap has not been counted yet
+        ++m_num_laps;
+        written += m_buff_size;
+    }
+
+    m_bytes_written = written;
+    m_buff_head = (head == m_buff_size) ? 0 : head;
+
+    const uint32_t num_unread = m_bytes_written - m_bytes_read;
+    if (num_unread > m_buff_size) {
+        // There is no telling how much of the frame at the tail survived, so start over from the head
+        ++m_num_overruns;
+        m_num_bytes_lost += num_unread;
+        m_bytes_read = m_bytes_written;
+        m_buff_tail = m_buff_head;
+    }
+
+    return m_buff_head;
 }
 
 /**
  * @brief Sets m_buff_tail equal to m_buff_head, discarding any unread received bytes in m_buff_p.
- * @return the number of unread received bytes discarded.
+ * @return The index that m_buff_tail is at after updating.
  */
 size_t CircularDmaBuffer::catchupTail() {
+    m_bytes_read = m_bytes_written;
     return (m_buff_tail = m_buff_head);
 }
 
@@ -103,7 +131,7 @@ size_t CircularDmaBuffer::catchupTail() {
  * @return true if new data is available, no if not.
  */
 bool CircularDmaBuffer::dataAvail() const {
-    return m_buff_head != m_buff_tail;
+    return m_bytes_written != m_bytes_read;
 }
 
 /**
@@ -112,8 +140,7 @@ bool CircularDmaBuffer::dataAvail() const {
  * @return number of bytes read from m_buff_p into out_buff.
  */
 size_t CircularDmaBuffer::peekBuff(uint8_t *out_buff) const {
-    size_t tailIdx = m_buff_tail;
-    return readBuffImpl(m_buff_p, m_buff_size, m_buff_head, tailIdx, out_buff);
+    return copySpans(peekSpans(), out_buff);
 }
 
 /**
@@ -122,19 +149,98 @@ size_t CircularDmaBuffer::peekBuff(uint8_t *out_buff) const {
  * @return number of bytes read from m_buff_p into out_buff.
  */
 size_t CircularDmaBuffer::readBuff(uint8_t *out_buff) {
-    return readBuffImpl(m_buff_p, m_buff_size, m_buff_head, m_buff_tail, out_buff);
+    return consume(copySpans(peekSpans(), out_buff));
 }
 
-void CircularDmaBuffer::initiate() const {
+/**
+ * @brief Reads up to max_bytes of new data in m_buff_p into out_buff, updating the m_buff_tail.
+ * @param out_buff An array where the read data is written to, which must hold at least max_bytes.
+ * @param max_bytes The largest number of bytes to read.
+ * @return number of bytes read from m_buff_p into out_buff.
+ */
+size_t CircularDmaBuffer::readBuff(uint8_t *out_buff, size_t max_bytes) {
+    return consume(copySpans(peekSpans(), out_buff, max_bytes));
+}
+
+/**
+ * @brief Points to the new data in m_buff_p without copying it or updating m_buff_tail, so that it can be parsed in
+ *        place. The spans stay valid until the DMA laps them; call consume once done with (part of) them.
+ * @return the new data, as up to two contiguous spans in the order it was received.
+ */
+ReadSpans CircularDmaBuffer::peekSpans() const {
+    ReadSpans spans;
+    const size_t num_avail = m_bytes_written - m_bytes_read;
+    const size_t num_to_end = m_buff_size - m_buff_tail;
+
+    spans.first = &m_buff_p[m_buff_tail];
+    spans.first_size = (num_avail < num_to_end) ? num_avail : num_to_end;
+    spans.second = m_buff_p;
+    spans.second_size = num_avail - spans.first_size;
+    return spans;
+}
+
+/**
+ * @brief Advances m_buff_tail past data that has been handled in place (@see peekSpans).
+ * @param num_bytes The number of bytes to mark as read. Clamped to the number of unread bytes.
+ * @return the number of bytes marked as read.
+ */
+size_t CircularDmaBuffer::consume(size_t num_bytes) {
+    const size_t num_avail = m_bytes_written - m_bytes_read;
+    if (num_bytes > num_avail) {
+        num_bytes = num_avail;
+    }
+
+    m_buff_tail += num_bytes;
+    if (m_buff_tail >= m_buff_size) {
+        m_buff_tail -= m_buff_size;
+    }
+    m_bytes_read += num_bytes;
+    return num_bytes;
+}
+
+/**
+ * @brief Starts the circular DMA transfer over all of m_buff_p, from its start. If the buffer was constructed with
+ *        notify_on_idle, the receiving thread is also signalled each time the line goes idle
+ *        (@see UartInterface::receiveToIdleDMA), so that it does not have to poll for the end of each message.
+ */
+void CircularDmaBuffer::initiate() {
+    m_buff_head = 0;
+    m_buff_tail = 0;
+    m_num_laps_isr = 0;
+    m_num_laps = 0;
+    m_bytes_written = 0;
+    m_bytes_read = 0;
+
+    if (m_notify_on_idle) {
+        m_hw_if->receiveToIdleDMA(const_cast<UART_HandleTypeDef*>(m_uart_handle),
+                const_cast<uint8_t*>(m_buff_p), m_buff_size);
+        return;
+    }
+
     m_hw_if->receiveDMA(const_cast<UART_HandleTypeDef*>(m_uart_handle),
-            const_cast<uint8_t*>(m_buff_p), m_transmission_size);
+            const_cast<uint8_t*>(m_buff_p), m_buff_size);
 }
 
-void CircularDmaBuffer::reinitiateIfError() const {
+/**
+ * @brief Restarts the DMA transfer if the UART has flagged an error, since the transfer may have been stopped.
+ * @return true if the transfer was restarted, in which case the DMA writes from the start of m_buff_p again.
+ */
+bool CircularDmaBuffer::reinitiateIfError() {
     if(m_hw_if->getErrorCode(m_uart_handle) != HAL_UART_ERROR_NONE){
         m_hw_if->abortReceive(const_cast<UART_HandleTypeDef*>(m_uart_handle));
         this->initiate();
+        return true;
     }
+
+    return false;
+}
+
+/**
+ * @brief Counts a lap of the DMA around m_buff_p. Meant to be called from the UART's reception complete callback,
+ *        which fires each time the DMA wraps around; with it, updateHead catches overruns of any length.
+ */
+void CircularDmaBuffer::onTransferComplete() {
+    m_num_laps_isr = m_num_laps_isr + 1;
 }
 
 const UART_HandleTypeDef* CircularDmaBuffer::getUartHandle() const {
@@ -166,6 +272,20 @@ size_t CircularDmaBuffer::getBuffTail() const {
     return m_buff_tail;
 }
 
+/**
+ * @brief Returns the number of times the DMA lapped m_buff_tail, as detected by updateHead.
+ */
+uint32_t CircularDmaBuffer::getNumOverruns() const {
+    return m_num_overruns;
+}
+
+/**
+ * @brief Returns the number of unread bytes discarded because of overruns.
+ */
+uint32_t CircularDmaBuffer::getNumBytesLost() const {
+    return m_num_bytes_lost;
+}
+
 } // end namespace uart
 
 
@@ -0,0 +1,283 @@
+/**
+  *****************************************************************************
+  * @file   GoalFrameParser.cpp
+  * @author Tyler Gamvrelis
+  *
+  * @ingroup GoalFrameParser
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "GoalFrameParser.h"
+#include <string.h>
+#include <algorithm>
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Polynomial used by the STM32 CRC unit */
+constexpr uint32_t CRC32_POLYNOMIAL = 0x04C11DB7;
+
+/** @brief Value of each header byte */
+constexpr uint8_t HEADER_BYTE = 0xFF;
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/** @brief Reads a little-endian word, regardless of alignment */
+uint32_t readWord(const uint8_t* data){
+    return static_cast<uint32_t>(data[0]) |
+           (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+/** @brief Returns true if any byte of word is 0xFF */
+bool hasHeaderByte(uint32_t word){
+    const uint32_t inverted = ~word;
+    return ((inverted - 0x01010101) & ~inverted & 0x80808080) != 0;
+}
+
+} // end anonymous namespace
+
+
+
+
+namespace comm{
+/********************************* Functions *********************************/
+uint32_t crc32Software(const uint8_t* data, size_t numBytes){
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i = 0; i + 4 <= numBytes; i += 4){
+        crc ^= readWord(&data[i]);
+        for(uint8_t bit = 0; bit < 32; ++bit){
+            crc = (crc & 0x80000000) ?
+                  ((crc << 1) ^ CRC32_POLYNOMIAL) :
+                  (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+size_t writeFrame(
+    const uint8_t* message,
+    size_t len,
+    uint8_t* out,
+    Crc32Function crc
+)
+{
+    memset(out, HEADER_BYTE, FRAME_HEADER_SIZE);
+    memcpy(&out[FRAME_HEADER_SIZE], message, len);
+
+    const uint32_t messageCrc = crc(message, len);
+    uint8_t* crcBytes = &out[FRAME_HEADER_SIZE + len];
+    for(uint8_t i = 0; i < FRAME_CRC_SIZE; ++i){
+        crcBytes[i] = static_cast<uint8_t>(messageCrc >> (8 * i));
+    }
+
+    return FRAME_HEADER_SIZE + len + FRAME_CRC_SIZE;
+}
+
+
+
+
+/****************************** GoalFrameParser ******************************/
+// Public
+// ----------------------------------------------------------------------------
+GoalFrameParser::GoalFrameParser(Crc32Function crc)
+    :
+        m_crc(crc)
+{
+
+}
+
+size_t GoalFrameParser::parse(const uint8_t* data, size_t len, bool& complete){
+    size_t i = 0;
+    while(true){
+        const bool replaying = m_replayIdx < m_replaySize;
+        if(!replaying && (i == len)){
+            break;
+        }
+
+        const uint8_t* next = replaying ? &m_replay[m_replayIdx] : &data[i];
+        const size_t numAvail = replaying ? (m_replaySize - m_replayIdx) :
+                                            (len - i);
+        const size_t n = (m_numFrameBytes < FRAME_HEADER_SIZE) ?
+                         findHeader(next, numAvail) :
+                         receiveFrame(next, numAvail);
+        if(replaying){
+            m_replayIdx += n;
+        }
+        else{
+            i += n;
+        }
+
+        if(checkFrame()){
+            complete = true;
+            break;
+        }
+    }
+
+    return i;
+}
+
+const uint8_t* GoalFrameParser::getGoal() const{
+    return reinterpret_cast<const uint8_t*>(m_frames[m_rxIdx ^ 1].body);
+}
+
+size_t GoalFrameParser::getGoalSize() const{
+    return m_goalSize;
+}
+
+void GoalFrameParser::reset(){
+    m_numFrameBytes = 0;
+    m_frameSize = 0;
+    m_replayIdx = 0;
+    m_replaySize = 0;
+    m_numSkipped = 0;
+}
+
+uint32_t GoalFrameParser::getNumFrames() const{
+    return m_numFrames;
+}
+
+uint32_t GoalFrameParser::getNumCrcErrors() const{
+    return m_numCrcErrors;
+}
+
+uint32_t GoalFrameParser::getNumUnknownMessages() const{
+    return m_numUnknownMessages;
+}
+
+uint32_t GoalFrameParser::getNumResyncs() const{
+    return m_numResyncs;
+}
+
+uint32_t GoalFrameParser::getNumDiscardedBytes() const{
+    return m_numDiscardedBytes;
+}
+
+
+
+
+// Private
+// ----------------------------------------------------------------------------
+size_t GoalFrameParser::findHeader(const uint8_t* data, size_t len){
+    size_t i = 0;
+    if(m_numFrameBytes == 0){
+        while((len - i >= 4) && !hasHeaderByte(readWord(&data[i]))){
+            i += 4;
+        }
+        m_numSkipped += i;
+    }
+
+    while((i < len) && (m_numFrameBytes < FRAME_HEADER_SIZE)){
+        if(data[i++] != HEADER_BYTE){
+            // Back to skipping words
+            m_numSkipped += m_numFrameBytes + 1;
+            m_numFrameBytes = 0;
+            return i;
+        }
+        ++m_numFrameBytes;
+    }
+
+    if(m_numFrameBytes == FRAME_HEADER_SIZE){
+        memset(m_frames[m_rxIdx].header, HEADER_BYTE, FRAME_HEADER_SIZE);
+        countDiscarded();
+    }
+
+    return i;
+}
+
+size_t GoalFrameParser::receiveFrame(const uint8_t* data, size_t len){
+    const size_t end = (m_frameSize != 0) ?
+                       m_frameSize :
+                       (FRAME_HEADER_SIZE + GOAL_SIZE_PREFIX);
+    const size_t n = std::min(end - m_numFrameBytes, len);
+
+    uint8_t* frame = reinterpret_cast<uint8_t*>(&m_frames[m_rxIdx]);
+    memcpy(&frame[m_numFrameBytes], data, n);
+    m_numFrameBytes += n;
+    return n;
+}
+
+bool GoalFrameParser::checkFrame(){
+    if(m_numFrameBytes < FRAME_HEADER_SIZE + GOAL_SIZE_PREFIX){
+        return false;
+    }
+
+    const uint8_t* message =
+        reinterpret_cast<const uint8_t*>(m_frames[m_rxIdx].body);
+    if(m_frameSize == 0){
+        const size_t messageSize = goalMessageSize(message);
+        if(messageSize == 0){
+            ++m_numUnknownMessages;
+            rejectFrame();
+            return false;
+        }
+        m_frameSize = FRAME_HEADER_SIZE + messageSize + FRAME_CRC_SIZE;
+    }
+
+    if(m_numFrameBytes < m_frameSize){
+        return false;
+    }
+
+    const size_t messageSize = m_frameSize - FRAME_HEADER_SIZE - FRAME_CRC_SIZE;
+    if(m_crc(message, messageSize) != readWord(&message[messageSize])){
+        ++m_numCrcErrors;
+        rejectFrame();
+        return false;
+    }
+
+    ++m_numFrames;
+    m_goalSize = messageSize;
+    m_rxIdx ^= 1;
+    m_numFrameBytes = 0;
+    m_frameSize = 0;
+    return true;
+}
+
+void GoalFrameParser::rejectFrame(){
+    // The header that was locked onto may have been in the middle of a frame
+    // that was cut short, so look for one from the byte after it. Any bytes
+    // that were already held back follow on from the rejected ones
+    const uint8_t* frame = reinterpret_cast<const uint8_t*>(&m_frames[m_rxIdx]);
+    const size_t numRejected = m_numFrameBytes - 1;
+    const size_t numHeld = m_replaySize - m_replayIdx;
+    memmove(&m_replay[numRejected], &m_replay[m_replayIdx], numHeld);
+    memcpy(m_replay, &frame[1], numRejected);
+    m_replayIdx = 0;
+    m_replaySize = numRejected + numHeld;
+
+    ++m_numSkipped;
+    m_numFrameBytes = 0;
+    m_frameSize = 0;
+}
+
+void GoalFrameParser::countDiscarded(){
+    if(m_numSkipped != 0){
+        ++m_numResyncs;
+        m_numDiscardedBytes += m_numSkipped;
+        m_numSkipped = 0;
+    }
+}
+
+} // end namespace comm
+
+
+
+
+/**
+ * @}
+ */
+/* end - GoalFrameParser */
@@ -0,0 +1,400 @@
+/**
+  *****************************************************************************
+  * @file   WireFormat.cpp
+  * @author Tyler Gamvrelis
+  *
+  * @ingroup WireFormat
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "WireFormat.h"
+#include <string.h>
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Degrees per second per LSB of the MPU6050 gyro at +/- 250 deg/s */
+constexpr float GYRO_SCALE = 1.0f / 131.0f;
+
+/** @brief m/s^2 per LSB of the MPU6050 accelerometer at +/- 2 g */
+constexpr float ACCEL_SCALE = 9.81f / 16384.0f;
+
+/** @brief Percent of the maximum torque per LSB of a joint load */
+constexpr float LOAD_SCALE = 0.1f;
+
+/** @brief Volts per LSB of a supply voltage, as the motors report it */
+constexpr float VOLTAGE_SCALE = 0.1f;
+
+static_assert(
+    comm::NUM_STATE_FIELDS <= 32,
+    "The fields of a state must fit in a 32-bit mask"
+);
+
+/** @brief Mask with a bit set for every field of a state */
+constexpr uint32_t ALL_STATE_FIELDS =
+    0xFFFFFFFFu >> (32 - comm::NUM_STATE_FIELDS);
+
+/** @brief Offset of the joint loads among the fields of a state */
+constexpr size_t STATE_LOADS_OFFSET =
+    comm::NUM_STATE_JOINTS + comm::NUM_STATE_IMU;
+
+/** @brief Offset of the health readings among the fields of a state */
+constexpr size_t STATE_HEALTH_OFFSET =
+    STATE_LOADS_OFFSET + comm::NUM_STATE_JOINTS;
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/** @brief Converts a value to the nearest LSB of its field, saturating */
+int16_t toFixed(float value, float scale){
+    float lsbs = value / scale;
+    lsbs += (lsbs < 0) ? -0.5f : 0.5f;
+    if(lsbs >= INT16_MAX){
+        return INT16_MAX;
+    }
+    if(lsbs <= INT16_MIN){
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(lsbs);
+}
+
+/** @brief Writes a little-endian int16 */
+void writeInt16(uint8_t* out, uint16_t value){
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+/** @brief Reads a little-endian int16 */
+uint16_t readInt16(const uint8_t* in){
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+/** @brief Reads a little-endian int32 */
+uint32_t readInt32(const uint8_t* in){
+    return static_cast<uint32_t>(readInt16(in)) |
+           (static_cast<uint32_t>(readInt16(&in[2])) << 16);
+}
+
+/** @brief Returns the size of a sparse goal carrying numJoints joints */
+size_t sparseGoalSize(size_t numJoints){
+    const size_t size = comm::GOAL_SIZE_PREFIX + 2 * numJoints;
+    return (size + 3) & ~static_cast<size_t>(3);
+}
+
+/** @brief Writes the version, type and ID that start each message */
+void writePreamble(comm::MessageType type, uint16_t id, uint8_t* out){
+    out[0] = comm::WIRE_FORMAT_VERSION;
+    out[1] = static_cast<uint8_t>(type);
+    writeInt16(&out[2], id);
+}
+
+/** @brief Returns true if the preamble is of this version and the given type */
+bool checkPreamble(const uint8_t* in, size_t len, comm::MessageType type){
+    return (len >= comm::MESSAGE_PREAMBLE_SIZE) &&
+           (in[0] == comm::WIRE_FORMAT_VERSION) &&
+           (in[1] == static_cast<uint8_t>(type));
+}
+
+/**
+ * @brief Writes the value of each field whose bit is set in mask, in order
+ * @return The number of bytes written
+ */
+size_t encodeFields(
+    const comm::FieldType* fields,
+    size_t numFields,
+    uint32_t mask,
+    const float* values,
+    uint8_t* out
+)
+{
+    size_t numBytes = 0;
+    for(size_t field = 0; field < numFields; ++field){
+        if(mask & (1u << field)){
+            const int16_t lsbs = toFixed(
+                values[field],
+                comm::fieldScale(fields[field])
+            );
+            writeInt16(&out[numBytes], static_cast<uint16_t>(lsbs));
+            numBytes += 2;
+        }
+    }
+    return numBytes;
+}
+
+/** @brief Reads the fields written by encodeFields */
+void decodeFields(
+    const uint8_t* in,
+    const comm::FieldType* fields,
+    size_t numFields,
+    uint32_t mask,
+    float* values
+)
+{
+    for(size_t field = 0; field < numFields; ++field){
+        if(mask & (1u << field)){
+            const int16_t lsbs = static_cast<int16_t>(readInt16(in));
+            values[field] = lsbs * comm::fieldScale(fields[field]);
+            in += 2;
+        }
+    }
+}
+
+} // end anonymous namespace
+
+
+
+
+namespace comm{
+/********************************* Functions *********************************/
+float fieldScale(FieldType type){
+    switch(type){
+        case FieldType::JOINT_MX28:
+            return dynamixel::degreesPerTick(dynamixel::ResolutionDivider::MX28);
+        case FieldType::JOINT_AX12A:
+            return dynamixel::degreesPerTick(dynamixel::ResolutionDivider::AX12A);
+        case FieldType::GYRO:
+            return GYRO_SCALE;
+        case FieldType::ACCEL:
+            return ACCEL_SCALE;
+        case FieldType::LOAD:
+            return LOAD_SCALE;
+        case FieldType::VOLTAGE:
+            return VOLTAGE_SCALE;
+        case FieldType::TEMPERATURE:
+        default:
+            return 1.0f;
+    }
+}
+
+size_t goalMessageSize(const uint8_t* in){
+    if(checkPreamble(in, GOAL_SIZE_PREFIX, MessageType::GOAL)){
+        return GOAL_MESSAGE_SIZE;
+    }
+    if(checkPreamble(in, GOAL_SIZE_PREFIX, MessageType::TIMED_GOAL)){
+        return TIMED_GOAL_MESSAGE_SIZE;
+    }
+    if(checkPreamble(in, GOAL_SIZE_PREFIX, MessageType::SPARSE_GOAL)){
+        const uint32_t jointMask = readInt32(&in[MESSAGE_PREAMBLE_SIZE]);
+        if((jointMask & ~ALL_GOAL_JOINTS) == 0){
+            return sparseGoalSize(__builtin_popcount(jointMask));
+        }
+    }
+    return 0;
+}
+
+void encodeGoal(uint16_t id, const float* angles, uint8_t* out){
+    writePreamble(MessageType::GOAL, id, out);
+    encodeFields(
+        GOAL_FIELDS,
+        NUM_GOAL_JOINTS,
+        ALL_GOAL_JOINTS,
+        angles,
+        &out[MESSAGE_PREAMBLE_SIZE]
+    );
+}
+
+size_t encodeSparseGoal(
+    uint16_t id,
+    uint32_t jointMask,
+    const float* angles,
+    uint8_t* out
+)
+{
+    jointMask &= ALL_GOAL_JOINTS;
+    writePreamble(MessageType::SPARSE_GOAL, id, out);
+    writeInt16(&out[MESSAGE_PREAMBLE_SIZE], static_cast<uint16_t>(jointMask));
+    writeInt16(
+        &out[MESSAGE_PREAMBLE_SIZE + 2],
+        static_cast<uint16_t>(jointMask >> 16)
+    );
+
+    size_t size = GOAL_SIZE_PREFIX + encodeFields(
+        GOAL_FIELDS,
+        NUM_GOAL_JOINTS,
+        jointMask,
+        angles,
+        &out[GOAL_SIZE_PREFIX]
+    );
+    while(size % 4 != 0){
+        out[size++] = 0;
+    }
+    return size;
+}
+
+bool decodeGoal(
+    const uint8_t* in,
+    size_t len,
+    uint16_t& id,
+    uint32_t& jointMask,
+    float* angles
+)
+{
+    const size_t size = (len >= GOAL_SIZE_PREFIX) ? goalMessageSize(in) : 0;
+    if((size == 0) || (len < size)){
+        return false;
+    }
+
+    size_t fieldsOffset = MESSAGE_PREAMBLE_SIZE;
+    jointMask = ALL_GOAL_JOINTS;
+    if(in[1] == static_cast<uint8_t>(MessageType::SPARSE_GOAL)){
+        fieldsOffset = GOAL_SIZE_PREFIX;
+        jointMask = readInt32(&in[MESSAGE_PREAMBLE_SIZE]);
+    }
+    else if(in[1] != static_cast<uint8_t>(MessageType::GOAL)){
+        return false;
+    }
+
+    id = readInt16(&in[2]);
+    decodeFields(
+        &in[fieldsOffset],
+        GOAL_FIELDS,
+        NUM_GOAL_JOINTS,
+        jointMask,
+        angles
+    );
+    return true;
+}
+
+void encodeTimedGoal(
+    uint16_t id,
+    uint16_t durationMs,
+    uint8_t flags,
+    const float* angles,
+    uint8_t* out
+)
+{
+    writePreamble(MessageType::TIMED_GOAL, id, out);
+    writeInt16(&out[MESSAGE_PREAMBLE_SIZE], durationMs);
+    out[MESSAGE_PREAMBLE_SIZE + 2] = flags;
+    out[MESSAGE_PREAMBLE_SIZE + 3] = 0;
+    encodeFields(
+        GOAL_FIELDS,
+        NUM_GOAL_JOINTS,
+        ALL_GOAL_JOINTS,
+        angles,
+        &out[GOAL_SIZE_PREFIX]
+    );
+}
+
+bool decodeTimedGoal(
+    const uint8_t* in,
+    size_t len,
+    uint16_t& id,
+    uint16_t& durationMs,
+    uint8_t& flags,
+    float* angles
+)
+{
+    if(!checkPreamble(in, len, MessageType::TIMED_GOAL) ||
+       (len < TIMED_GOAL_MESSAGE_SIZE))
+    {
+        return false;
+    }
+
+    id = readInt16(&in[2]);
+    durationMs = readInt16(&in[MESSAGE_PREAMBLE_SIZE]);
+    flags = in[MESSAGE_PREAMBLE_SIZE + 2];
+    decodeFields(
+        &in[GOAL_SIZE_PREFIX],
+        GOAL_FIELDS,
+        NUM_GOAL_JOINTS,
+        ALL_GOAL_JOINTS,
+        angles
+    );
+    return true;
+}
+
+void encodeState(
+    uint16_t id,
+    const float* angles,
+    const float* imu,
+    const float* loads,
+    const float* health,
+    uint8_t* out
+)
+{
+    float values[NUM_STATE_FIELDS];
+    memcpy(values, angles, NUM_STATE_JOINTS * sizeof(float));
+    memcpy(&values[NUM_STATE_JOINTS], imu, NUM_STATE_IMU * sizeof(float));
+    memcpy(
+        &values[STATE_LOADS_OFFSET],
+        loads,
+        NUM_STATE_JOINTS * sizeof(float)
+    );
+    memcpy(
+        &values[STATE_HEALTH_OFFSET],
+        health,
+        NUM_STATE_HEALTH * sizeof(float)
+    );
+
+    writePreamble(MessageType::STATE, id, out);
+    encodeFields(
+        STATE_FIELDS,
+        NUM_STATE_FIELDS,
+        ALL_STATE_FIELDS,
+        values,
+        &out[MESSAGE_PREAMBLE_SIZE]
+    );
+}
+
+bool decodeState(
+    const uint8_t* in,
+    size_t len,
+    uint16_t& id,
+    float* angles,
+    float* imu,
+    float* loads,
+    float* health
+)
+{
+    if(!checkPreamble(in, len, MessageType::STATE) ||
+       (len < STATE_MESSAGE_SIZE))
+    {
+        return false;
+    }
+
+    float values[NUM_STATE_FIELDS];
+    decodeFields(
+        &in[MESSAGE_PREAMBLE_SIZE],
+        STATE_FIELDS,
+        NUM_STATE_FIELDS,
+        ALL_STATE_FIELDS,
+        values
+    );
+
+    id = readInt16(&in[2]);
+    memcpy(angles, values, NUM_STATE_JOINTS * sizeof(float));
+    memcpy(imu, &values[NUM_STATE_JOINTS], NUM_STATE_IMU * sizeof(float));
+    memcpy(
+        loads,
+        &values[STATE_LOADS_OFFSET],
+        NUM_STATE_JOINTS * sizeof(float)
+    );
+    memcpy(
+        health,
+        &values[STATE_HEALTH_OFFSET],
+        NUM_STATE_HEALTH * sizeof(float)
+    );
+    return true;
+}
+
+} // end namespace comm
+
+
+
+
+/**
+ * @}
+ */
+/* end - WireFormat */
@@ -13,6 +13,85 @@
 
 /********************************* Includes **********************************/
 #include "DaisyChain.h"
+#include <string.h>
+#include <algorithm>
+
+using dynamixel::StatusPacket;
+using dynamixel::StatusPacketHandler;
+using uart::ReadSpans;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Number of bytes fed from the streaming reception buffer into the
+ *        decoder at a time, so that reading stops soon after the last
+ *        expected packet
+ */
+constexpr size_t STREAM_CHUNK_SIZE = 16;
+
+/**
+ * @brief Time the UART raises DE ahead of the start bit, and holds it after
+ *        the last stop bit, with DirectionControl::DRIVER_ENABLE, in sample
+ *        times (1/16 of a bit by default). The transceivers switch within
+ *        tens of nanoseconds, so this is only margin
+ */
+constexpr uint8_t DRIVER_ENABLE_ASSERTION_TIME = 2;
+constexpr uint8_t DRIVER_ENABLE_DEASSERTION_TIME = 2;
+
+
+
+
+// Types & enums
+// ----------------------------------------------------------------------------
+/** @brief Passed to dispatch by requestStatusPackets */
+struct DispatchContext{
+    StatusPacketHandler handler;
+    void* context;
+    size_t numAccepted;
+};
+
+/** @brief Passed to acceptId by requestStatusPacket */
+struct SinglePacketContext{
+    uint8_t id;
+    uint8_t* buf;
+    size_t bufSize;
+    StatusPacket* packet;
+};
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+void dispatch(const StatusPacket& packet, void* context){
+    DispatchContext* ctx = static_cast<DispatchContext*>(context);
+    if(ctx->handler(packet, ctx->context)){
+        ++ctx->numAccepted;
+    }
+}
+
+bool acceptId(const StatusPacket& packet, void* context){
+    SinglePacketContext* ctx = static_cast<SinglePacketContext*>(context);
+    if((packet.id != ctx->id) || (packet.numParams > ctx->bufSize)){
+        return false;
+    }
+
+    // The packet's parameters are in the decoder's buffer, which is reused
+    // for the next packet. buf is free to overwrite: without streaming, a
+    // single packet fits in the decoder's buffer, so all of buf has already
+    // been fed in by the time the packet is complete
+    memcpy(ctx->buf, packet.params, packet.numParams);
+    *ctx->packet = packet;
+    ctx->packet->params = ctx->buf;
+    return true;
+}
+
+} // end anonymous namespace
 
 
 
@@ -27,7 +106,11 @@ DaisyChain::DaisyChain(const DaisyChainParams& params)
         uartDriver(params.uartDriver),
         gpioif(params.gpioif),
         dataDirPort(params.dataDirPort),
-        dataDirPinNum(params.dataDirPinNum)
+        dataDirPinNum(params.dataDirPinNum),
+        protocol(params.protocol),
+        m_dirControl(params.dirControl),
+        rxBuffer(params.rxBuffer),
+        m_decoder(params.protocol)
 {
 
 }
@@ -36,7 +119,50 @@ DaisyChain::~DaisyChain(){
 
 }
 
+bool DaisyChain::initDirectionControl(){
+    if(m_dirControl == DirectionControl::DRIVER_ENABLE){
+        if(uartDriver->enableDriverEnable(
+               DRIVER_ENABLE_ASSERTION_TIME,
+               DRIVER_ENABLE_DEASSERTION_TIME
+           ))
+        {
+            return true;
+        }
+
+        // Keep the bus usable through the data direction pin
+        m_dirControl = DirectionControl::SOFTWARE;
+        changeBusDir(Direction::RX);
+        return false;
+    }
+
+    changeBusDir(Direction::RX);
+    return true;
+}
+
+DirectionControl DaisyChain::getDirectionControl(void) const{
+    return m_dirControl;
+}
+
+bool DaisyChain::onTransmitComplete() const{
+    if(m_dirControl == DirectionControl::TC_INTERRUPT){
+        gpioif->writePin(
+            const_cast<GPIO_TypeDef*>(dataDirPort),
+            dataDirPinNum,
+            GPIO_PIN_RESET
+        );
+    }
+
+    return !uartDriver->isTransceiving();
+}
+
 void DaisyChain::setIOType(IO_Type io_type){
+    if(m_isStreaming && (io_type != IO_Type::DMA)){
+        rxBuffer->getHwIf()->abortReceive(
+            const_cast<UART_HandleTypeDef*>(rxBuffer->getUartHandle())
+        );
+        m_isStreaming = false;
+    }
+
     const_cast<UartDriver*>(uartDriver)->setIOType(io_type);
 }
 
@@ -44,14 +170,193 @@ IO_Type DaisyChain::getIOType(void) const{
     return uartDriver->getIOType();
 }
 
+Protocol DaisyChain::getProtocol(void) const{
+    return protocol;
+}
+
 bool DaisyChain::requestTransmission(uint8_t* arr, size_t arrSize) const{
+    if(m_isStreaming){
+        // Anything received before the request goes out (e.g. a reply that
+        // came too late) is stale
+        flushStream();
+    }
+
     changeBusDir(Direction::TX);
-    return uartDriver->transmit(arr, arrSize);
+    bool success = uartDriver->transmit(arr, arrSize);
+
+    if(m_isStreaming){
+        // Listen right away, since the reply may start within microseconds.
+        // With the bus released from the interrupt or in hardware, the reply
+        // may even have started before this thread got to run again, so only
+        // the echo of the request is discarded
+        changeBusDir(Direction::RX);
+        serviceStream();
+        skipEcho(arr, arrSize, true);
+    }
+
+    return success;
 }
 
 bool DaisyChain::requestReception(uint8_t* buf, size_t bufSize) const{
+    if(!m_isStreaming){
+        changeBusDir(Direction::RX);
+        return uartDriver->receive(buf, bufSize);
+    }
+
+    // The request may still be going out (@see sendRequest)
+    const size_t numBytes = m_echoLen + bufSize;
+    const TickType_t start = uartDriver->getTickCount();
+    size_t numReceived = 0;
+    do{
+        serviceStream();
+        if(echoPending()){
+            continue;
+        }
+
+        numReceived += rxBuffer->readBuff(
+            &buf[numReceived],
+            bufSize - numReceived
+        );
+
+        if(numReceived == bufSize){
+            return true;
+        }
+    } while(uartDriver->waitForStream(start, numBytes));
+
+    return false;
+}
+
+bool DaisyChain::transceive(
+    uint8_t* request,
+    size_t requestLen,
+    uint8_t* buf,
+    size_t bufSize
+) const
+{
+    if(m_isStreaming){
+        const bool success = sendRequest(request, requestLen) &&
+                             requestReception(buf, bufSize);
+        endRequest(success);
+        return success;
+    }
+
+    // The bus has to be released without the thread's help, since it is
+    // not woken up until the reply is in
+    if(!releasesBusItself()){
+        return requestTransmission(request, requestLen) &&
+               requestReception(buf, bufSize);
+    }
+
+    changeBusDir(Direction::TX);
+    return uartDriver->transceive(request, requestLen, buf, bufSize);
+}
+
+bool DaisyChain::startStreaming(){
+    if((rxBuffer == nullptr) || (getIOType() != IO_Type::DMA)){
+        return false;
+    }
+
+    rxBuffer->initiate();
+    m_isStreaming = true;
     changeBusDir(Direction::RX);
-    return uartDriver->receive(buf, bufSize);
+    flushStream();
+    return true;
+}
+
+bool DaisyChain::isStreaming() const{
+    return m_isStreaming;
+}
+
+bool DaisyChain::requestStatusPackets(
+    uint8_t* buf,
+    size_t bufSize,
+    size_t numPackets,
+    StatusPacketHandler handler,
+    void* context
+) const
+{
+    return receiveStatusPackets(
+        nullptr,
+        0,
+        buf,
+        bufSize,
+        numPackets,
+        handler,
+        context
+    );
+}
+
+bool DaisyChain::requestStatusPacket(
+    uint8_t id,
+    uint8_t* buf,
+    size_t bufSize,
+    StatusPacket& packet
+) const
+{
+    SinglePacketContext ctx = {id, buf, bufSize, &packet};
+    return requestStatusPackets(buf, bufSize, 1, acceptId, &ctx);
+}
+
+bool DaisyChain::transceiveStatusPackets(
+    uint8_t* request,
+    size_t requestLen,
+    uint8_t* buf,
+    size_t bufSize,
+    size_t numPackets,
+    StatusPacketHandler handler,
+    void* context
+) const
+{
+    if(request == nullptr){
+        return false;
+    }
+
+    return receiveStatusPackets(
+        request,
+        requestLen,
+        buf,
+        bufSize,
+        numPackets,
+        handler,
+        context
+    );
+}
+
+bool DaisyChain::transceiveStatusPacket(
+    uint8_t* request,
+    size_t requestLen,
+    uint8_t id,
+    uint8_t* buf,
+    size_t bufSize,
+    StatusPacket& packet
+) const
+{
+    SinglePacketContext ctx = {id, buf, bufSize, &packet};
+    return transceiveStatusPackets(
+        request,
+        requestLen,
+        buf,
+        bufSize,
+        1,
+        acceptId,
+        &ctx
+    );
+}
+
+const StatusPacketDecoder& DaisyChain::getDecoder() const{
+    return m_decoder;
+}
+
+bool DaisyChain::setBaudRate(uint32_t baud) const{
+    return uartDriver->setBaudRate(baud);
+}
+
+uint32_t DaisyChain::getBaudRate(void) const{
+    return uartDriver->getBaudRate();
+}
+
+bool DaisyChain::supportsBaudRate(uint32_t baud) const{
+    return uartDriver->supportsBaudRate(baud);
 }
 
 
@@ -60,6 +365,19 @@ bool DaisyChain::requestReception(uint8_t* buf, size_t bufSize) const{
 // Private
 // ----------------------------------------------------------------------------
 void DaisyChain::changeBusDir(Direction dir) const{
+    if(m_dirControl == DirectionControl::DRIVER_ENABLE){
+        return;
+    }
+
+    // Polled transmissions don't raise the interrupt, so they are released
+    // here just like with SOFTWARE
+    if((m_dirControl == DirectionControl::TC_INTERRUPT) &&
+       (dir == Direction::RX) &&
+       (getIOType() != IO_Type::POLL))
+    {
+        return;
+    }
+
     switch(dir){
         case Direction::RX:
             gpioif->writePin(
@@ -80,6 +398,152 @@ void DaisyChain::changeBusDir(Direction dir) const{
     }
 }
 
+bool DaisyChain::releasesBusItself() const{
+    return (getIOType() != IO_Type::POLL) &&
+           (m_dirControl != DirectionControl::SOFTWARE);
+}
+
+bool DaisyChain::sendRequest(uint8_t* request, size_t requestLen) const{
+    if(!releasesBusItself()){
+        return requestTransmission(request, requestLen);
+    }
+
+    // The reply is streamed in no matter when the thread gets to run, so
+    // there is no point in waking it up once the request is out
+    flushStream();
+    changeBusDir(Direction::TX);
+    if(!uartDriver->beginTransceive(request, requestLen)){
+        return false;
+    }
+
+    m_echo = request;
+    m_echoLen = requestLen;
+    return true;
+}
+
+void DaisyChain::endRequest(bool success) const{
+    if(m_echoLen != 0){
+        uartDriver->endTransceive(success);
+    }
+
+    m_echo = nullptr;
+    m_echoLen = 0;
+}
+
+bool DaisyChain::echoPending() const{
+    if(m_echo == nullptr){
+        return false;
+    }
+
+    if(skipEcho(m_echo, m_echoLen, false)){
+        m_echo = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void DaisyChain::serviceStream() const{
+    if(rxBuffer->reinitiateIfError()){
+        // The transfer restarted from the beginning of the buffer
+        rxBuffer->updateHead();
+        rxBuffer->catchupTail();
+        m_decoder.reset();
+        return;
+    }
+
+    rxBuffer->updateHead();
+}
+
+void DaisyChain::flushStream() const{
+    serviceStream();
+    rxBuffer->catchupTail();
+    m_decoder.reset();
+}
+
+bool DaisyChain::skipEcho(
+    const uint8_t* arr,
+    size_t arrSize,
+    bool isSent
+) const
+{
+    const ReadSpans spans = rxBuffer->peekSpans();
+    const size_t numAvail = spans.first_size + spans.second_size;
+    const size_t n = std::min(numAvail, arrSize);
+    const size_t firstSize = std::min(spans.first_size, n);
+    const bool matches =
+        (memcmp(spans.first, arr, firstSize) == 0) &&
+        ((n == firstSize) ||
+         (memcmp(spans.second, &arr[firstSize], n - firstSize) == 0));
+    if(!matches){
+        return true;
+    }
+
+    if(numAvail >= arrSize){
+        rxBuffer->consume(arrSize);
+        return true;
+    }
+
+    // The echo is over by the time the transmission is, and the reply can't
+    // start before then, so once the transmission is over the echo is either
+    // all there or not there at all
+    return isSent;
+}
+
+bool DaisyChain::receiveStatusPackets(
+    uint8_t* request,
+    size_t requestLen,
+    uint8_t* buf,
+    size_t bufSize,
+    size_t numPackets,
+    StatusPacketHandler handler,
+    void* context
+) const
+{
+    DispatchContext ctx = {handler, context, 0};
+    m_decoder.setHandler(dispatch, &ctx);
+
+    bool success = true;
+    if(!m_isStreaming){
+        // Even if the transfer does not complete (e.g. a motor didn't
+        // respond), the packets that did arrive are still usable
+        m_decoder.reset();
+        success = (request == nullptr) ?
+                  requestReception(buf, bufSize) :
+                  transceive(request, requestLen, buf, bufSize);
+        m_decoder.feed(buf, bufSize);
+    }
+    else if((request != nullptr) && !sendRequest(request, requestLen)){
+        success = false;
+    }
+    else{
+        // The request may still be going out (@see sendRequest)
+        const size_t numBytes = m_echoLen + bufSize;
+        const TickType_t start = uartDriver->getTickCount();
+        do{
+            serviceStream();
+
+            // Decoded in place, straight out of the DMA buffer
+            ReadSpans spans;
+            while((ctx.numAccepted < numPackets) && !echoPending() &&
+                  ((spans = rxBuffer->peekSpans()).first_size != 0))
+            {
+                const size_t n = std::min(spans.first_size, STREAM_CHUNK_SIZE);
+                m_decoder.feed(spans.first, n);
+                rxBuffer->consume(n);
+            }
+        } while((ctx.numAccepted < numPackets) &&
+                uartDriver->waitForStream(start, numBytes));
+    }
+
+    if(m_isStreaming){
+        endRequest(success && (ctx.numAccepted >= numPackets));
+    }
+
+    m_decoder.setHandler(nullptr, nullptr);
+    return success && (ctx.numAccepted >= numPackets);
+}
+
 } // end namespace dynamixel
 
 
@@ -15,6 +15,7 @@
 
 /********************************* Includes **********************************/
 #include "Dynamixel.h"
+#include "DynamixelProtocol.h"
 #include <math.h>
 
 
@@ -25,32 +26,6 @@ namespace{
 // Constants
 // ----------------------------------------------------------------------------
 
-// Instruction set definitions
-// ----------------------------------------------------------------------------
-/** @brief Gets a status packet  */
-constexpr uint8_t INST_PING       = 0x01;
-
-/** @brief Reads data from a motor register */
-constexpr uint8_t INST_READ_DATA  = 0x02;
-
-/** @brief Writes data for immediate execution */
-constexpr uint8_t INST_WRITE_DATA = 0x03;
-
-/** @brief Registers an instruction to be executed at a later time */
-constexpr uint8_t INST_REG_WRITE  = 0x04;
-
-/** @brief Triggers instructions registered by INST_REG_WRITE */
-constexpr uint8_t INST_ACTION     = 0x05;
-
-/** @brief Resets the control tables of the Dynamixel actuator(s) specified */
-constexpr uint8_t INST_RESET      = 0x06;
-
-/**
- * @brief Writes on a specified address with a specified data length on multiple
- *        devices
- */
-constexpr uint8_t INST_SYNC_WRITE = 0x83;
-
 // Register addresses
 // ----------------------------------------------------------------------------
 /** @brief Motor ID register */
@@ -97,9 +72,6 @@ constexpr uint8_t REG_TORQUE_ENABLE       = 0x18;
 /** @brief LED control register */
 constexpr uint8_t REG_LED_ENABLE          = 0x19;
 
-/** @brief Goal position register (0x1E = low byte, 0x1F = high byte) */
-constexpr uint8_t REG_GOAL_POSITION       = 0x1E;
-
 /** @brief Goal torque register (0x22 = low byte, 0x23 = high byte) */
 constexpr uint8_t REG_GOAL_TORQUE         = 0x22;
 
@@ -109,49 +81,120 @@ constexpr uint8_t REG_LOCK_EEPROM         = 0x2F;
 /** @brief Punch (0x30 = low register, 0x31 = high register) */
 constexpr uint8_t REG_PUNCH               = 0x30;
 
-/** @brief Current position register (0x24 = low byte, 0x25 = high byte) */
-constexpr uint8_t REG_CURRENT_POSITION    = 0x24;
-
-/** @brief Current load register (0x28 = low byte, 0x29 = high byte) */
-constexpr uint8_t REG_CURRENT_LOAD        = 0x28;
-
-/** @brief Current voltage register */
-constexpr uint8_t REG_CURRENT_VOLTAGE     = 0x2A;
-
-/** @brief Current temperature register */
-constexpr uint8_t REG_CURRENT_TEMPERATURE = 0x2B;
-
 /** @brief Command execution status register */
 constexpr uint8_t REG_REGISTERED          = 0x2C;
 
 /** @brief Motor motion register */
 constexpr uint8_t REG_MOVING              = 0x2E;
 
+// Other
+// ----------------------------------------------------------------------------
+/** @brief Percentage of the maximum torque per unit of raw load code */
+constexpr float LOAD_PERCENT_PER_TICK = 100.0f / 1023;
 
+/**
+ * @brief The largest number of bytes that can be fetched by one READ DATA
+ *        instruction, limited by our statically-sized receive buffer. This is
+ *        enough to read everything from REG_CURRENT_POSITION to
+ *        REG_CURRENT_TEMPERATURE at once
+ */
+constexpr uint8_t MAX_READ_LENGTH = 8;
 
+/** @brief Number of bytes fetched by Motor::readState */
+constexpr uint8_t JOINT_STATE_LENGTH =
+    dynamixel::REG_CURRENT_TEMPERATURE - dynamixel::REG_CURRENT_POSITION + 1;
 
-// Functions
+static_assert(
+    JOINT_STATE_LENGTH <= MAX_READ_LENGTH,
+    "Joint state must fit in a single READ DATA response"
+);
+
+// Protocol 2.0
 // ----------------------------------------------------------------------------
 /**
- * @brief  Compute the checksum for data passes in, according to a modular
- *         checksum algorithm employed by the Dynamixel V1.0 protocol
- * @param  arr the array to be ran through the checksum function
- * @param  length the total length of the array arr
- * @return The 1-byte number that is the checksum
+ * @brief Location of a Protocol 1.0 register in the Protocol 2.0 control
+ *        table. Only registers whose values are encoded the same way in both
+ *        tables are listed
  */
-static inline uint8_t computeChecksum(uint8_t *arr, size_t length){
-    uint8_t accumulate = 0;
+struct Register2{
+    uint8_t addr1;  /**< Protocol 1.0 address             */
+    uint8_t width1; /**< Width in the Protocol 1.0 table  */
+    uint16_t addr2; /**< Protocol 2.0 address             */
+    uint8_t width2; /**< Width in the Protocol 2.0 table  */
+};
+
+/** @brief The Protocol 1.0 registers that can be accessed over Protocol 2.0 */
+constexpr Register2 REGISTER_MAP2[] = {
+    {REG_ID,                          1,   7,                                1},
+    {REG_RETURN_DELAY_TIME,           1,   9,                                1},
+    {REG_STATUS_RETURN_LEVEL,         1,  68,                                1},
+    {REG_TORQUE_ENABLE,               1,  64,                                1},
+    {REG_LED_ENABLE,                  1,  65,                                1},
+    {dynamixel::REG_GOAL_POSITION,    2,  dynamixel::REG2_GOAL_POSITION,     4},
+    {dynamixel::REG_CURRENT_POSITION, 2,  dynamixel::REG2_CURRENT_POSITION,  4},
+    {dynamixel::REG_CURRENT_TEMPERATURE, 1, 146,                             1},
+    {REG_REGISTERED,                  1,  69,                                1},
+    {REG_MOVING,                      1, 122,                                1}
+};
+
+/** @brief Widest register in REGISTER_MAP2, in the Protocol 2.0 table */
+constexpr uint8_t MAX_REGISTER2_WIDTH = 4;
 
-    /* Loop through the array starting from the 2nd element of the array and
-     * finishing before the last since the last is where the checksum will
-     * be stored */
-    for(uint8_t i = 2; i < length - 1; i++){
-        accumulate += arr[i];
+/**
+ * @brief Looks up the Protocol 2.0 equivalent of a Protocol 1.0 register
+ * @param addr1 The Protocol 1.0 address
+ * @return The register, or nullptr if it has no Protocol 2.0 equivalent
+ */
+const Register2* findRegister2(uint8_t addr1){
+    for(const Register2& reg : REGISTER_MAP2){
+        if(reg.addr1 == addr1){
+            return &reg;
+        }
     }
 
-    return (~accumulate) & 0xFF; // Lower 8 bits of the logical NOT of the sum
+    return nullptr;
 }
 
+// Shadow control table
+// ----------------------------------------------------------------------------
+/**
+ * @brief The registers covered by the shadow control table, by Protocol 1.0
+ *        address. These are the goal registers the motor never changes on
+ *        its own. 0x1A to 0x1D are the compliance margins and slopes on the
+ *        AX12A, and the D, I, and P gains on the MX28. 0x49 is the MX28 goal
+ *        acceleration
+ */
+constexpr uint8_t SHADOWED_REGISTERS[] = {
+    0x1A,
+    0x1B,
+    0x1C,
+    0x1D,
+    dynamixel::REG_GOAL_POSITION,
+    dynamixel::REG_GOAL_VELOCITY,
+    REG_PUNCH,
+    0x49
+};
+
+/** @brief Value returned by findShadowSlot for registers not shadowed */
+constexpr int8_t NO_SHADOW_SLOT = -1;
+
+/**
+ * @brief Looks up where a register is kept in the shadow control table
+ * @param addr The Protocol 1.0 address
+ * @return The slot index, or NO_SHADOW_SLOT if the register is not shadowed
+ */
+int8_t findShadowSlot(uint8_t addr){
+    for(uint8_t i = 0; i < sizeof(SHADOWED_REGISTERS); ++i){
+        if(SHADOWED_REGISTERS[i] == addr){
+            return static_cast<int8_t>(i);
+        }
+    }
+
+    return NO_SHADOW_SLOT;
+}
+
+
+
 } // end anonymous namespace
 
 
@@ -168,9 +211,20 @@ Motor::Motor(
 )
     :
         m_id(id),
-        resolutionDivider(static_cast<uint16_t>(divider)),
+        m_shadowValid(0),
+        m_shadowSkips{0},
+        m_shadowRefreshPeriod(0),
+        m_shadowHits(0),
+        m_shadowMisses(0),
+        m_ticksPerDegree(ticksPerDegree(divider)),
+        m_degreesPerTick(degreesPerTick(divider)),
         daisyChain(daisyChain)
 {
+    static_assert(
+        sizeof(SHADOWED_REGISTERS) == NUM_SHADOW_REGISTERS,
+        "Every shadowed register needs a slot in the shadow control table"
+    );
+
     m_isJointMode = true;
 }
 
@@ -179,6 +233,21 @@ Motor::~Motor(){
 }
 
 bool Motor::reset(){
+    if(daisyChain->getProtocol() == Protocol::V2){
+        // 0xFF resets every value in the control table
+        uint8_t param = 0xFF;
+        uint8_t arr[PACKET2_OVERHEAD + 1];
+        size_t len = buildPacket2(m_id, INST_RESET, &param, 1, arr, sizeof(arr));
+
+        bool success = (len != 0) && daisyChain->requestTransmission(arr, len);
+        if(success){
+            m_id = DEFAULT_ID;
+            invalidateShadow();
+        }
+
+        return success;
+    }
+
     uint8_t arrTransmit[6];
 
     arrTransmit[0] = 0xff;
@@ -195,6 +264,7 @@ bool Motor::reset(){
 
     if(success){
         m_id = DEFAULT_ID;
+        invalidateShadow();
     }
 
     return success;
@@ -233,9 +303,7 @@ bool Motor::setCwAngleLimit(float minAngle) const{
         return false;
     }
 
-    uint16_t normalized_value = static_cast<uint16_t>(
-        minAngle / MAX_ANGLE * resolutionDivider
-    );
+    uint16_t normalized_value = angleToRaw(minAngle);
 
     uint8_t lowByte = static_cast<uint8_t>(normalized_value & 0xFF);
     uint8_t highByte = static_cast<uint8_t>((normalized_value >> 8) & 0xFF);
@@ -250,9 +318,7 @@ bool Motor::setCcwAngleLimit(float maxAngle) const{
         return false;
     }
 
-    uint16_t normalized_value = static_cast<uint16_t>(
-            maxAngle / MAX_ANGLE * resolutionDivider
-    );
+    uint16_t normalized_value = angleToRaw(maxAngle);
 
     uint8_t lowByte = static_cast<uint8_t>(normalized_value & 0xFF);
     uint8_t highByte = static_cast<uint8_t>((normalized_value >> 8) & 0xFF);
@@ -356,9 +422,7 @@ bool Motor::setGoalPosition(float goalAngle) const{
 
     // Translate the angle from degrees into a binary code with the resolution
     // selected at construction
-    uint16_t normalized_value = static_cast<uint16_t>(
-        (goalAngle / MAX_ANGLE) * resolutionDivider
-    );
+    uint16_t normalized_value = angleToRaw(goalAngle);
 
     uint8_t lowByte = static_cast<uint8_t>(normalized_value & 0xFF);
     uint8_t highByte = static_cast<uint8_t>((normalized_value >> 8) & 0xFF);
@@ -368,6 +432,21 @@ bool Motor::setGoalPosition(float goalAngle) const{
     return dataWriter(args, sizeof(args));
 }
 
+bool Motor::stageGoalPosition(float goalAngle) const{
+    if((goalAngle < MIN_ANGLE) || (goalAngle > MAX_ANGLE)){
+        return false;
+    }
+
+    uint16_t normalized_value = angleToRaw(goalAngle);
+
+    uint8_t lowByte = static_cast<uint8_t>(normalized_value & 0xFF);
+    uint8_t highByte = static_cast<uint8_t>((normalized_value >> 8) & 0xFF);
+
+    // Register data in motor; it is applied upon ACTION
+    uint8_t args[3] = {REG_GOAL_POSITION, lowByte, highByte};
+    return regWriter(args, sizeof(args));
+}
+
 bool Motor::setGoalTorque(float goalTorque) const{
     if((goalTorque < 0) || (goalTorque > 100.0)){
         return false;
@@ -415,7 +494,7 @@ bool Motor::getPosition(float& retVal) const{
 
     // Parse data and write it into R-val
     if(success){
-        retVal = (raw * MAX_ANGLE / resolutionDivider);
+        retVal = rawToAngle(raw);
     }
 
     return success;
@@ -428,15 +507,7 @@ bool Motor::getLoad(float& retVal) const{
 
     // Parse data and write it into R-val
     if(success){
-        bool isNegative = static_cast<bool>((raw >> 9) & 0x1);
-        if(raw > 1023){
-            raw = raw - 1023;
-        }
-
-        float retVal = (float)(raw / 1023.0 * 100.0);
-        if(isNegative){
-            retVal *= -1;
-        }
+        retVal = rawToLoad(raw);
     }
 
     return success;
@@ -466,6 +537,46 @@ bool Motor::getTemperature(uint8_t& retVal) const{
     return success;
 }
 
+bool Motor::getReturnDelayTime(uint16_t& retVal) const{
+    uint16_t raw = 0;
+    bool success = dataReader(REG_RETURN_DELAY_TIME, 1, raw);
+
+    if(success){
+        retVal = raw << 1;
+    }
+
+    return success;
+}
+
+bool Motor::readState(JointState& retVal) const{
+    // Read data from motor
+    uint8_t raw[JOINT_STATE_LENGTH];
+    bool success = dataBlockReader(
+        REG_CURRENT_POSITION,
+        JOINT_STATE_LENGTH,
+        raw
+    );
+
+    // Parse data and write it into R-val. Offsets are relative to
+    // REG_CURRENT_POSITION
+    if(success){
+        auto word = [&raw](uint8_t reg) -> uint16_t {
+            uint8_t offset = reg - REG_CURRENT_POSITION;
+            return raw[offset] | (raw[offset + 1] << 8);
+        };
+
+        retVal.position = rawToAngle(word(REG_CURRENT_POSITION));
+        retVal.velocity = rawToVelocity(word(REG_CURRENT_VELOCITY));
+        retVal.load = rawToLoad(word(REG_CURRENT_LOAD));
+        retVal.voltage =
+            raw[REG_CURRENT_VOLTAGE - REG_CURRENT_POSITION] / 10.0f;
+        retVal.temperature =
+            raw[REG_CURRENT_TEMPERATURE - REG_CURRENT_POSITION];
+    }
+
+    return success;
+}
+
 bool Motor::isJointMode(bool& retVal){
     // Read data from motor
     uint16_t retValCW;
@@ -489,6 +600,39 @@ bool Motor::isJointMode(bool& retVal){
 }
 
 bool Motor::ping(uint8_t& retVal) const{
+    if(daisyChain->getProtocol() == Protocol::V2){
+        // The status packet holds the model number (2 bytes) and firmware
+        // version
+        constexpr size_t PING2_PARAMS = 3;
+        uint8_t arrTransmit[PACKET2_OVERHEAD];
+        size_t len = buildPacket2(
+            m_id,
+            INST_PING,
+            nullptr,
+            0,
+            arrTransmit,
+            sizeof(arrTransmit)
+        );
+
+        uint8_t arrReceive[STATUS_PACKET2_OVERHEAD + PING2_PARAMS] = {0};
+        StatusPacket packet;
+        if((len == 0) ||
+           !daisyChain->transceiveStatusPacket(
+               arrTransmit,
+               len,
+               m_id,
+               arrReceive,
+               sizeof(arrReceive),
+               packet
+           ))
+        {
+            return false;
+        }
+
+        retVal = packet.id;
+        return true;
+    }
+
     uint8_t arrTransmit[6];
 
     arrTransmit[0] = 0xff;
@@ -498,24 +642,20 @@ bool Motor::ping(uint8_t& retVal) const{
     arrTransmit[4] = INST_PING;
     arrTransmit[5] = computeChecksum(arrTransmit, 6);
 
-    // Transmit read request
-    bool success = daisyChain->requestTransmission(
-        arrTransmit,
-        sizeof(arrTransmit)
-    );
-
-    if(!success){
-        return false;
-    }
-
-    // Receive requested data
-    success = daisyChain->requestReception(
+    // Transmit ping and receive the reply, which is the same size
+    uint8_t arrReceive[sizeof(arrTransmit)] = {0};
+    StatusPacket packet;
+    bool success = daisyChain->transceiveStatusPacket(
         arrTransmit,
-        sizeof(arrTransmit)
+        sizeof(arrTransmit),
+        m_id,
+        arrReceive,
+        sizeof(arrReceive),
+        packet
     );
 
     if(success){
-        retVal = arrTransmit[2];
+        retVal = packet.id;
     }
 
     return success;
@@ -564,6 +704,25 @@ bool Motor::enterJointMode(){
     return success;
 }
 
+void Motor::setShadowRefreshPeriod(uint16_t period){
+    m_shadowRefreshPeriod = period;
+}
+
+void Motor::invalidateShadow() const{
+    m_shadowValid = 0;
+    for(uint8_t i = 0; i < NUM_SHADOW_REGISTERS; ++i){
+        m_shadowSkips[i] = 0;
+    }
+}
+
+uint32_t Motor::getShadowHits() const{
+    return m_shadowHits;
+}
+
+uint32_t Motor::getShadowMisses() const{
+    return m_shadowMisses;
+}
+
 
 
 
@@ -573,6 +732,197 @@ bool Motor::dataWriter(
     uint8_t* args,
     size_t numArgs
 )  const
+{
+    return instructionWriter(INST_WRITE_DATA, args, numArgs);
+}
+
+bool Motor::regWriter(
+    uint8_t* args,
+    size_t numArgs
+)  const
+{
+    return instructionWriter(INST_REG_WRITE, args, numArgs);
+}
+
+bool Motor::dataReader(
+    uint8_t readAddr,
+    uint8_t readLength,
+    uint16_t& retVal
+) const
+{
+    // Values wider than 2 bytes don't fit in retVal; these should be read
+    // with dataBlockReader instead
+    if(readLength > 2){
+        return false;
+    }
+
+    uint8_t raw[2];
+    bool success = dataBlockReader(readAddr, readLength, raw);
+
+    if(success){
+        retVal = (uint16_t)raw[0];
+        if(readLength == 2){
+            retVal |= (raw[1] << 8);
+        }
+    }
+
+    return success;
+}
+
+bool Motor::dataBlockReader(
+    uint8_t readAddr,
+    uint8_t readLength,
+    uint8_t* retBuf
+) const
+{
+    if(daisyChain->getProtocol() == Protocol::V2){
+        return dataBlockReader2(readAddr, readLength, retBuf);
+    }
+
+    // Check validity so that we don't accidentally make a read request that is
+    // invalid or we cannot support due to our implementation.
+    // Since we cannot dynamically allocate an array to hold all the returned
+    // data, the receive buffer is sized for MAX_READ_LENGTH bytes of data,
+    // which is enough to read the whole joint state at once
+    if((readLength == 0) || (readLength > MAX_READ_LENGTH)){
+        return false;
+    }
+
+    uint8_t arrTransmit[8];
+
+    arrTransmit[0] = 0xFF;
+    arrTransmit[1] = 0xFF;
+    arrTransmit[2] = m_id;
+    arrTransmit[3] = 4;
+    arrTransmit[4] = INST_READ_DATA;
+    arrTransmit[5] = readAddr;
+    arrTransmit[6] = readLength;
+    arrTransmit[7] = computeChecksum(arrTransmit, 8);
+
+    // Transmit read request and receive requested data. Its integrity is
+    // checked on the way in
+    uint8_t arrReceive[STATUS_PACKET_OVERHEAD + MAX_READ_LENGTH] = {0};
+    size_t rxPacketSize = STATUS_PACKET_OVERHEAD + readLength;
+    StatusPacket packet;
+    if(!daisyChain->transceiveStatusPacket(
+           arrTransmit,
+           sizeof(arrTransmit),
+           m_id,
+           arrReceive,
+           rxPacketSize,
+           packet
+       ) ||
+       (packet.numParams != readLength))
+    {
+        return false;
+    }
+
+    for(uint8_t i = 0; i < readLength; ++i){
+        retBuf[i] = packet.params[i];
+    }
+
+    return true;
+}
+
+
+
+
+// Private
+// ----------------------------------------------------------------------------
+uint16_t Motor::angleToRaw(float angle) const{
+    return static_cast<uint16_t>(angle * m_ticksPerDegree);
+}
+
+float Motor::rawToAngle(uint16_t raw) const{
+    return raw * m_degreesPerTick;
+}
+
+bool Motor::shadowMatches(uint8_t addr, uint16_t value) const{
+    int8_t slot = findShadowSlot(addr);
+    if(slot == NO_SHADOW_SLOT){
+        return false;
+    }
+
+    bool isHit = ((m_shadowValid >> slot) & 1) && (m_shadow[slot] == value);
+    if(isHit && (m_shadowRefreshPeriod != 0) &&
+       (m_shadowSkips[slot] >= m_shadowRefreshPeriod))
+    {
+        // Force this one through so the motor gets a fresh copy
+        isHit = false;
+    }
+
+    if(isHit){
+        ++m_shadowHits;
+        ++m_shadowSkips[slot];
+    }
+    else{
+        ++m_shadowMisses;
+    }
+
+    return isHit;
+}
+
+void Motor::shadowStore(uint8_t addr, uint16_t value, bool wasSent) const{
+    int8_t slot = findShadowSlot(addr);
+    if(slot == NO_SHADOW_SLOT){
+        return;
+    }
+
+    if(wasSent){
+        m_shadow[slot] = value;
+        m_shadowValid |= (1 << slot);
+        m_shadowSkips[slot] = 0;
+    }
+    else{
+        m_shadowValid &= ~(1 << slot);
+    }
+}
+
+void Motor::shadowForget(uint8_t addr) const{
+    shadowStore(addr, 0, false);
+}
+
+bool Motor::instructionWriter(
+    uint8_t instruction,
+    uint8_t* args,
+    size_t numArgs
+)  const
+{
+    // Skip writes that would not change what the motor already holds. This
+    // applies to REG_WRITE as well, since a motor with nothing registered
+    // simply ignores the ACTION that follows
+    uint16_t value = 0;
+    if((numArgs == 2) || (numArgs == 3)){
+        value = args[1];
+        if(numArgs == 3){
+            value |= (args[2] << 8);
+        }
+
+        if(shadowMatches(args[0], value)){
+            return true;
+        }
+    }
+
+    bool success = false;
+    if(daisyChain->getProtocol() == Protocol::V2){
+        success = instructionWriter2(instruction, args, numArgs);
+    }
+    else{
+        success = instructionWriter1(instruction, args, numArgs);
+    }
+
+    if((numArgs == 2) || (numArgs == 3)){
+        shadowStore(args[0], value, success);
+    }
+
+    return success;
+}
+
+bool Motor::instructionWriter1(
+    uint8_t instruction,
+    uint8_t* args,
+    size_t numArgs
+)  const
 {
     // Check validity so that we don't accidentally make a read request that is
     // invalid or we cannot support due to our implementation.
@@ -589,7 +939,7 @@ bool Motor::dataWriter(
     arrTransmit[1] = 0xFF;
     arrTransmit[2] = m_id;
     arrTransmit[3] = 2 + numArgs;
-    arrTransmit[4] = INST_WRITE_DATA;
+    arrTransmit[4] = instruction;
 
     for(uint8_t i = 0; i < numArgs; i ++){
         arrTransmit[5 + i] = args[i];
@@ -605,64 +955,108 @@ bool Motor::dataWriter(
     return daisyChain->requestTransmission(arrTransmit, 4 + numArgs + 2);
 }
 
-bool Motor::dataReader(
-    uint8_t readAddr,
-    uint8_t readLength,
-    uint16_t& retVal
-) const
+bool Motor::instructionWriter2(
+    uint8_t instruction,
+    uint8_t* args,
+    size_t numArgs
+)  const
 {
-    // Check validity so that we don't accidentally make a read request that is
-    // invalid or we cannot support due to our implementation.
-    // Since we cannot dynamically allocate an array to hold all the returned
-    // data, we chose 2 as the cutoff. This supports our use cases just fine,
-    // but in the future it could be tweaked if need be
-    if(readLength > 2){
+    if((numArgs < 2) || (numArgs > 3)){
         return false;
     }
 
-    uint8_t arr[8];
-
-    arr[0] = 0xFF;
-    arr[1] = 0xFF;
-    arr[2] = m_id;
-    arr[3] = 4;
-    arr[4] = INST_READ_DATA;
-    arr[5] = readAddr;
-    arr[6] = readLength;
-    arr[7] = computeChecksum(arr, 8);
-
-    // Transmit read request
-    if(!daisyChain->requestTransmission(arr, 8)){
+    const Register2* reg = findRegister2(args[0]);
+    if((reg == nullptr) || (numArgs - 1 != reg->width1)){
         return false;
     }
 
-    // Receive requested data
-    uint8_t rxPacketSize = (readLength == 1) ? 7 : 8;
-    if(!daisyChain->requestReception(arr, rxPacketSize)){
-        return false;
+    // Parameters are the 2-byte address followed by the data, zero-extended
+    // to the width of the Protocol 2.0 register
+    uint8_t params[2 + MAX_REGISTER2_WIDTH];
+    params[0] = static_cast<uint8_t>(reg->addr2 & 0xFF);
+    params[1] = static_cast<uint8_t>((reg->addr2 >> 8) & 0xFF);
+    for(uint8_t i = 0; i < reg->width2; ++i){
+        params[2 + i] = (i < reg->width1) ? args[1 + i] : 0;
     }
 
-    // Check data integrity before passing data to application
-    uint8_t recvChecksum = arr[rxPacketSize - 1];
-    uint8_t computedChecksum = computeChecksum(arr, rxPacketSize);
-    bool success = (computedChecksum == recvChecksum);
+    uint8_t arr[PACKET2_OVERHEAD + maxStuffedSize(sizeof(params))];
+    size_t len = buildPacket2(
+        m_id,
+        instruction,
+        params,
+        2 + reg->width2,
+        arr,
+        sizeof(arr)
+    );
 
-    if(success){
-        retVal = (uint16_t)arr[5];
-        if(readLength == 2){
-            retVal |= (arr[6] << 8);
-        }
+    return (len != 0) && daisyChain->requestTransmission(arr, len);
+}
+
+bool Motor::dataBlockReader2(
+    uint8_t readAddr,
+    uint8_t readLength,
+    uint8_t* retBuf
+) const
+{
+    const Register2* reg = findRegister2(readAddr);
+    if((reg == nullptr) || (readLength != reg->width1)){
+        return false;
     }
 
-    return success;
-}
+    uint8_t params[4] = {
+        static_cast<uint8_t>(reg->addr2 & 0xFF),
+        static_cast<uint8_t>((reg->addr2 >> 8) & 0xFF),
+        reg->width2,
+        0x00
+    };
+
+    uint8_t arrTransmit[PACKET2_OVERHEAD + maxStuffedSize(sizeof(params))];
+    size_t len = buildPacket2(
+        m_id,
+        INST_READ_DATA,
+        params,
+        sizeof(params),
+        arrTransmit,
+        sizeof(arrTransmit)
+    );
 
+    // Transmit read request and receive requested data. Without streaming, a
+    // reply that needed byte stuffing is longer than this and will fail the
+    // CRC check; this cannot happen for any of the registers in
+    // REGISTER_MAP2 since their values never contain 0xFF 0xFF
+    uint8_t arrReceive[STATUS_PACKET2_OVERHEAD + MAX_REGISTER2_WIDTH] = {0};
+    size_t rxPacketSize = STATUS_PACKET2_OVERHEAD + reg->width2;
+    StatusPacket packet;
+    if((len == 0) ||
+       !daisyChain->transceiveStatusPacket(
+           arrTransmit,
+           len,
+           m_id,
+           arrReceive,
+           rxPacketSize,
+           packet
+       ) ||
+       (packet.numParams != reg->width2))
+    {
+        return false;
+    }
 
+    for(uint8_t i = 0; i < readLength; ++i){
+        retBuf[i] = packet.params[i];
+    }
 
+    return true;
+}
 
-// Private
-// ----------------------------------------------------------------------------
+float Motor::rawToLoad(uint16_t raw) const{
+    // Bits 0-9 hold the magnitude, and bit 10 is set for CW loads
+    float retVal = (raw & 0x3FF) * LOAD_PERCENT_PER_TICK;
+    if(raw & 0x400){
+        retVal *= -1;
+    }
 
+    return retVal;
+}
 
 }
 
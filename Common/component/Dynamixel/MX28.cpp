@@ -55,7 +55,7 @@ MX28::MX28(
     uint8_t id,
     DaisyChain* daisyChain
 )
-    :   Motor(id, daisyChain, ResolutionDivider::MX28)
+    :   MotorT(id, daisyChain)
 {
 
 }
@@ -90,49 +90,6 @@ bool MX28::setBaudRate(uint32_t baud) const{
     return dataWriter(args, sizeof(args));
 }
 
-bool MX28::setGoalVelocity(float goalVelocity) const{
-    if(m_isJointMode){
-        if((goalVelocity < MIN_VELOCITY) || (goalVelocity > MX28_MAX_VELOCITY)){
-            return false;
-        }
-    }
-
-    uint16_t normalized_value;
-    if(goalVelocity > 0){
-        normalized_value = static_cast<uint8_t>(
-            goalVelocity / MX28_MAX_VELOCITY * 1023
-        );
-    }
-    else{
-        normalized_value = static_cast<uint16_t>(
-            (goalVelocity * -1) / MX28_MAX_VELOCITY * 1023
-        );
-
-        normalized_value |= 0b000010000000000;
-    }
-
-    uint8_t lowByte = static_cast<uint8_t>(normalized_value & 0xFF);
-    uint8_t highByte = static_cast<uint8_t>((normalized_value >> 8) & 0xFF);
-
-    // Write data to motor
-    uint8_t args[3] = {REG_GOAL_VELOCITY, lowByte, highByte};
-    return dataWriter(args, sizeof(args));
-}
-
-bool MX28::getVelocity(float& retVal) const{
-    uint16_t raw = 0;
-    bool success = dataReader(REG_CURRENT_VELOCITY, 2, raw);
-
-    if(!success){
-        return false;
-    }
-
-    uint16_t modifier = m_isJointMode ? 1023 : 2047;
-    retVal = static_cast<float>(raw / modifier * MX28_MAX_VELOCITY);
-
-    return success;
-}
-
 bool MX28::setGoalAcceleration(float goalAcceleration) const{
     if((goalAcceleration > 2180) || (goalAcceleration < 0)){
         return false;
@@ -0,0 +1,913 @@
+/**
+  *****************************************************************************
+  * @file   MotorGroup.cpp
+  * @author Tyler Gamvrelis
+  *
+  * @ingroup MotorGroup
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "MotorGroup.h"
+#include "DynamixelProtocol.h"
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief The largest number of bytes written to each motor by a single sync
+ *        write. Goal position is 2 bytes; this leaves room for goal position
+ *        and goal velocity to be written together
+ */
+constexpr size_t MAX_SYNC_WRITE_DATA_LEN = 4;
+
+/** @brief Number of bytes in a SYNC_WRITE packet besides the motor data */
+constexpr size_t SYNC_WRITE_OVERHEAD = 8;
+
+/** @brief Number of bytes in a Protocol 1.0 READ_DATA packet */
+constexpr size_t READ_DATA_PACKET_SIZE = 8;
+
+/**
+ * @brief Bus time lost by each read besides the bytes exchanged, in
+ *        microseconds. Covers the default return delay time (100 us) and the
+ *        turnaround of the bus on both ends
+ */
+constexpr uint32_t READ_OVERHEAD_US = 120;
+
+/** @brief Bits on the wire per byte (start bit, 8 data bits, stop bit) */
+constexpr uint32_t BITS_PER_BYTE = 10;
+
+/** @brief Number of bytes in a BULK_READ packet besides the motor entries */
+constexpr size_t BULK_READ_OVERHEAD = 7;
+
+/**
+ * @brief Number of bytes in a Protocol 2.0 FAST_SYNC_READ status packet
+ *        before the first motor's entry (4 header bytes, ID, 2 LENGTH bytes,
+ *        INSTRUCTION). Each entry is then ERROR, ID, the data, and 2 CRC bytes
+ */
+constexpr size_t FAST_SYNC_READ_HEADER_SIZE = 8;
+
+/** @brief Number of bytes in a FAST_SYNC_READ entry besides the data */
+constexpr size_t FAST_SYNC_READ_ENTRY_OVERHEAD = 4;
+
+/** @brief Number of bytes in a position register (Protocol 2.0) */
+constexpr uint8_t POSITION2_WIDTH = 4;
+
+/**
+ * @brief Baud rates tried during negotiation, slowest first. Each one has an
+ *        exact code in the baud rate register of the motors that support it
+ */
+constexpr uint32_t NEGOTIATED_BAUD_RATES[] = {
+    1000000,
+    2000000,
+    2250000,
+    2500000,
+    3000000
+};
+
+/**
+ * @brief Number of times a motor is pinged before it is considered not to be
+ *        responding. Motors may miss the first ping right after switching
+ *        baud rates
+ */
+constexpr uint8_t PING_ATTEMPTS = 3;
+
+
+
+
+// Types & enums
+// ----------------------------------------------------------------------------
+/** @brief The Protocol 1.0 register holding a telemetry quantity */
+struct TelemetryRegister{
+    uint8_t addr;  /**< Address of the register */
+    uint8_t width; /**< Width of the register   */
+};
+
+/** @brief The register holding each quantity, indexed by Telemetry */
+constexpr TelemetryRegister TELEMETRY_REGISTERS[] = {
+    {dynamixel::REG_CURRENT_POSITION,    2},
+    {dynamixel::REG_CURRENT_LOAD,        2},
+    {dynamixel::REG_CURRENT_VOLTAGE,     1},
+    {dynamixel::REG_CURRENT_TEMPERATURE, 1}
+};
+
+static_assert(
+    sizeof(TELEMETRY_REGISTERS) / sizeof(TELEMETRY_REGISTERS[0]) ==
+        dynamixel::NUM_TELEMETRY,
+    "Every telemetry quantity needs a register"
+);
+
+/**
+ * @brief Passed to acceptReading by the group readers that receive one
+ *        status packet per motor
+ */
+template<typename T>
+struct ReadingContext{
+    const std::array<dynamixel::Motor*, dynamixel::MAX_GROUP_SIZE>& motors;
+    size_t numMotors;
+    uint8_t readLength;
+    T* retVals;
+    bool* isValid;
+};
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/**
+ * @brief Stores the reading in a status packet for the motor in the group
+ *        that sent it. @see dynamixel::StatusPacketHandler
+ */
+template<typename T>
+bool acceptReading(const dynamixel::StatusPacket& packet, void* context){
+    ReadingContext<T>* ctx = static_cast<ReadingContext<T>*>(context);
+    if(packet.numParams != ctx->readLength){
+        return false;
+    }
+
+    for(size_t i = 0; i < ctx->numMotors; ++i){
+        if((ctx->motors[i]->id() != packet.id) || ctx->isValid[i]){
+            continue;
+        }
+
+        T val = 0;
+        for(uint8_t j = 0; j < ctx->readLength; ++j){
+            val |= static_cast<T>(packet.params[j]) << (8 * j);
+        }
+
+        ctx->retVals[i] = val;
+        ctx->isValid[i] = true;
+        return true;
+    }
+
+    return false;
+}
+
+} // end anonymous namespace
+
+
+
+
+namespace dynamixel{
+/******************************** MotorGroup *********************************/
+// Public
+// ----------------------------------------------------------------------------
+MotorGroup::MotorGroup(
+    DaisyChain* daisyChain,
+    std::initializer_list<Motor*> motors
+)
+    :
+        daisyChain(daisyChain),
+        m_numMotors(0),
+        m_supportsBulkRead(true),
+        m_useFastSyncRead(true),
+        m_actionPending(false)
+{
+    for(Motor* m : motors){
+        if(m_numMotors >= MAX_GROUP_SIZE){
+            break;
+        }
+
+        if((m != nullptr) && (m->daisyChain == daisyChain)){
+            m_motors[m_numMotors++] = m;
+            m_supportsBulkRead &= m->supportsBulkRead();
+        }
+    }
+}
+
+MotorGroup::~MotorGroup(){
+
+}
+
+size_t MotorGroup::size() const{
+    return m_numMotors;
+}
+
+Motor* MotorGroup::motor(size_t idx) const{
+    return (idx < m_numMotors) ? m_motors[idx] : nullptr;
+}
+
+bool MotorGroup::setGoalPositions(
+    const float* goalAngles,
+    size_t numAngles
+) const
+{
+    if((goalAngles == nullptr) || (numAngles != m_numMotors) ||
+       (m_numMotors == 0))
+    {
+        return false;
+    }
+
+    // The goal position register is 2 bytes wide in the Protocol 1.0 control
+    // table, and 4 bytes wide in the Protocol 2.0 control table
+    const bool isV2 = (daisyChain->getProtocol() == Protocol::V2);
+    const uint8_t width = isV2 ? POSITION2_WIDTH : 2;
+
+    // Translate each angle from degrees into a binary code with the
+    // resolution of the motor it is destined for
+    uint8_t data[MAX_GROUP_SIZE * MAX_SYNC_WRITE_DATA_LEN] = {0};
+    uint16_t raw[MAX_GROUP_SIZE];
+    for(size_t i = 0; i < m_numMotors; ++i){
+        if((goalAngles[i] < MIN_ANGLE) || (goalAngles[i] > MAX_ANGLE)){
+            return false;
+        }
+
+        raw[i] = m_motors[i]->angleToRaw(goalAngles[i]);
+
+        data[width * i] = static_cast<uint8_t>(raw[i] & 0xFF);
+        data[width * i + 1] = static_cast<uint8_t>((raw[i] >> 8) & 0xFF);
+    }
+
+    // Leave out the motors that already have these goals
+    bool isIncluded[MAX_GROUP_SIZE];
+    bool isAnyIncluded = false;
+    for(size_t i = 0; i < m_numMotors; ++i){
+        isIncluded[i] = !m_motors[i]->shadowMatches(REG_GOAL_POSITION, raw[i]);
+        isAnyIncluded |= isIncluded[i];
+    }
+
+    if(!isAnyIncluded){
+        return true;
+    }
+
+    bool success = syncWriter(
+        isV2 ? REG2_GOAL_POSITION : REG_GOAL_POSITION,
+        width,
+        data,
+        isIncluded
+    );
+
+    for(size_t i = 0; i < m_numMotors; ++i){
+        if(isIncluded[i]){
+            m_motors[i]->shadowStore(REG_GOAL_POSITION, raw[i], success);
+        }
+    }
+
+    return success;
+}
+
+bool MotorGroup::stageGoalPositions(
+    const float* goalAngles,
+    size_t numAngles
+) const
+{
+    if((goalAngles == nullptr) || (numAngles != m_numMotors) ||
+       (m_numMotors == 0))
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < m_numMotors; ++i){
+        if((goalAngles[i] < MIN_ANGLE) || (goalAngles[i] > MAX_ANGLE)){
+            return false;
+        }
+    }
+
+    // Neither protocol has a synchronized form of REG_WRITE, so each motor
+    // gets its own packet. This is fine since the motors only start moving upon
+    // ACTION anyway
+    bool success = true;
+    for(size_t i = 0; i < m_numMotors; ++i){
+        success &= m_motors[i]->stageGoalPosition(goalAngles[i]);
+    }
+
+    // Even if some motors didn't register their goals, the others did
+    m_actionPending = true;
+
+    return success;
+}
+
+bool MotorGroup::action() const{
+    // Cleared even upon failure, since the goals are forgotten then and the
+    // chain would otherwise never be read again
+    m_actionPending = false;
+
+    bool success = false;
+    if(daisyChain->getProtocol() == Protocol::V2){
+        uint8_t arr[PACKET2_OVERHEAD];
+        size_t len = buildPacket2(
+            BROADCAST_ID,
+            INST_ACTION,
+            nullptr,
+            0,
+            arr,
+            sizeof(arr)
+        );
+
+        success = (len != 0) && daisyChain->requestTransmission(arr, len);
+    }
+    else{
+        uint8_t arrTransmit[6];
+
+        arrTransmit[0] = PACKET_HEADER_BYTE;
+        arrTransmit[1] = PACKET_HEADER_BYTE;
+        arrTransmit[2] = BROADCAST_ID;
+        arrTransmit[3] = 2;
+        arrTransmit[4] = INST_ACTION;
+        arrTransmit[5] = computeChecksum(arrTransmit, sizeof(arrTransmit));
+
+        success = daisyChain->requestTransmission(
+            arrTransmit,
+            sizeof(arrTransmit)
+        );
+    }
+
+    if(!success){
+        // The staged goals were shadowed as though they had been applied,
+        // but the motors may still hold the previous ones
+        for(size_t i = 0; i < m_numMotors; ++i){
+            m_motors[i]->shadowForget(REG_GOAL_POSITION);
+        }
+    }
+
+    return success;
+}
+
+bool MotorGroup::isActionPending() const{
+    return m_actionPending;
+}
+
+bool MotorGroup::getPositions(
+    float* retVals,
+    bool* isValid,
+    size_t numVals
+) const
+{
+    if((retVals == nullptr) || (isValid == nullptr) ||
+       (numVals != m_numMotors) || (m_numMotors == 0))
+    {
+        return false;
+    }
+
+    bool success = true;
+    if(daisyChain->getProtocol() == Protocol::V2){
+        uint32_t raw[MAX_GROUP_SIZE];
+        success = syncReader2(
+            REG2_CURRENT_POSITION,
+            POSITION2_WIDTH,
+            raw,
+            isValid
+        );
+
+        for(size_t i = 0; i < m_numMotors; ++i){
+            if(isValid[i]){
+                retVals[i] = m_motors[i]->rawToAngle(
+                    static_cast<uint16_t>(raw[i])
+                );
+            }
+        }
+    }
+    else if(m_supportsBulkRead){
+        uint16_t raw[MAX_GROUP_SIZE];
+        success = bulkReader(REG_CURRENT_POSITION, 2, raw, isValid);
+
+        for(size_t i = 0; i < m_numMotors; ++i){
+            if(isValid[i]){
+                retVals[i] = m_motors[i]->rawToAngle(raw[i]);
+            }
+        }
+    }
+    else{
+        for(size_t i = 0; i < m_numMotors; ++i){
+            isValid[i] = m_motors[i]->getPosition(retVals[i]);
+            success &= isValid[i];
+        }
+    }
+
+    return success;
+}
+
+bool MotorGroup::readTelemetry(TelemetryRead* reads, size_t numReads) const{
+    if((reads == nullptr) || (numReads > MAX_TELEMETRY_READS)){
+        return false;
+    }
+
+    for(size_t i = 0; i < numReads; ++i){
+        reads[i].isValid = false;
+    }
+
+    // Find out whether every motor's position is asked for, in which case
+    // they are all read at once
+    int8_t positionRead[MAX_GROUP_SIZE];
+    size_t numPositions = 0;
+    for(size_t i = 0; i < m_numMotors; ++i){
+        positionRead[i] = -1;
+    }
+    for(size_t i = 0; i < numReads; ++i){
+        if((reads[i].item == Telemetry::POSITION) &&
+           (reads[i].motorIdx < m_numMotors) &&
+           (positionRead[reads[i].motorIdx] < 0))
+        {
+            positionRead[reads[i].motorIdx] = static_cast<int8_t>(i);
+            ++numPositions;
+        }
+    }
+
+    bool success = true;
+    const bool readPositionsTogether =
+        (numPositions == m_numMotors) && (m_numMotors != 0);
+    if(readPositionsTogether){
+        float positions[MAX_GROUP_SIZE];
+        bool isValid[MAX_GROUP_SIZE];
+        success = getPositions(positions, isValid, m_numMotors);
+
+        for(size_t i = 0; i < m_numMotors; ++i){
+            TelemetryRead& read = reads[positionRead[i]];
+            read.value = positions[i];
+            read.isValid = isValid[i];
+        }
+    }
+
+    // Everything else is read one register at a time
+    RegisterRead regReads[MAX_TELEMETRY_READS];
+    size_t readIdx[MAX_TELEMETRY_READS];
+    size_t numRegReads = 0;
+    for(size_t i = 0; i < numReads; ++i){
+        const TelemetryRead& read = reads[i];
+        if(readPositionsTogether && (read.item == Telemetry::POSITION)){
+            continue;
+        }
+
+        if((read.motorIdx >= m_numMotors) ||
+           (read.item >= Telemetry::NUM_TELEMETRY))
+        {
+            success = false;
+            continue;
+        }
+
+        const TelemetryRegister& reg =
+            TELEMETRY_REGISTERS[static_cast<size_t>(read.item)];
+        regReads[numRegReads].motorIdx = read.motorIdx;
+        regReads[numRegReads].addr = reg.addr;
+        regReads[numRegReads].length = reg.width;
+        readIdx[numRegReads] = i;
+        ++numRegReads;
+    }
+
+    if(numRegReads == 0){
+        return success;
+    }
+
+    for(size_t i = 0; i < numRegReads; ++i){
+        RegisterRead& regRead = regReads[i];
+        regRead.isValid = m_motors[regRead.motorIdx]->dataReader(
+            regRead.addr,
+            regRead.length,
+            regRead.value
+        );
+        success &= regRead.isValid;
+    }
+
+    for(size_t i = 0; i < numRegReads; ++i){
+        TelemetryRead& read = reads[readIdx[i]];
+        read.isValid = regReads[i].isValid;
+        if(read.isValid){
+            read.value = decodeTelemetry(
+                read.motorIdx,
+                read.item,
+                regReads[i].value
+            );
+        }
+    }
+
+    return success;
+}
+
+uint32_t MotorGroup::estimateReadTime(Telemetry item) const{
+    const uint32_t baud = daisyChain->getBaudRate();
+    if((baud == 0) || (item >= Telemetry::NUM_TELEMETRY)){
+        return READ_OVERHEAD_US;
+    }
+
+    const size_t width = TELEMETRY_REGISTERS[static_cast<size_t>(item)].width;
+    size_t numBytes = READ_DATA_PACKET_SIZE + STATUS_PACKET_OVERHEAD + width;
+    if(daisyChain->getProtocol() == Protocol::V2){
+        // 4-byte address and length parameters in the request
+        numBytes = PACKET2_OVERHEAD + 4 + STATUS_PACKET2_OVERHEAD + width;
+    }
+
+    const uint64_t numBits = static_cast<uint64_t>(numBytes) * BITS_PER_BYTE;
+    return static_cast<uint32_t>((numBits * 1000000 + baud - 1) / baud) +
+           READ_OVERHEAD_US;
+}
+
+bool MotorGroup::usesBulkRead() const{
+    return m_supportsBulkRead &&
+           (daisyChain->getProtocol() == Protocol::V1);
+}
+
+void MotorGroup::useFastSyncRead(bool enable){
+    m_useFastSyncRead = enable;
+}
+
+bool MotorGroup::waitUntilReady(uint16_t maxRounds) const{
+    bool isReady[MAX_GROUP_SIZE] = {false};
+    size_t numReady = 0;
+    for(uint16_t round = 0;
+        (round < maxRounds) && (numReady < m_numMotors);
+        ++round)
+    {
+        for(size_t i = 0; i < m_numMotors; ++i){
+            if(isReady[i]){
+                continue;
+            }
+
+            uint8_t id = 0;
+            if(m_motors[i]->ping(id) && (id == m_motors[i]->id())){
+                isReady[i] = true;
+                ++numReady;
+            }
+        }
+    }
+
+    return numReady == m_numMotors;
+}
+
+bool MotorGroup::negotiateBaudRate() const{
+    if((m_numMotors == 0) || (daisyChain->getProtocol() != Protocol::V1)){
+        return false;
+    }
+
+    // Find the rate the motors are listening at. If it isn't the one the UART
+    // starts at, a previous boot negotiated it, and it's kept as is. This way
+    // a rate that failed is not tried again on every boot, since trying it
+    // means writing the baud rate register (in EEPROM) and then restoring it
+    const uint32_t initialBaud = daisyChain->getBaudRate();
+    if(!pingAll()){
+        for(uint32_t baud : NEGOTIATED_BAUD_RATES){
+            if((baud != initialBaud) && daisyChain->setBaudRate(baud) &&
+               pingAll())
+            {
+                return true;
+            }
+        }
+
+        daisyChain->setBaudRate(initialBaud);
+        return false;
+    }
+
+    uint32_t maxBaud = m_motors[0]->getMaxBaudRate();
+    for(size_t i = 1; i < m_numMotors; ++i){
+        uint32_t motorMaxBaud = m_motors[i]->getMaxBaudRate();
+        if(motorMaxBaud < maxBaud){
+            maxBaud = motorMaxBaud;
+        }
+    }
+
+    // Step up one rate at a time, and stop at the first one that doesn't
+    // work. The motors are left at the fastest rate that did, where the next
+    // boot finds them
+    uint32_t busBaud = initialBaud;
+    for(uint32_t baud : NEGOTIATED_BAUD_RATES){
+        if((baud <= busBaud) || (baud > maxBaud) ||
+           !daisyChain->supportsBaudRate(baud))
+        {
+            continue;
+        }
+
+        if(!switchBaudRate(baud)){
+            // Fall back. Motors that did not switch ignore the request since
+            // it is sent at a rate they are not listening at
+            return switchBaudRate(busBaud);
+        }
+
+        busBaud = baud;
+    }
+
+    return true;
+}
+
+
+
+
+// Private
+// ----------------------------------------------------------------------------
+bool MotorGroup::syncWriter(
+    uint16_t addr,
+    uint8_t dataLen,
+    const uint8_t* data,
+    const bool* isIncluded
+) const
+{
+    if((dataLen == 0) || (dataLen > MAX_SYNC_WRITE_DATA_LEN)){
+        return false;
+    }
+
+    size_t numIncluded = 0;
+    for(size_t i = 0; i < m_numMotors; ++i){
+        if((isIncluded == nullptr) || isIncluded[i]){
+            ++numIncluded;
+        }
+    }
+
+    if(numIncluded == 0){
+        return false;
+    }
+
+    if(daisyChain->getProtocol() == Protocol::V2){
+        // Parameters are the 2-byte address, the 2-byte data length, and then
+        // the ID and data for each motor
+        uint8_t params[4 + MAX_GROUP_SIZE * (MAX_SYNC_WRITE_DATA_LEN + 1)];
+        params[0] = static_cast<uint8_t>(addr & 0xFF);
+        params[1] = static_cast<uint8_t>((addr >> 8) & 0xFF);
+        params[2] = dataLen;
+        params[3] = 0x00;
+
+        size_t numParams = 4;
+        for(size_t i = 0; i < m_numMotors; ++i){
+            if((isIncluded != nullptr) && !isIncluded[i]){
+                continue;
+            }
+
+            params[numParams++] = m_motors[i]->id();
+            for(uint8_t j = 0; j < dataLen; ++j){
+                params[numParams++] = data[i * dataLen + j];
+            }
+        }
+
+        uint8_t arr[PACKET2_OVERHEAD + maxStuffedSize(sizeof(params))];
+        size_t len = buildPacket2(
+            BROADCAST_ID,
+            INST_SYNC_WRITE,
+            params,
+            numParams,
+            arr,
+            sizeof(arr)
+        );
+
+        return (len != 0) && daisyChain->requestTransmission(arr, len);
+    }
+
+    uint8_t arrTransmit[
+        SYNC_WRITE_OVERHEAD + MAX_GROUP_SIZE * (MAX_SYNC_WRITE_DATA_LEN + 1)
+    ];
+
+    arrTransmit[0] = PACKET_HEADER_BYTE;
+    arrTransmit[1] = PACKET_HEADER_BYTE;
+    arrTransmit[2] = BROADCAST_ID;
+    arrTransmit[3] = static_cast<uint8_t>((dataLen + 1) * numIncluded + 4);
+    arrTransmit[4] = INST_SYNC_WRITE;
+    arrTransmit[5] = static_cast<uint8_t>(addr);
+    arrTransmit[6] = dataLen;
+
+    size_t idx = 7;
+    for(size_t i = 0; i < m_numMotors; ++i){
+        if((isIncluded != nullptr) && !isIncluded[i]){
+            continue;
+        }
+
+        arrTransmit[idx++] = m_motors[i]->id();
+        for(uint8_t j = 0; j < dataLen; ++j){
+            arrTransmit[idx++] = data[i * dataLen + j];
+        }
+    }
+
+    // Checksum
+    size_t packetLen = idx + 1;
+    arrTransmit[idx] = computeChecksum(arrTransmit, packetLen);
+
+    // Transmit
+    return daisyChain->requestTransmission(arrTransmit, packetLen);
+}
+
+bool MotorGroup::pingAll() const{
+    for(size_t i = 0; i < m_numMotors; ++i){
+        bool responded = false;
+        for(uint8_t attempt = 0; (attempt < PING_ATTEMPTS) && !responded;
+            ++attempt)
+        {
+            uint8_t id = 0;
+            responded = m_motors[i]->ping(id) && (id == m_motors[i]->id());
+        }
+
+        if(!responded){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MotorGroup::switchBaudRate(uint32_t baud) const{
+    // Negotiation runs before the status return level is configured, so a
+    // motor may answer the write (at the old rate) before switching. Absorb
+    // that answer so it does not collide with the next request. A motor which
+    // misses its request is found out by the pings below
+    for(size_t i = 0; i < m_numMotors; ++i){
+        m_motors[i]->setBaudRate(baud);
+
+        uint8_t status[STATUS_PACKET_OVERHEAD];
+        daisyChain->requestReception(status, sizeof(status));
+    }
+
+    return daisyChain->setBaudRate(baud) && pingAll();
+}
+
+bool MotorGroup::bulkReader(
+    uint8_t readAddr,
+    uint8_t readLength,
+    uint16_t* retVals,
+    bool* isValid
+) const
+{
+    for(size_t i = 0; i < m_numMotors; ++i){
+        isValid[i] = false;
+    }
+
+    if((readLength == 0) || (readLength > 2)){
+        return false;
+    }
+
+    uint8_t arrTransmit[BULK_READ_OVERHEAD + MAX_GROUP_SIZE * 3];
+
+    arrTransmit[0] = PACKET_HEADER_BYTE;
+    arrTransmit[1] = PACKET_HEADER_BYTE;
+    arrTransmit[2] = BROADCAST_ID;
+    arrTransmit[3] = static_cast<uint8_t>(3 * m_numMotors + 3);
+    arrTransmit[4] = INST_BULK_READ;
+    arrTransmit[5] = 0x00;
+
+    size_t idx = 6;
+    for(size_t i = 0; i < m_numMotors; ++i){
+        arrTransmit[idx++] = readLength;
+        arrTransmit[idx++] = m_motors[i]->id();
+        arrTransmit[idx++] = readAddr;
+    }
+
+    size_t packetLen = idx + 1;
+    arrTransmit[idx] = computeChecksum(arrTransmit, packetLen);
+
+    // Transmit read request and receive the status packets from all the
+    // motors. Each one is matched to its motor by ID, so a motor that doesn't
+    // respond only costs its own reading
+    const size_t rxSize = (STATUS_PACKET_OVERHEAD + readLength) * m_numMotors;
+    uint8_t arrReceive[MAX_GROUP_SIZE * (STATUS_PACKET_OVERHEAD + 2)] = {0};
+    ReadingContext<uint16_t> ctx = {
+        m_motors,
+        m_numMotors,
+        readLength,
+        retVals,
+        isValid
+    };
+
+    return daisyChain->transceiveStatusPackets(
+        arrTransmit,
+        packetLen,
+        arrReceive,
+        rxSize,
+        m_numMotors,
+        acceptReading<uint16_t>,
+        &ctx
+    );
+}
+
+float MotorGroup::decodeTelemetry(
+    size_t motorIdx,
+    Telemetry item,
+    uint16_t raw
+) const
+{
+    const Motor* motor = m_motors[motorIdx];
+    switch(item){
+        case Telemetry::POSITION:
+            return motor->rawToAngle(raw);
+        case Telemetry::LOAD:
+            return motor->rawToLoad(raw);
+        case Telemetry::VOLTAGE:
+            return raw / 10.0f;
+        case Telemetry::TEMPERATURE:
+        default:
+            return static_cast<float>(raw);
+    }
+}
+
+bool MotorGroup::syncReader2(
+    uint16_t readAddr,
+    uint8_t readLength,
+    uint32_t* retVals,
+    bool* isValid
+) const
+{
+    for(size_t i = 0; i < m_numMotors; ++i){
+        isValid[i] = false;
+    }
+
+    if((readLength == 0) || (readLength > POSITION2_WIDTH)){
+        return false;
+    }
+
+    // Parameters are the 2-byte address, the 2-byte data length, and then
+    // the ID of each motor
+    uint8_t params[4 + MAX_GROUP_SIZE];
+    params[0] = static_cast<uint8_t>(readAddr & 0xFF);
+    params[1] = static_cast<uint8_t>((readAddr >> 8) & 0xFF);
+    params[2] = readLength;
+    params[3] = 0x00;
+    for(size_t i = 0; i < m_numMotors; ++i){
+        params[4 + i] = m_motors[i]->id();
+    }
+
+    uint8_t arrTransmit[PACKET2_OVERHEAD + maxStuffedSize(sizeof(params))];
+    size_t len = buildPacket2(
+        BROADCAST_ID,
+        m_useFastSyncRead ? INST2_FAST_SYNC_READ : INST2_SYNC_READ,
+        params,
+        4 + m_numMotors,
+        arrTransmit,
+        sizeof(arrTransmit)
+    );
+
+    if(len == 0){
+        return false;
+    }
+
+    uint8_t arrReceive[
+        MAX_GROUP_SIZE * (STATUS_PACKET2_OVERHEAD + POSITION2_WIDTH)
+    ] = {0};
+
+    auto decode = [readLength](const uint8_t* data) -> uint32_t {
+        uint32_t val = 0;
+        for(uint8_t j = 0; j < readLength; ++j){
+            val |= static_cast<uint32_t>(data[j]) << (8 * j);
+        }
+
+        return val;
+    };
+
+    if(m_useFastSyncRead){
+        // All the motors reply within one status packet, so its CRC (sent by
+        // the last motor) covers every entry. If any part of it is lost, none
+        // of the entries can be trusted
+        const size_t entrySize = FAST_SYNC_READ_ENTRY_OVERHEAD + readLength;
+        const size_t rxSize =
+            FAST_SYNC_READ_HEADER_SIZE + entrySize * m_numMotors;
+        if(!daisyChain->transceive(arrTransmit, len, arrReceive, rxSize)){
+            return false;
+        }
+
+        uint8_t id;
+        const uint8_t* data;
+        size_t numParams;
+        if(!parseStatusPacket2(arrReceive, rxSize, id, data, numParams) ||
+           (id != BROADCAST_ID))
+        {
+            return false;
+        }
+
+        bool success = true;
+        for(size_t i = 0; i < m_numMotors; ++i){
+            const uint8_t* entry =
+                &arrReceive[FAST_SYNC_READ_HEADER_SIZE + i * entrySize];
+
+            // Entry layout: ERROR, ID, DATA_1, ..., DATA_N, CRC_L, CRC_H
+            if(entry[1] != m_motors[i]->id()){
+                success = false;
+                continue;
+            }
+
+            retVals[i] = decode(&entry[2]);
+            isValid[i] = true;
+        }
+
+        return success;
+    }
+
+    // Each motor replies with its own status packet. As for BULK_READ, each
+    // one is matched to its motor by ID
+    ReadingContext<uint32_t> ctx = {
+        m_motors,
+        m_numMotors,
+        readLength,
+        retVals,
+        isValid
+    };
+
+    return daisyChain->transceiveStatusPackets(
+        arrTransmit,
+        len,
+        arrReceive,
+        (STATUS_PACKET2_OVERHEAD + readLength) * m_numMotors,
+        m_numMotors,
+        acceptReading<uint32_t>,
+        &ctx
+    );
+}
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - MotorGroup */
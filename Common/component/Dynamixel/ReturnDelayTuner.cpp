@@ -0,0 +1,154 @@
+/**
+  *****************************************************************************
+  * @file   ReturnDelayTuner.cpp
+  * @author Tyler Gamvrelis
+  *
+  * @ingroup ReturnDelayTuner
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "ReturnDelayTuner.h"
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Return delay times tried, in microseconds, largest first. The motors
+ *        store the delay in units of 2 us
+ */
+constexpr uint16_t CANDIDATE_RETURN_DELAYS[] = {
+    250, 200, 150, 100, 80, 60, 50, 40, 30, 20, 16, 12, 8, 4, 2
+};
+
+/** @brief Entry reported for motors outside the group */
+const dynamixel::ReturnDelayStats NO_RESULT;
+
+} // end anonymous namespace
+
+
+
+
+namespace dynamixel{
+/***************************** ReturnDelayTuner ******************************/
+// Public
+// ----------------------------------------------------------------------------
+ReturnDelayTuner::ReturnDelayTuner(
+    MotorGroup* group,
+    uint32_t (*readCycles)(void),
+    uint16_t numTrials
+)
+    :
+        m_group(group),
+        m_readCycles(readCycles),
+        m_numTrials(numTrials)
+{
+
+}
+
+bool ReturnDelayTuner::tune(bool persist){
+    bool success = true;
+    for(size_t i = 0; i < m_group->size(); ++i){
+        m_results[i] = ReturnDelayStats();
+        success &= tuneMotor(*m_group->motor(i), m_results[i], persist);
+    }
+
+    return success;
+}
+
+bool ReturnDelayTuner::tuneMotor(
+    const Motor& motor,
+    ReturnDelayStats& best,
+    bool persist
+) const
+{
+    uint16_t originalDelay = 0;
+    if(!motor.getReturnDelayTime(originalDelay)){
+        return false;
+    }
+
+    // Shorter delays only get less reliable, so stop at the first failure
+    // after a reliable one
+    bool found = false;
+    ReturnDelayStats stats;
+    for(uint16_t delay : CANDIDATE_RETURN_DELAYS){
+        if(!motor.setReturnDelayTime(delay)){
+            continue;
+        }
+
+        stats.delay = delay;
+        measure(motor, stats);
+
+        if(stats.isReliable()){
+            best = stats;
+            found = true;
+        }
+        else if(found){
+            break;
+        }
+    }
+
+    uint16_t finalDelay = (found && persist) ? best.delay : originalDelay;
+    if(originalDelay < 2){
+        // Out of range for setReturnDelayTime
+        finalDelay = found ? best.delay : 2;
+    }
+    motor.setReturnDelayTime(finalDelay);
+
+    return found;
+}
+
+void ReturnDelayTuner::measure(
+    const Motor& motor,
+    ReturnDelayStats& stats
+) const
+{
+    stats.numTrials = m_numTrials;
+    stats.numSuccesses = 0;
+    stats.meanLatency = 0;
+
+    uint64_t totalLatency = 0;
+    for(uint16_t i = 0; i < m_numTrials; ++i){
+        uint8_t temperature = 0;
+        uint32_t start = m_readCycles();
+        bool success = motor.getTemperature(temperature);
+        uint32_t elapsed = m_readCycles() - start;
+
+        if(success){
+            ++stats.numSuccesses;
+            totalLatency += elapsed;
+        }
+    }
+
+    if(stats.numSuccesses != 0){
+        stats.meanLatency = static_cast<uint32_t>(
+            totalLatency / stats.numSuccesses
+        );
+    }
+}
+
+const ReturnDelayStats& ReturnDelayTuner::result(size_t idx) const{
+    if(idx >= m_group->size()){
+        return NO_RESULT;
+    }
+
+    return m_results[idx];
+}
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - ReturnDelayTuner */
@@ -0,0 +1,254 @@
+/**
+  *****************************************************************************
+  * @file   StatusPacketDecoder.cpp
+  * @author Tyler Gamvrelis
+  *
+  * @ingroup StatusPacketDecoder
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "StatusPacketDecoder.h"
+#include <string.h>
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Number of bytes of a Protocol 2.0 packet needed to see its
+ *        instruction field, which tells status packets apart from others
+ */
+constexpr size_t PACKET2_INSTRUCTION_END = 8;
+
+/** @brief Smallest valid LENGTH field of a Protocol 1.0 status packet */
+constexpr uint8_t MIN_LENGTH1 = 2;
+
+/** @brief Smallest valid LENGTH field of a Protocol 2.0 status packet */
+constexpr uint16_t MIN_LENGTH2 = 4;
+
+} // end anonymous namespace
+
+
+
+
+namespace dynamixel{
+/**************************** StatusPacketDecoder ****************************/
+// Public
+// ----------------------------------------------------------------------------
+StatusPacketDecoder::StatusPacketDecoder(Protocol protocol)
+    :
+        m_protocol(protocol)
+{
+
+}
+
+void StatusPacketDecoder::setHandler(Handler handler, void* context){
+    m_handler = handler;
+    m_context = context;
+}
+
+size_t StatusPacketDecoder::feed(const uint8_t* data, size_t len){
+    size_t numReported = 0;
+    while(len > 0){
+        size_t n = MAX_STATUS_PACKET_SIZE - m_len;
+        if(n > len){
+            n = len;
+        }
+
+        memcpy(&m_buf[m_len], data, n);
+        m_len += n;
+        data += n;
+        len -= n;
+
+        // A full buffer always holds a complete packet or a bad header, so
+        // this always makes room for more
+        numReported += process();
+    }
+
+    return numReported;
+}
+
+void StatusPacketDecoder::reset(){
+    m_len = 0;
+}
+
+uint32_t StatusPacketDecoder::getNumPackets() const{
+    return m_numPackets;
+}
+
+uint32_t StatusPacketDecoder::getNumChecksumErrors() const{
+    return m_numChecksumErrors;
+}
+
+uint32_t StatusPacketDecoder::getNumDiscardedBytes() const{
+    return m_numDiscardedBytes;
+}
+
+
+
+
+// Private
+// ----------------------------------------------------------------------------
+size_t StatusPacketDecoder::process(){
+    size_t numReported = 0;
+    while(m_len > 0){
+        size_t packetLen = 0;
+        Framing framing = (m_protocol == Protocol::V2) ?
+                          frame2(packetLen) : frame1(packetLen);
+
+        if(framing == Framing::INCOMPLETE){
+            break;
+        }
+
+        StatusPacket packet;
+        if((framing == Framing::COMPLETE) && validate(packetLen, packet)){
+            ++m_numPackets;
+            ++numReported;
+            if(m_handler != nullptr){
+                m_handler(packet, m_context);
+            }
+
+            drop(packetLen);
+            continue;
+        }
+
+        if(framing == Framing::COMPLETE){
+            ++m_numChecksumErrors;
+        }
+
+        // Resume the scan at the next byte that could start a header
+        size_t next = 1;
+        while((next < m_len) && (m_buf[next] != PACKET_HEADER_BYTE)){
+            ++next;
+        }
+
+        m_numDiscardedBytes += next;
+        drop(next);
+    }
+
+    return numReported;
+}
+
+StatusPacketDecoder::Framing StatusPacketDecoder::frame1(
+    size_t& packetLen
+) const
+{
+    // Header, then an ID other than 0xFF
+    if(m_buf[0] != PACKET_HEADER_BYTE){
+        return Framing::INVALID;
+    }
+    if(m_len < 2){
+        return Framing::INCOMPLETE;
+    }
+    if(m_buf[1] != PACKET_HEADER_BYTE){
+        return Framing::INVALID;
+    }
+    if(m_len < 3){
+        return Framing::INCOMPLETE;
+    }
+    if(m_buf[2] == PACKET_HEADER_BYTE){
+        // The header may start at the next byte instead
+        return Framing::INVALID;
+    }
+    if(m_len < PACKET_OVERHEAD){
+        return Framing::INCOMPLETE;
+    }
+
+    const uint8_t lengthField = m_buf[3];
+    if((lengthField < MIN_LENGTH1) ||
+       (PACKET_OVERHEAD + lengthField > MAX_STATUS_PACKET_SIZE))
+    {
+        return Framing::INVALID;
+    }
+
+    packetLen = PACKET_OVERHEAD + lengthField;
+    return (m_len < packetLen) ? Framing::INCOMPLETE : Framing::COMPLETE;
+}
+
+StatusPacketDecoder::Framing StatusPacketDecoder::frame2(
+    size_t& packetLen
+) const
+{
+    constexpr uint8_t HEADER[] = {
+        PACKET_HEADER_BYTE,
+        PACKET_HEADER_BYTE,
+        PACKET2_HEADER_BYTE_3,
+        0x00
+    };
+
+    for(size_t i = 0; i < sizeof(HEADER); ++i){
+        if(m_len <= i){
+            return Framing::INCOMPLETE;
+        }
+        if(m_buf[i] != HEADER[i]){
+            return Framing::INVALID;
+        }
+    }
+
+    if(m_len < PACKET2_LENGTH_OFFSET){
+        return Framing::INCOMPLETE;
+    }
+
+    const uint16_t lengthField = m_buf[5] | (m_buf[6] << 8);
+    if((lengthField < MIN_LENGTH2) ||
+       (PACKET2_LENGTH_OFFSET + lengthField > MAX_STATUS_PACKET_SIZE))
+    {
+        return Framing::INVALID;
+    }
+
+    if(m_len < PACKET2_INSTRUCTION_END){
+        return Framing::INCOMPLETE;
+    }
+    if(m_buf[7] != INST2_STATUS){
+        return Framing::INVALID;
+    }
+
+    packetLen = PACKET2_LENGTH_OFFSET + lengthField;
+    return (m_len < packetLen) ? Framing::INCOMPLETE : Framing::COMPLETE;
+}
+
+bool StatusPacketDecoder::validate(size_t packetLen, StatusPacket& packet){
+    if(m_protocol == Protocol::V2){
+        packet.error = m_buf[8];
+        return parseStatusPacket2(
+            m_buf,
+            packetLen,
+            packet.id,
+            packet.params,
+            packet.numParams
+        );
+    }
+
+    if(m_buf[packetLen - 1] != computeChecksum(m_buf, packetLen)){
+        return false;
+    }
+
+    packet.id = m_buf[2];
+    packet.error = m_buf[4];
+    packet.params = &m_buf[5];
+    packet.numParams = packetLen - STATUS_PACKET_OVERHEAD;
+    return true;
+}
+
+void StatusPacketDecoder::drop(size_t n){
+    memmove(m_buf, &m_buf[n], m_len - n);
+    m_len -= n;
+}
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - StatusPacketDecoder */
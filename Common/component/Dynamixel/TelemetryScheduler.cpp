@@ -0,0 +1,240 @@
+/**
+  *****************************************************************************
+  * @file   TelemetryScheduler.cpp
+  * @author Tyler Gamvrelis
+  *
+  * @ingroup TelemetryScheduler
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "TelemetryScheduler.h"
+#include <algorithm>
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Largest age kept for a pair, in cycles */
+constexpr uint16_t MAX_AGE = 0xFFFF;
+
+/** @brief Longest period a pair can be read at, in cycles */
+constexpr uint32_t MAX_PERIOD = 0xFFFF;
+
+
+
+
+// Classes & structs
+// ----------------------------------------------------------------------------
+/** @brief A pair that is due in the current cycle */
+struct DueEntry{
+    uint8_t motorIdx;
+    dynamixel::Telemetry item;
+    uint16_t period;
+    uint16_t age;
+};
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/**
+ * @brief Orders due pairs fastest first, then most overdue first
+ * @return true if a is to be read before b
+ */
+bool isReadBefore(const DueEntry& a, const DueEntry& b){
+    if(a.period != b.period){
+        return a.period < b.period;
+    }
+    return a.age > b.age;
+}
+
+} // end anonymous namespace
+
+
+
+
+namespace dynamixel{
+/**************************** TelemetryScheduler *****************************/
+// Public
+// ----------------------------------------------------------------------------
+TelemetryScheduler::TelemetryScheduler(
+    MotorGroup* group,
+    uint32_t cycleRateHz
+)
+    :
+        m_group(group),
+        m_cycleRateHz(cycleRateHz),
+        m_budgetUs(
+            (cycleRateHz == 0) ? 0 :
+            1000000 / cycleRateHz * DEFAULT_TELEMETRY_BUDGET_PERCENT / 100
+        )
+{
+
+}
+
+bool TelemetryScheduler::setRate(Telemetry item, uint32_t rateHz){
+    bool success = true;
+    for(size_t i = 0; i < m_group->size(); ++i){
+        success &= setRate(i, item, rateHz);
+    }
+
+    return success;
+}
+
+bool TelemetryScheduler::setRate(
+    size_t motorIdx,
+    Telemetry item,
+    uint32_t rateHz
+)
+{
+    if((motorIdx >= m_group->size()) || (item >= Telemetry::NUM_TELEMETRY)){
+        return false;
+    }
+
+    uint32_t period = 0;
+    if((rateHz != 0) && (m_cycleRateHz != 0)){
+        period = (m_cycleRateHz + rateHz / 2) / rateHz;
+        period = std::max(period, static_cast<uint32_t>(1));
+        period = std::min(period, MAX_PERIOD);
+    }
+
+    const size_t idx = entry(motorIdx, item);
+    m_period[idx] = static_cast<uint16_t>(period);
+
+    // Due straight away, so every quantity has a reading as soon as possible
+    m_age[idx] = m_period[idx];
+    return true;
+}
+
+void TelemetryScheduler::setCycleBudget(uint32_t budgetUs){
+    m_budgetUs = budgetUs;
+}
+
+size_t TelemetryScheduler::schedule(TelemetryRead* reads, size_t maxReads){
+    DueEntry due[MAX_TELEMETRY_READS];
+    size_t numDue = 0;
+    uint16_t fastestPeriod = 0;
+    for(size_t i = 0; i < m_group->size(); ++i){
+        for(size_t j = 0; j < NUM_TELEMETRY; ++j){
+            const Telemetry item = static_cast<Telemetry>(j);
+            const size_t idx = entry(i, item);
+            if(m_period[idx] == 0){
+                continue;
+            }
+
+            if((fastestPeriod == 0) || (m_period[idx] < fastestPeriod)){
+                fastestPeriod = m_period[idx];
+            }
+
+            if(m_age[idx] < MAX_AGE){
+                ++m_age[idx];
+            }
+
+            if(m_age[idx] >= m_period[idx]){
+                due[numDue].motorIdx = static_cast<uint8_t>(i);
+                due[numDue].item = item;
+                due[numDue].period = m_period[idx];
+                due[numDue].age = m_age[idx];
+                ++numDue;
+            }
+        }
+    }
+
+    if(numDue == 0){
+        return 0;
+    }
+
+    // Fastest first, then most overdue first. This runs every control cycle
+    // on a handful of entries, so it's sorted in place by insertion rather
+    // than with std::stable_sort, which may allocate a buffer. Ties keep
+    // their order, with earlier motors first
+    for(size_t i = 1; i < numDue; ++i){
+        const DueEntry d = due[i];
+        size_t j = i;
+        while((j > 0) && isReadBefore(d, due[j - 1])){
+            due[j] = due[j - 1];
+            --j;
+        }
+        due[j] = d;
+    }
+
+    uint32_t readTimes[NUM_TELEMETRY];
+    for(size_t j = 0; j < NUM_TELEMETRY; ++j){
+        readTimes[j] = m_group->estimateReadTime(static_cast<Telemetry>(j));
+    }
+
+    uint32_t usedUs = 0;
+    size_t numReads = 0;
+    for(size_t i = 0; i < numDue; ++i){
+        const DueEntry& d = due[i];
+        const uint32_t cost = readTimes[static_cast<size_t>(d.item)];
+
+        // Keep scanning after a read that does not fit, since a cheaper one
+        // further down may still fill the gap
+        const bool fits = (usedUs + cost <= m_budgetUs);
+        if((numReads == maxReads) || ((d.period != fastestPeriod) && !fits)){
+            ++m_numDeferred;
+            continue;
+        }
+
+        reads[numReads].motorIdx = d.motorIdx;
+        reads[numReads].item = d.item;
+        reads[numReads].isValid = false;
+        ++numReads;
+
+        usedUs += cost;
+        m_age[entry(d.motorIdx, d.item)] = 0;
+    }
+
+    return numReads;
+}
+
+bool TelemetryScheduler::runCycle(
+    TelemetryRead* reads,
+    size_t maxReads,
+    size_t& numReads
+)
+{
+    numReads = schedule(reads, maxReads);
+    if(numReads == 0){
+        return true;
+    }
+
+    return m_group->readTelemetry(reads, numReads);
+}
+
+uint32_t TelemetryScheduler::getNumDeferred() const{
+    return m_numDeferred;
+}
+
+MotorGroup* TelemetryScheduler::group() const{
+    return m_group;
+}
+
+
+
+
+// Private
+// ----------------------------------------------------------------------------
+size_t TelemetryScheduler::entry(size_t motorIdx, Telemetry item){
+    return motorIdx * NUM_TELEMETRY + static_cast<size_t>(item);
+}
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - TelemetryScheduler */
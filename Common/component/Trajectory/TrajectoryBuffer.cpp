@@ -0,0 +1,264 @@
+/**
+  *****************************************************************************
+  * @file   TrajectoryBuffer.cpp
+  * @author Tyler Gamvrelis
+  *
+  * @ingroup TrajectoryBuffer
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "TrajectoryBuffer.h"
+#include <math.h>
+#include <string.h>
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Functions
+// ----------------------------------------------------------------------------
+/** @brief Returns true once the clock has reached timeMs, allowing for wrap */
+bool reached(uint32_t nowMs, uint32_t timeMs){
+    return static_cast<int32_t>(nowMs - timeMs) >= 0;
+}
+
+/** @brief Returns the slope from a to b over durationMs, or 0 if instant */
+float slope(float a, float b, uint32_t durationMs){
+    return (durationMs != 0) ? ((b - a) / durationMs) : 0.0f;
+}
+
+/**
+ * @brief Returns the speed through a setpoint between segments of the given
+ *        slopes. This is the harmonic mean of the slopes (Fritsch-Carlson),
+ *        or 0 if the setpoint is a peak or trough. It's at most twice either
+ *        slope, so neither cubic overshoots its ends
+ */
+float monotoneSpeed(float in, float out){
+    if(in * out <= 0){
+        return 0.0f;
+    }
+    return 2 * in * out / (in + out);
+}
+
+/**
+ * @brief Limits the speed at one end of a segment of the given slope so that
+ *        its cubic doesn't overshoot: 0 if heading away from the other end,
+ *        and at most 3 times the slope otherwise
+ */
+float limitSpeed(float speed, float segmentSlope){
+    if(speed * segmentSlope <= 0){
+        return 0.0f;
+    }
+    return (fabsf(speed) > fabsf(3 * segmentSlope)) ? (3 * segmentSlope) : speed;
+}
+
+} // end anonymous namespace
+
+
+
+
+namespace trajectory{
+/***************************** TrajectoryBuffer ******************************/
+// Public
+// ----------------------------------------------------------------------------
+TrajectoryBuffer::TrajectoryBuffer(Interpolation interpolation)
+    :
+        m_interpolation(interpolation)
+{
+
+}
+
+bool TrajectoryBuffer::push(const Setpoint& setpoint, uint32_t nowMs){
+    if(!m_haveSegment){
+        hold(setpoint.angles, nowMs);
+        return true;
+    }
+
+    if(setpoint.replace){
+        // Head for the setpoint from wherever the trajectory is, at whatever
+        // speed it is moving, as far as that doesn't take it past the
+        // setpoint
+        float angles[NUM_JOINTS];
+        float speeds[NUM_JOINTS];
+        advance(nowMs);
+        evaluate(nowMs, angles, speeds);
+        m_count = 0;
+
+        m_startMs = nowMs;
+        m_durationMs = setpoint.durationMs;
+        memcpy(m_startAngles, angles, sizeof(m_startAngles));
+        memcpy(m_endAngles, setpoint.angles, sizeof(m_endAngles));
+        for(size_t i = 0; i < NUM_JOINTS; ++i){
+            m_startSpeeds[i] = limitSpeed(
+                speeds[i],
+                slope(m_startAngles[i], m_endAngles[i], m_durationMs)
+            );
+        }
+        setEndSpeeds();
+        return true;
+    }
+
+    if(m_count == TRAJECTORY_CAPACITY){
+        ++m_numDropped;
+        return false;
+    }
+
+    uint32_t fromMs = m_startMs + m_durationMs;
+    if(m_count != 0){
+        fromMs = m_queue[(m_head + m_count - 1) % TRAJECTORY_CAPACITY].timeMs;
+    }
+    else if(reached(nowMs, fromMs)){
+        // At rest, so start moving now rather than catch up
+        fromMs = nowMs;
+    }
+
+    Point& point = m_queue[(m_head + m_count) % TRAJECTORY_CAPACITY];
+    point.timeMs = fromMs + setpoint.durationMs;
+    point.durationMs = setpoint.durationMs;
+    memcpy(point.angles, setpoint.angles, sizeof(point.angles));
+    ++m_count;
+    return true;
+}
+
+void TrajectoryBuffer::hold(const float* angles, uint32_t nowMs){
+    memcpy(m_startAngles, angles, sizeof(m_startAngles));
+    memcpy(m_endAngles, angles, sizeof(m_endAngles));
+    memset(m_startSpeeds, 0, sizeof(m_startSpeeds));
+    memset(m_endSpeeds, 0, sizeof(m_endSpeeds));
+    m_startMs = nowMs;
+    m_durationMs = 0;
+    m_count = 0;
+    m_haveSegment = true;
+}
+
+bool TrajectoryBuffer::sample(uint32_t nowMs, float* angles){
+    if(!m_haveSegment){
+        return false;
+    }
+
+    advance(nowMs);
+    evaluate(nowMs, angles, nullptr);
+    return true;
+}
+
+bool TrajectoryBuffer::isMoving(uint32_t nowMs) const{
+    return (m_count != 0) ||
+           (m_haveSegment && !reached(nowMs, m_startMs + m_durationMs));
+}
+
+size_t TrajectoryBuffer::size() const{
+    return m_count;
+}
+
+uint32_t TrajectoryBuffer::getNumDropped() const{
+    return m_numDropped;
+}
+
+
+
+
+// Private
+// ----------------------------------------------------------------------------
+void TrajectoryBuffer::advance(uint32_t nowMs){
+    while((m_count != 0) && reached(nowMs, m_startMs + m_durationMs)){
+        startNextSegment();
+    }
+}
+
+void TrajectoryBuffer::startNextSegment(){
+    const Point& point = m_queue[m_head];
+
+    memcpy(m_startAngles, m_endAngles, sizeof(m_startAngles));
+    memcpy(m_startSpeeds, m_endSpeeds, sizeof(m_startSpeeds));
+    memcpy(m_endAngles, point.angles, sizeof(m_endAngles));
+    m_startMs = point.timeMs - point.durationMs;
+    m_durationMs = point.durationMs;
+
+    m_head = (m_head + 1) % TRAJECTORY_CAPACITY;
+    --m_count;
+
+    setEndSpeeds();
+}
+
+void TrajectoryBuffer::setEndSpeeds(){
+    if(m_count == 0){
+        memset(m_endSpeeds, 0, sizeof(m_endSpeeds));
+        return;
+    }
+
+    const Point& next = m_queue[m_head];
+    for(size_t i = 0; i < NUM_JOINTS; ++i){
+        const float in = slope(m_startAngles[i], m_endAngles[i], m_durationMs);
+        const float out = slope(m_endAngles[i], next.angles[i], next.durationMs);
+        m_endSpeeds[i] = monotoneSpeed(in, out);
+    }
+}
+
+void TrajectoryBuffer::evaluate(
+    uint32_t nowMs,
+    float* angles,
+    float* speeds
+) const
+{
+    const int32_t elapsedMs = static_cast<int32_t>(nowMs - m_startMs);
+    if((m_durationMs == 0) || (elapsedMs >= static_cast<int32_t>(m_durationMs))){
+        memcpy(angles, m_endAngles, sizeof(m_endAngles));
+        if(speeds != nullptr){
+            memcpy(speeds, m_endSpeeds, sizeof(m_endSpeeds));
+        }
+        return;
+    }
+
+    const float T = static_cast<float>(m_durationMs);
+    const float u = (elapsedMs > 0) ? (elapsedMs / T) : 0.0f;
+
+    if(m_interpolation == Interpolation::LINEAR){
+        for(size_t i = 0; i < NUM_JOINTS; ++i){
+            const float delta = m_endAngles[i] - m_startAngles[i];
+            angles[i] = m_startAngles[i] + delta * u;
+            if(speeds != nullptr){
+                speeds[i] = delta / T;
+            }
+        }
+        return;
+    }
+
+    // Cubic Hermite basis functions, and their derivatives with respect to u
+    const float u2 = u * u;
+    const float u3 = u2 * u;
+    const float h00 = 2 * u3 - 3 * u2 + 1;
+    const float h10 = u3 - 2 * u2 + u;
+    const float h01 = -2 * u3 + 3 * u2;
+    const float h11 = u3 - u2;
+    const float dh00 = 6 * u2 - 6 * u;
+    const float dh10 = 3 * u2 - 4 * u + 1;
+    const float dh01 = -6 * u2 + 6 * u;
+    const float dh11 = 3 * u2 - 2 * u;
+
+    for(size_t i = 0; i < NUM_JOINTS; ++i){
+        const float p0 = m_startAngles[i];
+        const float m0 = m_startSpeeds[i] * T;
+        const float p1 = m_endAngles[i];
+        const float m1 = m_endSpeeds[i] * T;
+        angles[i] = h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1;
+        if(speeds != nullptr){
+            speeds[i] = (dh00 * p0 + dh10 * m0 + dh01 * p1 + dh11 * m1) / T;
+        }
+    }
+}
+
+} // end namespace trajectory
+
+
+
+
+/**
+ * @}
+ */
+/* end - TrajectoryBuffer */
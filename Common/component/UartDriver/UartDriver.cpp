@@ -24,6 +24,26 @@
 
 
 
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Largest difference between a requested baud rate and the one the
+ *        UART can actually generate, as a percentage, for which the requested
+ *        one is considered supported. Receivers resynchronize on every start
+ *        bit, so a few percent is tolerable over a 10-bit frame
+ */
+constexpr uint32_t BAUD_RATE_TOLERANCE_PERCENT = 2;
+
+/** @brief Bits on the wire per byte (start bit, 8 data bits, stop bit) */
+constexpr uint32_t BITS_PER_BYTE = 10;
+
+} // end anonymous namespace
+
+
+
+
 namespace uart{
 /********************************* UartDriver ********************************/
 // Public
@@ -85,6 +105,32 @@ void UartDriver::setMaxBlockTime(uint32_t timeout){
     m_max_block_time = timeout;
 }
 
+void UartDriver::setMaxBlockTimeUs(uint32_t timeoutUs){
+    m_max_block_time_us = timeoutUs;
+}
+
+void UartDriver::setCycleCounter(
+    uint32_t (*readCycles)(void),
+    uint32_t cyclesPerUs
+)
+{
+    m_readCycles = readCycles;
+    m_cyclesPerUs = cyclesPerUs;
+}
+
+#if defined(THREADED)
+void UartDriver::setWakeupTimer(
+    const TimerInterface* timer_if,
+    TIM_HandleTypeDef* htim,
+    uint32_t channel
+)
+{
+    m_timer_if = timer_if;
+    m_htim = htim;
+    m_timerChannel = channel;
+}
+#endif
+
 void UartDriver::setIOType(IO_Type io_type){
     this->io_type = io_type;
 }
@@ -98,10 +144,6 @@ bool UartDriver::transmit(
     size_t numBytes
 ) const
 {
-#if defined(THREADED)
-    uint32_t notification = 0;
-    BaseType_t status = pdFALSE;
-#endif
     HAL_StatusTypeDef hal_status;
     bool retval = false;
 
@@ -111,29 +153,20 @@ bool UartDriver::transmit(
             case IO_Type::DMA:
                 if(os_if != nullptr){
                     if(hw_if->transmitDMA(uartHandlePtr, arrTransmit, numBytes) == HAL_OK){
-                        status = os_if->OS_xTaskNotifyWait(0, NOTIFIED_FROM_TX_ISR, &notification, m_max_block_time);
-
-                        if((status == pdTRUE) && CHECK_NOTIFICATION(notification, NOTIFIED_FROM_TX_ISR)){
-                            retval = true;
-                        }
+                        retval = waitForNotification(
+                            NOTIFIED_FROM_TX_ISR,
+                            numBytes
+                        );
                     }
                 }
                 break;
             case IO_Type::IT:
                 if(os_if != nullptr){
                     if(hw_if->transmitIT(uartHandlePtr, arrTransmit, numBytes) == HAL_OK){
-                        status = os_if->OS_xTaskNotifyWait(
-                            0,
+                        retval = waitForNotification(
                             NOTIFIED_FROM_TX_ISR,
-                            &notification,
-                            m_max_block_time
+                            numBytes
                         );
-
-                        if((status == pdTRUE) &&
-                           CHECK_NOTIFICATION(notification, NOTIFIED_FROM_TX_ISR))
-                        {
-                            retval = true;
-                        }
                     }
                 }
                 break;
@@ -144,7 +177,7 @@ bool UartDriver::transmit(
                     uartHandlePtr,
                     arrTransmit,
                     numBytes,
-                    m_max_block_time
+                    getPollTimeout(numBytes)
                 );
 
                 retval = (hal_status == HAL_OK);
@@ -164,10 +197,6 @@ bool UartDriver::receive(
     size_t numBytes
 ) const
 {
-#if defined(THREADED)
-    uint32_t notification = 0;
-    BaseType_t status = pdFALSE;
-#endif
     HAL_StatusTypeDef hal_status;
     bool retval = false;
 
@@ -177,29 +206,20 @@ bool UartDriver::receive(
             case IO_Type::DMA:
                 if(os_if != nullptr){
                     if(hw_if->receiveDMA(uartHandlePtr, arrReceive, numBytes) == HAL_OK){
-                        status = os_if->OS_xTaskNotifyWait(0, NOTIFIED_FROM_RX_ISR, &notification, m_max_block_time);
-
-                        if((status == pdTRUE) && CHECK_NOTIFICATION(notification, NOTIFIED_FROM_RX_ISR)){
-                            retval = true;
-                        }
+                        retval = waitForNotification(
+                            NOTIFIED_FROM_RX_ISR,
+                            numBytes
+                        );
                     }
                 }
                 break;
             case IO_Type::IT:
                 if(os_if != nullptr){
                     if(hw_if->receiveIT(uartHandlePtr, arrReceive, numBytes) == HAL_OK){
-                        status = os_if->OS_xTaskNotifyWait(
-                            0,
+                        retval = waitForNotification(
                             NOTIFIED_FROM_RX_ISR,
-                            &notification,
-                            m_max_block_time
+                            numBytes
                         );
-
-                        if((status == pdTRUE) &&
-                           CHECK_NOTIFICATION(notification, NOTIFIED_FROM_RX_ISR))
-                        {
-                            retval = true;
-                        }
                     }
                 }
                 break;
@@ -210,7 +230,7 @@ bool UartDriver::receive(
                     uartHandlePtr,
                     arrReceive,
                     numBytes,
-                    m_max_block_time
+                    getPollTimeout(numBytes)
                 );
 
                 retval = (hal_status == HAL_OK);
@@ -225,6 +245,347 @@ bool UartDriver::receive(
     return retval;
 }
 
+bool UartDriver::receiveToIdle(
+    uint8_t* arrReceive,
+    size_t maxBytes,
+    size_t& numReceived
+) const
+{
+    numReceived = 0;
+    if(!hw_is_initialized){
+        return false;
+    }
+
+#if defined(THREADED)
+    if((io_type == IO_Type::DMA) && (os_if != nullptr)){
+        bool retval = false;
+        if(hw_if->receiveToIdleDMA(uartHandlePtr, arrReceive, maxBytes) == HAL_OK){
+            // Woken up by the idle line or by the transfer completing
+            retval = waitForNotification(NOTIFIED_FROM_RX_ISR, maxBytes);
+            numReceived = maxBytes - static_cast<size_t>(
+                hw_if->getDmaRxInstanceNDTR(uartHandlePtr)
+            );
+        }
+
+        // Also stops the idle line interrupt
+        hw_if->abortReceive(uartHandlePtr);
+        return retval && (numReceived != 0);
+    }
+#endif
+
+    if(!receive(arrReceive, maxBytes)){
+        return false;
+    }
+
+    numReceived = maxBytes;
+    return true;
+}
+
+bool UartDriver::transceive(
+    uint8_t* arrTransmit,
+    size_t numTransmit,
+    uint8_t* arrReceive,
+    size_t numReceive
+) const
+{
+    if(!hw_is_initialized){
+        return false;
+    }
+
+#if defined(THREADED)
+    if(((io_type == IO_Type::DMA) || (io_type == IO_Type::IT)) &&
+       (os_if != nullptr))
+    {
+        const bool useDma = (io_type == IO_Type::DMA);
+        bool retval = false;
+
+        // Set before anything can complete, so the transmission complete
+        // interrupt never wakes up the caller
+        m_isTransceiving = true;
+
+        HAL_StatusTypeDef hal_status = useDma ?
+            hw_if->receiveDMA(uartHandlePtr, arrReceive, numReceive) :
+            hw_if->receiveIT(uartHandlePtr, arrReceive, numReceive);
+        if(hal_status == HAL_OK){
+            hal_status = useDma ?
+                hw_if->transmitDMA(uartHandlePtr, arrTransmit, numTransmit) :
+                hw_if->transmitIT(uartHandlePtr, arrTransmit, numTransmit);
+            if(hal_status == HAL_OK){
+                retval = waitForNotification(
+                    NOTIFIED_FROM_RX_ISR,
+                    numTransmit + numReceive
+                );
+            }
+        }
+
+        if(retval != true){
+            hw_if->abortTransmit(uartHandlePtr);
+            hw_if->abortReceive(uartHandlePtr);
+        }
+
+        m_isTransceiving = false;
+        return retval;
+    }
+#endif
+
+    return transmit(arrTransmit, numTransmit) &&
+           receive(arrReceive, numReceive);
+}
+
+bool UartDriver::beginTransceive(
+    uint8_t* arrTransmit,
+    size_t numTransmit
+) const
+{
+#if defined(THREADED)
+    if(hw_is_initialized &&
+       ((io_type == IO_Type::DMA) || (io_type == IO_Type::IT)))
+    {
+        // Set before anything can complete, so the transmission complete
+        // interrupt never wakes up the caller
+        m_isTransceiving = true;
+
+        HAL_StatusTypeDef hal_status = (io_type == IO_Type::DMA) ?
+            hw_if->transmitDMA(uartHandlePtr, arrTransmit, numTransmit) :
+            hw_if->transmitIT(uartHandlePtr, arrTransmit, numTransmit);
+        if(hal_status == HAL_OK){
+            return true;
+        }
+
+        hw_if->abortTransmit(uartHandlePtr);
+        m_isTransceiving = false;
+    }
+#else
+    (void)arrTransmit;
+    (void)numTransmit;
+#endif
+
+    return false;
+}
+
+void UartDriver::endTransceive(bool success) const{
+    if(!success){
+        hw_if->abortTransmit(uartHandlePtr);
+    }
+
+    m_isTransceiving = false;
+}
+
+bool UartDriver::isTransceiving() const{
+    return m_isTransceiving;
+}
+
+bool UartDriver::setBaudRate(uint32_t baud) const{
+    if(!hw_is_initialized || !supportsBaudRate(baud)){
+        return false;
+    }
+
+    return hw_if->setBaudRate(uartHandlePtr, baud) == HAL_OK;
+}
+
+uint32_t UartDriver::getBaudRate() const{
+    if(!hw_is_initialized){
+        return 0;
+    }
+
+    return hw_if->getBaudRate(uartHandlePtr);
+}
+
+bool UartDriver::supportsBaudRate(uint32_t baud) const{
+    if(!hw_is_initialized || (baud == 0)){
+        return false;
+    }
+
+    uint32_t attainable = hw_if->getAttainableBaudRate(uartHandlePtr, baud);
+    if(attainable == 0){
+        return false;
+    }
+
+    uint32_t error = (attainable > baud) ? (attainable - baud) :
+                                           (baud - attainable);
+
+    // Compare error / baud against the tolerance without dividing. The
+    // product fits in 64 bits for any baud rate
+    return (static_cast<uint64_t>(error) * 100) <=
+           (static_cast<uint64_t>(baud) * BAUD_RATE_TOLERANCE_PERCENT);
+}
+
+bool UartDriver::enableDriverEnable(
+    uint8_t assertionTime,
+    uint8_t deassertionTime
+) const
+{
+    if(!hw_is_initialized){
+        return false;
+    }
+
+    return hw_if->enableDriverEnable(
+        uartHandlePtr,
+        assertionTime,
+        deassertionTime
+    ) == HAL_OK;
+}
+
+TickType_t UartDriver::getTickCount() const{
+    if(usesMicrosecondTimeouts()){
+        return m_readCycles();
+    }
+
+#if defined(THREADED)
+    if(os_if != nullptr){
+        return os_if->OS_xTaskGetTickCount();
+    }
+#endif
+    return 0;
+}
+
+bool UartDriver::waitForStream(TickType_t start, size_t numBytes) const{
+    if(usesMicrosecondTimeouts()){
+        // Unsigned subtraction copes with the counter wrapping around
+        const uint32_t timeoutCycles = getTimeoutUs(numBytes) * m_cyclesPerUs;
+        const uint32_t elapsed = m_readCycles() - start;
+        if(elapsed >= timeoutCycles){
+            return false;
+        }
+
+#if defined(THREADED)
+        if(os_if != nullptr){
+            uint32_t value = 0;
+            waitMicroseconds(
+                NOTIFIED_FROM_RX_ISR,
+                (timeoutCycles - elapsed + m_cyclesPerUs - 1) / m_cyclesPerUs,
+                &value
+            );
+        }
+#endif
+        return true;
+    }
+
+#if defined(THREADED)
+    if(os_if != nullptr){
+        const TickType_t elapsed = os_if->OS_xTaskGetTickCount() - start;
+        if(elapsed >= m_max_block_time){
+            return false;
+        }
+
+        uint32_t value = 0;
+        os_if->OS_xTaskNotifyWait(
+            0,
+            NOTIFIED_FROM_RX_ISR,
+            &value,
+            m_max_block_time - elapsed
+        );
+        return true;
+    }
+#endif
+    return false;
+}
+
+
+
+
+// Private
+// ----------------------------------------------------------------------------
+bool UartDriver::usesMicrosecondTimeouts() const{
+    return (m_max_block_time_us != 0) && (m_readCycles != nullptr) &&
+           (m_cyclesPerUs != 0);
+}
+
+uint32_t UartDriver::getTimeoutUs(size_t numBytes) const{
+    uint32_t timeoutUs = m_max_block_time_us;
+
+    const uint32_t baud = getBaudRate();
+    if(baud != 0){
+        const uint64_t numBits = static_cast<uint64_t>(numBytes) * BITS_PER_BYTE;
+        timeoutUs += static_cast<uint32_t>((numBits * 1000000 + baud - 1) / baud);
+    }
+
+    return timeoutUs;
+}
+
+uint32_t UartDriver::getPollTimeout(size_t numBytes) const{
+    if(!usesMicrosecondTimeouts()){
+        return m_max_block_time;
+    }
+
+    // Round up to whole milliseconds
+    return (getTimeoutUs(numBytes) + 999) / 1000;
+}
+
+#if defined(THREADED)
+bool UartDriver::waitForNotification(
+    uint32_t notification,
+    size_t numBytes
+) const
+{
+    uint32_t value = 0;
+    if(!usesMicrosecondTimeouts()){
+        BaseType_t status = os_if->OS_xTaskNotifyWait(
+            0,
+            notification,
+            &value,
+            m_max_block_time
+        );
+
+        return (status == pdTRUE) && CHECK_NOTIFICATION(value, notification);
+    }
+
+    // The thread may be woken up before the bit is set (e.g. by a timer
+    // that fired late for an earlier wait, or by the OS tick when there is
+    // no timer), so the cycle counter has the final say
+    const uint32_t timeoutCycles = getTimeoutUs(numBytes) * m_cyclesPerUs;
+    const uint32_t start = m_readCycles();
+    uint32_t elapsed = 0;
+    do{
+        BaseType_t status = waitMicroseconds(
+            notification,
+            (timeoutCycles - elapsed + m_cyclesPerUs - 1) / m_cyclesPerUs,
+            &value
+        );
+
+        if((status == pdTRUE) && CHECK_NOTIFICATION(value, notification)){
+            return true;
+        }
+
+        // Unsigned subtraction copes with the counter wrapping around
+        elapsed = m_readCycles() - start;
+    } while(elapsed < timeoutCycles);
+
+    return false;
+}
+
+BaseType_t UartDriver::waitMicroseconds(
+    uint32_t notification,
+    uint32_t remainingUs,
+    uint32_t* value
+) const
+{
+    // The OS can only time out a wait in whole ticks
+    TickType_t ticks = pdMS_TO_TICKS((remainingUs + 999) / 1000);
+    if(ticks == 0){
+        ticks = 1;
+    }
+
+    if(m_timer_if == nullptr){
+        return os_if->OS_xTaskNotifyWait(0, notification, value, ticks);
+    }
+
+    // The timer wakes the thread up at the deadline, so the OS timeout is
+    // pushed back a tick to only catch a lost interrupt. The timer is armed
+    // first so that it can't fire before the wait without waking it up
+    m_timer_if->startOneShot(m_htim, m_timerChannel, remainingUs);
+    BaseType_t status = os_if->OS_xTaskNotifyWait(
+        0,
+        notification | NOTIFIED_FROM_TIMER_ISR,
+        value,
+        ticks + 1
+    );
+    m_timer_if->stopOneShot(m_htim, m_timerChannel);
+
+    return status;
+}
+#endif
+
 } // end namespace uart
 
 
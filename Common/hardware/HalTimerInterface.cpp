@@ -0,0 +1,113 @@
+/**
+  *****************************************************************************
+  * @file    HalTimerInterface.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup HalTimerInterface
+  * @brief    Implements TimerInterface using HAL functions
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "HalTimerInterface.h"
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Functions
+// ----------------------------------------------------------------------------
+/** @brief Returns the compare interrupt of a timer channel */
+uint32_t getCompareInterrupt(uint32_t channel){
+    switch(channel){
+        case TIM_CHANNEL_2:
+            return TIM_IT_CC2;
+        case TIM_CHANNEL_3:
+            return TIM_IT_CC3;
+        case TIM_CHANNEL_4:
+            return TIM_IT_CC4;
+        case TIM_CHANNEL_1:
+        default:
+            return TIM_IT_CC1;
+    }
+}
+
+/** @brief Returns the event that software raises a channel's compare with */
+uint32_t getCompareEvent(uint32_t channel){
+    switch(channel){
+        case TIM_CHANNEL_2:
+            return TIM_EVENTSOURCE_CC2;
+        case TIM_CHANNEL_3:
+            return TIM_EVENTSOURCE_CC3;
+        case TIM_CHANNEL_4:
+            return TIM_EVENTSOURCE_CC4;
+        case TIM_CHANNEL_1:
+        default:
+            return TIM_EVENTSOURCE_CC1;
+    }
+}
+
+} // end anonymous namespace
+
+
+
+
+/**************************** HalTimerInterface ******************************/
+namespace timer{
+// Classes and structs
+// ----------------------------------------------------------------------------
+HalTimerInterface::HalTimerInterface() {
+
+}
+
+HalTimerInterface::~HalTimerInterface() {
+
+}
+
+void HalTimerInterface::startOneShot(
+    TIM_HandleTypeDef* htim,
+    uint32_t channel,
+    uint32_t delayUs
+) const
+{
+    const uint32_t it = getCompareInterrupt(channel);
+
+    __HAL_TIM_DISABLE_IT(htim, it);
+    const uint32_t start = __HAL_TIM_GET_COUNTER(htim);
+    __HAL_TIM_SET_COMPARE(htim, channel, start + delayUs);
+    __HAL_TIM_CLEAR_IT(htim, it);
+    __HAL_TIM_ENABLE_IT(htim, it);
+
+    // For short delays, the counter may have passed the compare value before
+    // its flag was cleared, so raise the event by hand. Unsigned subtraction
+    // copes with the counter wrapping around
+    if(__HAL_TIM_GET_COUNTER(htim) - start >= delayUs){
+        HAL_TIM_GenerateEvent(htim, getCompareEvent(channel));
+    }
+}
+
+void HalTimerInterface::stopOneShot(
+    TIM_HandleTypeDef* htim,
+    uint32_t channel
+) const
+{
+    const uint32_t it = getCompareInterrupt(channel);
+
+    __HAL_TIM_DISABLE_IT(htim, it);
+    __HAL_TIM_CLEAR_IT(htim, it);
+}
+
+} // end namespace timer
+
+
+
+
+/**
+ * @}
+ */
+/* end - HalTimerInterface */
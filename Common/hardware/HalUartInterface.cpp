@@ -214,6 +214,24 @@ HAL_StatusTypeDef HalUartInterface::receiveDMA(
     return status;
 }
 
+HAL_StatusTypeDef HalUartInterface::receiveToIdleDMA(
+    const UART_HandleTypeDef* uartHandlePtr,
+    uint8_t* arrReceive,
+    size_t numBytes
+) const
+{
+    UART_HandleTypeDef* huart = const_cast<UART_HandleTypeDef*>(uartHandlePtr);
+    HAL_StatusTypeDef status = HAL_UART_Receive_DMA(huart, arrReceive, numBytes);
+
+    if(status == HAL_OK){
+        // Only idle periods after this reception started count
+        __HAL_UART_CLEAR_IDLEFLAG(huart);
+        __HAL_UART_ENABLE_IT(huart, UART_IT_IDLE);
+    }
+
+    return status;
+}
+
 __IO uint32_t HalUartInterface::getDmaRxInstanceNDTR(
     const UART_HandleTypeDef* uartHandlePtr
 ) const
@@ -236,9 +254,11 @@ void HalUartInterface::abortReceive(
     const UART_HandleTypeDef* uartHandlePtr
 ) const
 {
-    HAL_UART_AbortReceive(
-        const_cast<UART_HandleTypeDef*>(uartHandlePtr)
-    );
+    UART_HandleTypeDef* huart = const_cast<UART_HandleTypeDef*>(uartHandlePtr);
+
+    // HAL_UART_AbortReceive predates the idle line interrupt
+    __HAL_UART_DISABLE_IT(huart, UART_IT_IDLE);
+    HAL_UART_AbortReceive(huart);
 }
 
 __IO uint32_t HalUartInterface::getErrorCode(
@@ -248,8 +268,139 @@ __IO uint32_t HalUartInterface::getErrorCode(
     return const_cast<UART_HandleTypeDef*>(uartHandlePtr)->ErrorCode;
 }
 
+HAL_StatusTypeDef HalUartInterface::setBaudRate(
+    const UART_HandleTypeDef* uartHandlePtr,
+    uint32_t baud
+) const
+{
+    UART_HandleTypeDef* huart = const_cast<UART_HandleTypeDef*>(uartHandlePtr);
+    huart->Init.BaudRate = baud;
+
+    // The handle is already initialized, so this only rewrites the baud rate
+    // (and the rest of the frame format) without touching the DMA links or
+    // the GPIO configuration
+    return HAL_UART_Init(huart);
+}
+
+uint32_t HalUartInterface::getBaudRate(
+    const UART_HandleTypeDef* uartHandlePtr
+) const
+{
+    return uartHandlePtr->Init.BaudRate;
+}
+
+uint32_t HalUartInterface::getAttainableBaudRate(
+    const UART_HandleTypeDef* uartHandlePtr,
+    uint32_t baud
+) const
+{
+    if(baud == 0){
+        return 0;
+    }
+
+#if defined(STM32F767xx)
+    // Each F7 USART has its own clock mux, so ask the HAL which clock it's on
+    // the same way HAL_UART_Init does
+    UART_ClockSourceTypeDef clockSource = UART_CLOCKSOURCE_UNDEFINED;
+    UART_GETCLOCKSOURCE(uartHandlePtr, clockSource);
+
+    uint32_t pclk = 0;
+    switch(clockSource){
+        case UART_CLOCKSOURCE_PCLK1:
+            pclk = HAL_RCC_GetPCLK1Freq();
+            break;
+        case UART_CLOCKSOURCE_PCLK2:
+            pclk = HAL_RCC_GetPCLK2Freq();
+            break;
+        case UART_CLOCKSOURCE_HSI:
+            pclk = HSI_VALUE;
+            break;
+        case UART_CLOCKSOURCE_SYSCLK:
+            pclk = HAL_RCC_GetSysClockFreq();
+            break;
+        case UART_CLOCKSOURCE_LSE:
+            pclk = LSE_VALUE;
+            break;
+        default:
+            return 0;
+    }
+#else
+    // USART1 and USART6 are clocked from APB2, and the rest from APB1
+    uint32_t pclk = 0;
+    if((uartHandlePtr->Instance == USART1) ||
+       (uartHandlePtr->Instance == USART6))
+    {
+        pclk = HAL_RCC_GetPCLK2Freq();
+    }
+    else{
+        pclk = HAL_RCC_GetPCLK1Freq();
+    }
+#endif
+
+    const uint32_t oversampling =
+        (uartHandlePtr->Init.OverSampling == UART_OVERSAMPLING_8) ? 8 : 16;
+
+    // BRR holds pclk / baud in fixed point, with as many fractional bits as
+    // it takes to count in units of 1/oversampling. It must be at least 1.0
+    uint32_t brr = (pclk + (baud / 2)) / baud;
+    if(brr < oversampling){
+        return 0;
+    }
+
+    return pclk / brr;
+}
+
+HAL_StatusTypeDef HalUartInterface::enableDriverEnable(
+    const UART_HandleTypeDef* uartHandlePtr,
+    uint8_t assertionTime,
+    uint8_t deassertionTime
+) const
+{
+#if defined(USE_UART_DRIVER_ENABLE)
+    // Like setBaudRate, this reinitializes the UART with its current
+    // settings, and additionally sets DEM, DEP, DEAT and DEDT
+    return HAL_RS485Ex_Init(
+        const_cast<UART_HandleTypeDef*>(uartHandlePtr),
+        UART_DE_POLARITY_HIGH,
+        assertionTime,
+        deassertionTime
+    );
+#else
+    UNUSED(uartHandlePtr);
+    UNUSED(assertionTime);
+    UNUSED(deassertionTime);
+    return HAL_ERROR;
+#endif
+}
+
 } // end namespace uart
 
+
+
+
+/********************************* Functions *********************************/
+#if defined(THREADED)
+void UART_IdleLineIRQHandler(UART_HandleTypeDef* huart){
+    if((__HAL_UART_GET_FLAG(huart, UART_FLAG_IDLE) == RESET) ||
+       (__HAL_UART_GET_IT_SOURCE(huart, UART_IT_IDLE) == RESET))
+    {
+        return;
+    }
+
+    __HAL_UART_CLEAR_IDLEFLAG(huart);
+
+    // A transfer that completed (in normal mode) has nothing left to deliver
+    if((huart->RxState != HAL_UART_STATE_BUSY_RX) || (huart->hdmarx == NULL)){
+        __HAL_UART_DISABLE_IT(huart, UART_IT_IDLE);
+        return;
+    }
+
+    const uint16_t size = huart->RxXferSize -
+                          static_cast<uint16_t>(huart->hdmarx->Instance->NDTR);
+    HAL_UARTEx_RxEventCallback(huart, size);
+}
+#endif
+
 /**
  * @}
  */
@@ -146,6 +146,10 @@ osStatus OsInterfaceImpl::OS_osSemaphoreRelease (
      return osSemaphoreRelease(semaphore_id);
 }
 
+TickType_t OsInterfaceImpl::OS_xTaskGetTickCount() const{
+    return xTaskGetTickCount();
+}
+
 } // end namespace os
 
 /**
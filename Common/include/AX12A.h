@@ -20,7 +20,7 @@
 
 
 /********************************* Includes **********************************/
-#include "Dynamixel.h"
+#include "MotorT.h"
 
 
 
@@ -66,7 +66,15 @@ constexpr float AX12A_MAX_VELOCITY = 114.0;
 
 // Classes and structs
 // ----------------------------------------------------------------------------
-class AX12A : public Motor{
+/** @brief Compile-time description of the AX12A. @see MotorT */
+struct AX12ATraits{
+    static constexpr ResolutionDivider RESOLUTION = ResolutionDivider::AX12A;
+    static constexpr float MAX_VELOCITY = AX12A_MAX_VELOCITY;
+    static constexpr uint32_t MAX_BAUD_RATE = 1000000;
+    static constexpr bool SUPPORTS_BULK_READ = false;
+};
+
+class AX12A : public MotorT<AX12ATraits>{
 public:
     /** @see Motor */
     AX12A(
@@ -91,16 +99,6 @@ public:
 
     // RAM
     // ------------------------------------------------------------------------
-    /**
-     * @brief Sets the goal velocity of the motor in RAM
-     * @param goalVelocity the goal velocity in RPM. Arguments of 0-114 are
-     *        valid when in joint mode. 0 corresponds to MAX motion in joint
-     *        mode, and minimum motion in wheel mode. In wheel mode, negative
-     *        arguments correspond to CW rotation
-     * @return true if successful, otherwise false
-     */
-    bool setGoalVelocity(float goalVelocity) const override;
-
     /**
      * @brief Sets the motor's clockwise compliance margin, that is, the
      *        acceptable error between the current and goal position, if the
@@ -169,16 +167,6 @@ public:
      * @return true if successful, otherwise false
      */
     bool setComplianceMargin(uint8_t complianceMargin) const;
-
-
-    // Getters (use the READ DATA instruction)
-    // ------------------------------------------------------------------------
-    /**
-     * @brief Reads the angular velocity of the motor, in RPM
-     * @param[out] retVal R-val return type (not modified upon failure)
-     * @return true if successful, otherwise false
-     */
-    bool getVelocity(float& retVal) const override;
 };
 
 } // end namespace dynamixel
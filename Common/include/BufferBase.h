@@ -92,6 +92,12 @@ public:
         {
             MotorBufferArray[i].set_lock(lock);
             MotorBufferArray[i].set_osInterface(osInterface);
+            MotorLoadBufferArray[i].set_lock(lock);
+            MotorLoadBufferArray[i].set_osInterface(osInterface);
+            MotorTemperatureBufferArray[i].set_lock(lock);
+            MotorTemperatureBufferArray[i].set_osInterface(osInterface);
+            MotorVoltageBufferArray[i].set_lock(lock);
+            MotorVoltageBufferArray[i].set_osInterface(osInterface);
         }
         m_lock = lock;
         m_osInterfacePtr = osInterface;
@@ -113,6 +119,10 @@ public:
     }
     BufferBase<imu::IMUStruct_t> IMUBuffer;
     BufferBase<MotorData_t> MotorBufferArray[periph::NUM_MOTORS];
+    // Read at lower rates than the positions, so all_data_ready ignores them
+    BufferBase<MotorData_t> MotorLoadBufferArray[periph::NUM_MOTORS];
+    BufferBase<MotorData_t> MotorTemperatureBufferArray[periph::NUM_MOTORS];
+    BufferBase<MotorData_t> MotorVoltageBufferArray[periph::NUM_MOTORS];
     // Add buffer items here as necessary
 private:
     osMutexId m_lock = nullptr;
@@ -10,8 +10,6 @@
   */
 
 // TODO: data structures namespace
-// TODO: think about overrun check and implement. try buffer with m_transmission_size != m_buff_size
-//   tygamvrelis: Technically the buffer size is dependent only on the baud rate and how often the buffer is checked, not the transmission size
 
 
 #ifndef CIRCULAR_DMA_BUFFER_H
@@ -39,6 +37,17 @@ namespace uart{
 
 // Classes and structs
 // ----------------------------------------------------------------------------
+/**
+ * @brief The unread bytes of a CircularDmaBuffer, in place. second is only non-empty when the unread bytes wrap
+ *        around the end of the buffer, in which case it starts at the beginning of the buffer.
+ */
+struct ReadSpans{
+    const uint8_t *first = nullptr;
+    size_t first_size = 0;
+    const uint8_t *second = nullptr;
+    size_t second_size = 0;
+};
+
 class CircularDmaBuffer{
 public:
     CircularDmaBuffer();
@@ -47,7 +56,8 @@ public:
         const UartInterface* hw_if_in,
         const uint16_t transmission_size_in,
         const size_t buff_size_in,
-        uint8_t *buff_p_in
+        uint8_t *buff_p_in,
+        const bool notify_on_idle_in = false
     );
     bool selfCheck() const;
     size_t updateHead();
@@ -55,8 +65,12 @@ public:
     bool dataAvail() const;
     size_t peekBuff(uint8_t *out_buff) const;
     size_t readBuff(uint8_t *out_buff);
-    void initiate() const;
-    void reinitiateIfError() const;
+    size_t readBuff(uint8_t *out_buff, size_t max_bytes);
+    ReadSpans peekSpans() const;
+    size_t consume(size_t num_bytes);
+    void initiate();
+    bool reinitiateIfError();
+    void onTransferComplete();
 
     const UART_HandleTypeDef* getUartHandle() const;
     const UartInterface* getHwIf() const;
@@ -65,14 +79,23 @@ public:
     const uint8_t* getBuffP() const;
     size_t getBuffHead() const;
     size_t getBuffTail() const;
+    uint32_t getNumOverruns() const;
+    uint32_t getNumBytesLost() const;
 private:
     const UART_HandleTypeDef *m_uart_handle = nullptr;
     const UartInterface *m_hw_if = nullptr;
     const uint16_t m_transmission_size = 0;
     const size_t m_buff_size = 0;
     const uint8_t *m_buff_p = nullptr;
+    const bool m_notify_on_idle = false;
     size_t m_buff_head = 0;
     size_t m_buff_tail = 0;
+    volatile uint32_t m_num_laps_isr = 0;
+    uint32_t m_num_laps = 0;
+    uint32_t m_bytes_written = 0;
+    uint32_t m_bytes_read = 0;
+    uint32_t m_num_overruns = 0;
+    uint32_t m_num_bytes_lost = 0;
 };
 
 
@@ -20,9 +20,12 @@
 /********************************* Includes **********************************/
 #include <stdint.h>
 #include "UartDriver.h"
+#include "CircularDmaBuffer.h"
 #include "GpioInterface.h"
+#include "StatusPacketDecoder.h"
 
 using uart::UartDriver;
+using uart::CircularDmaBuffer;
 using uart::IO_Type;
 using gpio::GpioInterface;
 
@@ -32,6 +35,26 @@ using gpio::GpioInterface;
 /************************** insert module name here **************************/
 // TODO: pick better namespace for this component (then update module name)
 namespace dynamixel{
+// Types & enums
+// ----------------------------------------------------------------------------
+/** @brief How the bus direction (RS-485 DE) line is switched */
+enum class DirectionControl : uint8_t{
+    SOFTWARE,     /**< The data direction pin is written by the thread before
+                       each transmission, and again once it is notified
+                       that the transmission completed                     */
+    TC_INTERRUPT, /**< The data direction pin is set by the thread before
+                       each transmission, and cleared from the UART's
+                       transmission complete interrupt through
+                       DaisyChain::onTransmitComplete. Polled transmissions
+                       fall back to SOFTWARE                              */
+    DRIVER_ENABLE /**< The UART drives the DE line in hardware, which must
+                       be routed to its DE (RTS) pin. Only available on
+                       STM32F7 (USE_UART_DRIVER_ENABLE)                   */
+};
+
+
+
+
 // Classes and structs
 // ----------------------------------------------------------------------------
 /** @brief Parameters for a DaisyChain */
@@ -40,17 +63,67 @@ struct DaisyChainParams{
     GpioInterface* gpioif;     /**< GPIO interface                    */
     GPIO_TypeDef* dataDirPort; /**< Data direction control port       */
     uint16_t dataDirPinNum;    /**< Data direction control pin number */
+    Protocol protocol;         /**< Protocol spoken on the bus. V1 if
+                                    left value-initialized            */
+    CircularDmaBuffer* rxBuffer; /**< Circular DMA reception used for
+                                      streaming. If nullptr, every
+                                      reception is a separate
+                                      transfer of an exact size      */
+    DirectionControl dirControl; /**< How the bus direction is switched.
+                                      SOFTWARE if left value-initialized */
 };
 
 
+/**
+ * @brief Called by DaisyChain::requestStatusPackets for each valid status
+ *        packet received
+ * @param packet The packet
+ * @param context The context pointer passed to requestStatusPackets
+ * @return true if the packet is one of those being waited for, otherwise
+ *         false
+ */
+using StatusPacketHandler = bool (*)(const StatusPacket& packet, void* context);
+
 class DaisyChain{
 public:
     DaisyChain(const DaisyChainParams& params);
     ~DaisyChain();
 
+    /**
+     * @brief Sets up the bus direction control and leaves the bus in RX. Must
+     *        be called once the UART is initialized, before any transfer
+     * @return true if the requested DirectionControl is in use, otherwise
+     *         false, in which case SOFTWARE is used instead
+     */
+    bool initDirectionControl();
+
+    /** @brief Returns the bus direction control in use */
+    DirectionControl getDirectionControl(void) const;
+
+    /**
+     * @brief Switches the bus to RX with DirectionControl::TC_INTERRUPT. To be
+     *        called from the UART's transmission complete callback, so the
+     *        bus is released within the interrupt latency instead of once the
+     *        thread gets to run again. Does nothing otherwise
+     * @return true if the thread that started the transmission is waiting to
+     *         be notified that it completed, false if it only waits for the
+     *         reply (@see transceive)
+     */
+    bool onTransmitComplete() const;
+
+    /**
+     * @brief Sets the IO type. Leaving DMA stops streaming reception
+     * @param io_type The IO type
+     */
     void setIOType(IO_Type io_type);
     IO_Type getIOType(void) const;
 
+    /**
+     * @brief Returns the protocol spoken by the motors on this daisy chain
+     * @return the protocol the daisy chain was initialized with
+     */
+    Protocol getProtocol(void) const;
+
     /**
      * @brief Request a transmission on the daisy chain. This is guaranteed to
      *        send the requested information within a timely manner. However,
@@ -72,6 +145,163 @@ public:
      */
     bool requestReception(uint8_t* buf, size_t bufSize) const;
 
+    /**
+     * @brief Sends a request and receives the reply to it. Without streaming,
+     *        with DMA or IT and with the bus released in hardware or from the
+     *        transmission complete interrupt, the reception is started before
+     *        the request goes out, so the first bytes of the reply cannot be
+     *        missed and the thread is only woken up once the reply is
+     *        complete (@see UartDriver::transceive). With streaming, the
+     *        reply is read from the stream, and with the bus released as
+     *        above the thread is not woken up when the request is out
+     *        either. Otherwise, this is requestTransmission followed by
+     *        requestReception
+     * @param request The bytes to be transmitted
+     * @param requestLen The number of bytes to be transmitted
+     * @param buf The array of bytes to buffer the reply. Must not overlap
+     *        request
+     * @param bufSize The number of bytes to be received
+     * @return true if successful, otherwise false
+     */
+    bool transceive(
+        uint8_t* request,
+        size_t requestLen,
+        uint8_t* buf,
+        size_t bufSize
+    ) const;
+
+    /**
+     * @brief Starts streaming reception, in which a circular DMA transfer
+     *        runs continuously into the rxBuffer given in the
+     *        DaisyChainParams. Receptions are then served from whatever has
+     *        arrived in it, rather than each one starting a transfer after
+     *        the request has gone out. What was received before each
+     *        transmission is discarded, and so is its echo if the transceiver
+     *        hears it, but the reply is kept even if it starts arriving
+     *        before the transmitting thread is woken up
+     * @return true if streaming started, otherwise false (no rxBuffer, or the
+     *         IO type is not DMA)
+     */
+    bool startStreaming();
+
+    /** @brief Returns whether streaming reception is running */
+    bool isStreaming() const;
+
+    /**
+     * @brief Receives status packets, checking each one's framing and
+     *        checksum or CRC. Bytes that do not belong to a valid packet are
+     *        skipped, so a corrupted or missing packet does not prevent the
+     *        ones after it from being received
+     * @param buf Without streaming, receives exactly bufSize bytes. Not used
+     *        with streaming
+     * @param bufSize Without streaming, the total size of the packets
+     *        expected
+     * @param numPackets The number of packets handler must accept
+     * @param handler Called for each valid packet
+     * @param context Passed through to handler
+     * @return true if handler accepted numPackets packets within the max
+     *         block time, otherwise false. Packets accepted before a failure
+     *         have been handled all the same
+     */
+    bool requestStatusPackets(
+        uint8_t* buf,
+        size_t bufSize,
+        size_t numPackets,
+        StatusPacketHandler handler,
+        void* context
+    ) const;
+
+    /**
+     * @brief Receives the status packet of one motor. @see requestStatusPackets
+     * @param id The ID of the motor. Packets from other motors are skipped
+     * @param buf Receives the packet's parameters, and is used as for
+     *        requestStatusPackets
+     * @param bufSize The number of bytes buf can hold. Without streaming,
+     *        this must be the size of the packet expected, which must not
+     *        exceed MAX_STATUS_PACKET_SIZE
+     * @param[out] packet The packet. Its parameters point into buf
+     * @return true if the packet was received, otherwise false
+     */
+    bool requestStatusPacket(
+        uint8_t id,
+        uint8_t* buf,
+        size_t bufSize,
+        StatusPacket& packet
+    ) const;
+
+    /**
+     * @brief Sends an instruction packet, then receives the status packets
+     *        answering it as requestStatusPackets does. Without streaming,
+     *        the transfers are made with transceive
+     * @param request The instruction packet
+     * @param requestLen Its length
+     * @param buf @see requestStatusPackets. Must not overlap request
+     * @param bufSize @see requestStatusPackets
+     * @param numPackets @see requestStatusPackets
+     * @param handler @see requestStatusPackets
+     * @param context @see requestStatusPackets
+     * @return true if the instruction packet went out and handler accepted
+     *         numPackets packets, otherwise false
+     */
+    bool transceiveStatusPackets(
+        uint8_t* request,
+        size_t requestLen,
+        uint8_t* buf,
+        size_t bufSize,
+        size_t numPackets,
+        StatusPacketHandler handler,
+        void* context
+    ) const;
+
+    /**
+     * @brief Sends an instruction packet, then receives the status packet of
+     *        one motor as requestStatusPacket does. Without streaming, the
+     *        transfers are made with transceive
+     * @param request The instruction packet
+     * @param requestLen Its length
+     * @param id @see requestStatusPacket
+     * @param buf @see requestStatusPacket. Must not overlap request
+     * @param bufSize @see requestStatusPacket
+     * @param[out] packet @see requestStatusPacket
+     * @return true if the packet was received, otherwise false
+     */
+    bool transceiveStatusPacket(
+        uint8_t* request,
+        size_t requestLen,
+        uint8_t id,
+        uint8_t* buf,
+        size_t bufSize,
+        StatusPacket& packet
+    ) const;
+
+    /**
+     * @brief Returns the decoder used to receive status packets, e.g. to read
+     *        its error counters
+     */
+    const StatusPacketDecoder& getDecoder() const;
+
+    /**
+     * @brief Changes the baud rate of the UART driving the daisy chain. This
+     *        does not change the baud rate of the motors
+     * @param baud The new baud rate
+     * @return true if successful, otherwise false
+     */
+    bool setBaudRate(uint32_t baud) const;
+
+    /**
+     * @brief Returns the baud rate of the UART driving the daisy chain
+     * @return the baud rate
+     */
+    uint32_t getBaudRate(void) const;
+
+    /**
+     * @brief Indicates whether the UART driving the daisy chain can run at a
+     *        given baud rate
+     * @param baud The baud rate
+     * @return true if the baud rate is supported, otherwise false
+     */
+    bool supportsBaudRate(uint32_t baud) const;
+
 
     // TODO(tyler): add method for "receive until condition...", where the
     // condition is possibly passed in as a function of some kind...
@@ -84,10 +314,92 @@ private:
 
     void changeBusDir(Direction dir) const;
 
+    /**
+     * @brief Returns whether the bus is released without the thread's help
+     *        once a transmission completes, i.e. in hardware or from the
+     *        transmission complete interrupt
+     */
+    bool releasesBusItself() const;
+
+    /**
+     * @brief Sends a request with streaming reception. If the bus is released
+     *        without the thread's help, this returns once the transmission
+     *        has started, and its echo is skipped as it arrives
+     *        (@see echoPending). Otherwise, this is requestTransmission
+     * @param request The bytes to be transmitted. Must stay valid until
+     *        endRequest
+     * @param requestLen The number of bytes to be transmitted
+     * @return true if successful, otherwise false
+     */
+    bool sendRequest(uint8_t* request, size_t requestLen) const;
+
+    /**
+     * @brief Ends a request sent by sendRequest, once the reply is in or the
+     *        wait for it was given up
+     * @param success Whether the reply was received
+     */
+    void endRequest(bool success) const;
+
+    /**
+     * @brief Skips as much of the echo of the request sent by sendRequest as
+     *        has arrived
+     * @return true while what was received so far could still be the start
+     *         of the echo, in which case none of it is to be read yet,
+     *         otherwise false
+     */
+    bool echoPending() const;
+
+    /**
+     * @brief Brings the streaming reception's head up to date, restarting the
+     *        transfer if the UART flagged an error
+     */
+    void serviceStream() const;
+
+    /** @brief Discards everything received so far by streaming reception */
+    void flushStream() const;
+
+    /**
+     * @brief Discards the echo of a transmission from streaming reception,
+     *        for transceivers that keep listening while driving the bus. To
+     *        be called after a flushStream made before the transmission
+     *        started. The bytes received since are left alone unless they
+     *        start with the transmitted bytes
+     * @param arr The bytes transmitted
+     * @param arrSize The number of bytes transmitted
+     * @param isSent Whether the transmission is known to be complete
+     * @return true if the echo was discarded or is not there, false if the
+     *         bytes received so far could still be the start of it
+     */
+    bool skipEcho(const uint8_t* arr, size_t arrSize, bool isSent) const;
+
+    /**
+     * @brief Receives status packets, after sending an instruction packet if
+     *        there is one. @see transceiveStatusPackets
+     * @param request The instruction packet, or nullptr to only receive
+     */
+    bool receiveStatusPackets(
+        uint8_t* request,
+        size_t requestLen,
+        uint8_t* buf,
+        size_t bufSize,
+        size_t numPackets,
+        StatusPacketHandler handler,
+        void* context
+    ) const;
+
     const UartDriver* uartDriver;    /**< @see UartDriver               */
     const GpioInterface* gpioif;     /**< @see GpioInterface            */
     const GPIO_TypeDef* dataDirPort; /**< Port data direction pin is on */
     const uint16_t dataDirPinNum;    /**< Data direction pin number     */
+    const Protocol protocol;         /**< Protocol spoken on the bus    */
+    DirectionControl m_dirControl;   /**< @see getDirectionControl      */
+    CircularDmaBuffer* const rxBuffer; /**< Streaming reception buffer  */
+    bool m_isStreaming = false;      /**< @see startStreaming           */
+    mutable uint8_t* m_echo = nullptr; /**< @see echoPending            */
+    mutable size_t m_echoLen = 0;    /**< Length of the request sent by
+                                          sendRequest, or 0 if none     */
+    mutable StatusPacketDecoder m_decoder; /**< Finds status packets in
+                                                received bytes          */
 };
 
 } // end namespace dynamixel
@@ -37,20 +37,37 @@ namespace dynamixel{
 /** @brief Baud rate register */
 constexpr uint8_t REG_BAUD_RATE           = 0x04;
 
+/** @brief Goal position register (0x1E = low byte, 0x1F = high byte) */
+constexpr uint8_t REG_GOAL_POSITION       = 0x1E;
+
 /** @brief Goal velocity register (0x20 = low byte, 0x21 = high byte) */
 constexpr uint8_t REG_GOAL_VELOCITY       = 0x20;
 
+/** @brief Current position register (0x24 = low byte, 0x25 = high byte) */
+constexpr uint8_t REG_CURRENT_POSITION    = 0x24;
+
 /** @brief Current velocity register (0x26 = low byte, 0x27 = high byte) */
 constexpr uint8_t REG_CURRENT_VELOCITY    = 0x26;
 
-// Default register values
+/** @brief Current load register (0x28 = low byte, 0x29 = high byte) */
+constexpr uint8_t REG_CURRENT_LOAD        = 0x28;
+
+/** @brief Current voltage register */
+constexpr uint8_t REG_CURRENT_VOLTAGE     = 0x2A;
+
+/** @brief Current temperature register */
+constexpr uint8_t REG_CURRENT_TEMPERATURE = 0x2B;
+
+// Protocol 2.0 register addresses
 // ----------------------------------------------------------------------------
-/**
- * @brief Motor broadcast ID (i.e. messages sent to this ID will be sent to all
- *        motors on the bus)
- */
-constexpr uint8_t BROADCAST_ID                = 0xFE;
+/** @brief Goal position register (4 bytes, Protocol 2.0 control table) */
+constexpr uint16_t REG2_GOAL_POSITION     = 116;
+
+/** @brief Current position register (4 bytes, Protocol 2.0 control table) */
+constexpr uint16_t REG2_CURRENT_POSITION  = 132;
 
+// Default register values
+// ----------------------------------------------------------------------------
 /** @brief Default motor ID */
 constexpr uint8_t DEFAULT_ID                  = 0x01;
 
@@ -172,8 +189,50 @@ enum class AlarmCondition : uint8_t{
 
 
 
+// Functions
+// ----------------------------------------------------------------------------
+/**
+ * @brief Returns the number of raw position ticks per degree for a motor with
+ *        the given resolution divider
+ * @details Biased up by a hundredth of a tick over the full range, so that
+ *          float rounding in angle * ticksPerDegree() never truncates a
+ *          whole tick count down (e.g. 300 degrees to 4094 instead of 4095)
+ * @param divider The motor's resolution divider
+ * @return The scale factor from degrees to raw position ticks
+ */
+constexpr float ticksPerDegree(ResolutionDivider divider){
+    return (static_cast<uint16_t>(divider) + 0.01f) / MAX_ANGLE;
+}
+
+/**
+ * @brief Returns the number of degrees per raw position tick for a motor with
+ *        the given resolution divider
+ * @param divider The motor's resolution divider
+ * @return The scale factor from raw position ticks to degrees
+ */
+constexpr float degreesPerTick(ResolutionDivider divider){
+    return MAX_ANGLE / static_cast<uint16_t>(divider);
+}
+
+
+
+
 // Classes and structs
 // ----------------------------------------------------------------------------
+/**
+ * @brief Feedback registers of a motor, decoded into engineering units.
+ *        @see Motor::readState
+ */
+struct JointState{
+    float position;      /**< Angular position (degrees)                     */
+    float velocity;      /**< Angular velocity (RPM). CW is negative         */
+    float load;          /**< Percentage of max torque. CW is negative       */
+    float voltage;       /**< Supply voltage (volts)                         */
+    uint8_t temperature; /**< Internal temperature (degrees Celsius)         */
+};
+
+class MotorGroup;
+
 class Motor{
 public:
     /**
@@ -330,6 +389,16 @@ public:
      */
     bool setGoalPosition(float goalAngle) const;
 
+    /**
+     * @brief Registers a goal position in the motor using the REG WRITE
+     *        instruction. The motor does not start moving until it receives
+     *        the ACTION instruction. @see MotorGroup::action
+     * @param goalAngle the desired angular position. Arguments between 0 and
+     *        300 are valid. Note that 150 corresponds to the middle position
+     * @return true if successful, otherwise false
+     */
+    bool stageGoalPosition(float goalAngle) const;
+
     /**
      * @brief Sets the torque limit for the motor in RAM
      * @param goalTorque The percentage of the maximum possible torque (max:
@@ -389,6 +458,27 @@ public:
      */
     bool getTemperature(uint8_t& retVal) const;
 
+    /**
+     * @brief Reads the time, in microseconds, that the motor waits before
+     *        returning a status packet
+     * @param[out] retVal R-val return type (not modified upon failure)
+     * @return true if successful, otherwise false
+     */
+    bool getReturnDelayTime(uint16_t& retVal) const;
+
+    /**
+     * @brief Reads the position, velocity, load, voltage, and temperature of
+     *        the motor
+     * @details These registers are contiguous in the control table (0x24 to
+     *          0x2B), so they are all fetched by a single READ DATA
+     *          instruction instead of one instruction per quantity. Only
+     *          supported over Protocol 1.0, since the Protocol 2.0 control
+     *          table lays these registers out differently
+     * @param[out] retVal R-val return type (not modified upon failure)
+     * @return true if successful, otherwise false
+     */
+    bool readState(JointState& retVal) const;
+
     /**
      * @brief   Indicates whether the motor is operating in joint mode or wheel
      *          mode
@@ -437,6 +527,61 @@ public:
      */
     bool enterJointMode();
 
+    /**
+     * @brief Indicates whether the motor supports the BULK_READ instruction
+     * @return true if BULK_READ is supported, otherwise false
+     */
+    virtual bool supportsBulkRead() const{
+        return false;
+    }
+
+    /**
+     * @brief Returns the fastest baud rate the motor can communicate at. This
+     *        is the fastest rate all Protocol 1.0 Dynamixels support
+     * @return the baud rate
+     */
+    virtual uint32_t getMaxBaudRate() const{
+        return 1000000;
+    }
+
+    // Shadow control table
+    // ------------------------------------------------------------------------
+    /**
+     * @brief Sets how many consecutive writes of an unchanged value may be
+     *        skipped before one is sent anyway
+     * @details Each motor keeps a RAM copy of the values last written to
+     *          its goal registers (goal position, goal velocity, goal
+     *          acceleration, punch, and the compliance/PID registers), and
+     *          skips writes that would not change them. Since the shadow
+     *          only knows what was sent and not what the motor actually
+     *          holds, a periodic refresh bounds how long a lost packet or a
+     *          motor brown-out can go uncorrected. Registers the motor may
+     *          change on its own (e.g. torque enable, LED, torque limit upon
+     *          an alarm shutdown) are never shadowed
+     * @param period The number of writes that may be skipped in a row. 0
+     *        (the default) disables the refresh, and 1 effectively disables
+     *        skipping
+     */
+    void setShadowRefreshPeriod(uint16_t period);
+
+    /**
+     * @brief Forgets every shadowed value, so that the next write to each
+     *        register is sent regardless of its value
+     */
+    void invalidateShadow() const;
+
+    /**
+     * @brief Returns the number of writes skipped because the shadowed value
+     *        matched
+     */
+    uint32_t getShadowHits() const;
+
+    /**
+     * @brief Returns the number of writes to shadowed registers that had to
+     *        be sent
+     */
+    uint32_t getShadowMisses() const;
+
     /** @brief See child implementation for details */
     virtual bool setBaudRate(uint32_t baud) const = 0;
     virtual bool setGoalVelocity(float goalVelocity) const = 0;
@@ -446,6 +591,11 @@ protected:
     /**
      * @brief Sends an array of data to a motor using the WRITE_DATA
      *        instruction
+     * @details Addresses are always given in terms of the Protocol 1.0
+     *          control table. On a Protocol 2.0 daisy chain, they are
+     *          translated to the equivalent Protocol 2.0 register, and the
+     *          data is zero-extended to that register's width. Registers
+     *          without an equivalent of the same encoding cannot be written
      * @param args an array of arguments of the form `{ADDR, PARAM_1, ... ,
      *        PARAM_N}`
      * @param numArgs this must be equal to `sizeof(args)`, and must be either
@@ -454,6 +604,18 @@ protected:
      */
     bool dataWriter(uint8_t* args, size_t numArgs) const;
 
+    /**
+     * @brief Registers an array of data in a motor using the REG WRITE
+     *        instruction. The write takes effect when the motor receives the
+     *        ACTION instruction
+     * @param args an array of arguments of the form `{ADDR, PARAM_1, ... ,
+     *        PARAM_N}`
+     * @param numArgs this must be equal to `sizeof(args)`, and must be either
+     *        2 or 3 based on the current implementation
+     * @return true if successful, otherwise false
+     */
+    bool regWriter(uint8_t* args, size_t numArgs) const;
+
     /**
      * @brief Reads data of a specified length from a given address in the
      *        motor
@@ -477,15 +639,181 @@ protected:
         uint16_t& retVal
     ) const;
 
+    /**
+     * @brief Reads a block of consecutive bytes from a given address in the
+     *        motor using a single READ DATA instruction
+     * @details On a Protocol 2.0 daisy chain, the block must be exactly one
+     *          register, which is translated as described for dataWriter and
+     *          truncated to readLength bytes
+     * @param readAddr The address inside the motor memory table where reading
+     *        is to begin
+     * @param readLength The number of bytes to be read. Must be in the range
+     *        [1, 8] based on the current implementation
+     * @param[out] retBuf Buffer that the PARAM bytes of the status packet are
+     *             copied into. Must hold at least readLength bytes. Not
+     *             modified upon failure
+     * @return true if successful and checksums match, otherwise false
+     */
+    bool dataBlockReader(
+        uint8_t readAddr,
+        uint8_t readLength,
+        uint8_t* retBuf
+    ) const;
+
+    /**
+     * @brief Converts a raw velocity code from the motor's control table into
+     *        RPM. The scale factor depends on the motor model
+     * @param raw The raw velocity code (bit 10 is the direction bit)
+     * @return The angular velocity in RPM. CW rotation is negative
+     */
+    virtual float rawToVelocity(uint16_t raw) const = 0;
+
     /** @brief true if motor is in joint mode, false if in wheel mode */
     bool m_isJointMode;
 
 private:
+    friend class MotorGroup;
+
+    /**
+     * @brief Converts an angle in degrees into the raw position code used by
+     *        this motor's control table
+     * @details The scale factor is computed once at construction, so this is
+     *          a single multiplication
+     * @param angle The angle to convert. Must be in [MIN_ANGLE, MAX_ANGLE]
+     * @return The raw position code
+     */
+    uint16_t angleToRaw(float angle) const;
+
+    /**
+     * @brief Converts a raw position code from this motor's control table into
+     *        an angle in degrees
+     * @param raw The raw position code to convert
+     * @return The angle in degrees
+     */
+    float rawToAngle(uint16_t raw) const;
+
+    /**
+     * @brief Converts a raw load code from this motor's control table into a
+     *        percentage of the maximum torque
+     * @param raw The raw load code (bit 10 is the direction bit)
+     * @return The load as a percentage. CW loads are negative
+     */
+    float rawToLoad(uint16_t raw) const;
+
+    /**
+     * @brief Sends an array of data to a motor using the specified write
+     *        instruction, unless the shadow control table shows the write
+     *        would not change anything. @see dataWriter, regWriter
+     * @param instruction Either INST_WRITE_DATA or INST_REG_WRITE
+     * @param args an array of arguments of the form `{ADDR, PARAM_1, ... ,
+     *        PARAM_N}`
+     * @param numArgs this must be equal to `sizeof(args)`, and must be either
+     *        2 or 3 based on the current implementation
+     * @return true if successful, otherwise false
+     */
+    bool instructionWriter(
+        uint8_t instruction,
+        uint8_t* args,
+        size_t numArgs
+    ) const;
+
+    /**
+     * @brief Protocol 1.0 implementation of instructionWriter
+     * @param instruction Either INST_WRITE_DATA or INST_REG_WRITE
+     * @param args an array of arguments of the form `{ADDR, PARAM_1, ... ,
+     *        PARAM_N}`
+     * @param numArgs this must be equal to `sizeof(args)`, and must be at
+     *        most 3 based on the current implementation
+     * @return true if successful, otherwise false
+     */
+    bool instructionWriter1(
+        uint8_t instruction,
+        uint8_t* args,
+        size_t numArgs
+    ) const;
+
+    /**
+     * @brief Protocol 2.0 implementation of instructionWriter
+     * @param instruction Either INST_WRITE_DATA or INST_REG_WRITE
+     * @param args an array of arguments of the form `{ADDR, PARAM_1, ... ,
+     *        PARAM_N}`, where ADDR is a Protocol 1.0 address
+     * @param numArgs this must be equal to `sizeof(args)`, and must be either
+     *        2 or 3 based on the current implementation
+     * @return true if successful, otherwise false
+     */
+    bool instructionWriter2(
+        uint8_t instruction,
+        uint8_t* args,
+        size_t numArgs
+    ) const;
+
+    /**
+     * @brief Protocol 2.0 implementation of dataBlockReader
+     * @param readAddr The Protocol 1.0 address of the register to be read
+     * @param readLength The width of the register in the Protocol 1.0 control
+     *        table
+     * @param[out] retBuf Buffer that the register is copied into. Must hold
+     *             at least readLength bytes. Not modified upon failure
+     * @return true if successful and CRCs match, otherwise false
+     */
+    bool dataBlockReader2(
+        uint8_t readAddr,
+        uint8_t readLength,
+        uint8_t* retBuf
+    ) const;
+
+    /**
+     * @brief Checks a pending write against the shadow control table, and
+     *        counts it as a hit or a miss
+     * @param addr The Protocol 1.0 address being written
+     * @param value The value being written
+     * @return true if the write can be skipped, otherwise false
+     */
+    bool shadowMatches(uint8_t addr, uint16_t value) const;
+
+    /**
+     * @brief Records the outcome of a write in the shadow control table
+     * @param addr The Protocol 1.0 address that was written
+     * @param value The value that was written
+     * @param wasSent true if the packet was transmitted. If false, the
+     *        register is forgotten, since its contents are now unknown
+     */
+    void shadowStore(uint8_t addr, uint16_t value, bool wasSent) const;
+
+    /**
+     * @brief Forgets the shadowed value of one register, so that the next
+     *        write to it is sent regardless of its value
+     * @param addr The Protocol 1.0 address
+     */
+    void shadowForget(uint8_t addr) const;
+
+    /** @brief Number of registers covered by the shadow control table */
+    static constexpr uint8_t NUM_SHADOW_REGISTERS = 8;
+
     /** @brief Motor identification (0-252, 0xFE) */
     uint8_t m_id;
 
-    const uint16_t resolutionDivider; /**< @see ResolutionDivider */
-    const DaisyChain* daisyChain;     /**< @see DaisyChain */
+    /** @brief Last value written to each shadowed register */
+    mutable uint16_t m_shadow[NUM_SHADOW_REGISTERS];
+
+    /** @brief Bit i is set if m_shadow[i] holds a known value */
+    mutable uint8_t m_shadowValid;
+
+    /**
+     * @brief Writes to each shadowed register skipped in a row since the
+     *        last one that was sent
+     */
+    mutable uint16_t m_shadowSkips[NUM_SHADOW_REGISTERS];
+
+    /** @brief @see setShadowRefreshPeriod */
+    uint16_t m_shadowRefreshPeriod;
+
+    mutable uint32_t m_shadowHits;   /**< @see getShadowHits   */
+    mutable uint32_t m_shadowMisses; /**< @see getShadowMisses */
+
+    const float m_ticksPerDegree;     /**< @see ticksPerDegree   */
+    const float m_degreesPerTick;     /**< @see degreesPerTick   */
+    const DaisyChain* daisyChain;     /**< @see DaisyChain       */
 };
 
 } // end namespace dynamixel
@@ -0,0 +1,249 @@
+/**
+  *****************************************************************************
+  * @file    DynamixelProtocol.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup DynamixelProtocol
+  * @brief Packet-level definitions for the Dynamixel V1.0 protocol, shared by
+  *        the classes which build instruction packets (Motor, MotorGroup)
+  * @ingroup Dynamixel
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef DYNAMIXEL_PROTOCOL_H
+#define DYNAMIXEL_PROTOCOL_H
+
+
+
+
+/********************************* Includes **********************************/
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+
+/***************************** DynamixelProtocol *****************************/
+namespace dynamixel{
+// Types & enums
+// ----------------------------------------------------------------------------
+/**
+ * @brief Dynamixel protocol versions. All the motors on a daisy chain must be
+ *        set to the same protocol
+ */
+enum class Protocol : uint8_t{
+    V1 = 0, /**< Protocol 1.0 (checksum, 2-byte header)             */
+    V2      /**< Protocol 2.0 (CRC-16, 4-byte header, byte stuffing) */
+};
+
+
+
+
+// Constants
+// ----------------------------------------------------------------------------
+
+// Instruction set definitions
+// ----------------------------------------------------------------------------
+/** @brief Gets a status packet  */
+constexpr uint8_t INST_PING       = 0x01;
+
+/** @brief Reads data from a motor register */
+constexpr uint8_t INST_READ_DATA  = 0x02;
+
+/** @brief Writes data for immediate execution */
+constexpr uint8_t INST_WRITE_DATA = 0x03;
+
+/** @brief Registers an instruction to be executed at a later time */
+constexpr uint8_t INST_REG_WRITE  = 0x04;
+
+/** @brief Triggers instructions registered by INST_REG_WRITE */
+constexpr uint8_t INST_ACTION     = 0x05;
+
+/** @brief Resets the control tables of the Dynamixel actuator(s) specified */
+constexpr uint8_t INST_RESET      = 0x06;
+
+/**
+ * @brief Writes on a specified address with a specified data length on multiple
+ *        devices
+ */
+constexpr uint8_t INST_SYNC_WRITE = 0x83;
+
+/**
+ * @brief Reads data from multiple devices, each from its own address and with
+ *        its own data length. The devices reply one after another, in the
+ *        order they are listed in the instruction packet. MX series only
+ */
+constexpr uint8_t INST_BULK_READ  = 0x92;
+
+// Packet layout
+// ----------------------------------------------------------------------------
+/**
+ * @brief Motor broadcast ID (i.e. messages sent to this ID will be sent to all
+ *        motors on the bus)
+ */
+constexpr uint8_t BROADCAST_ID = 0xFE;
+
+/** @brief Byte that makes up the 2-byte header of every packet */
+constexpr uint8_t PACKET_HEADER_BYTE = 0xFF;
+
+/**
+ * @brief Number of bytes in a packet that are not counted by its LENGTH field
+ *        (2 header bytes, ID, LENGTH)
+ */
+constexpr size_t PACKET_OVERHEAD    = 4;
+
+/**
+ * @brief Number of bytes in a status packet besides its parameters (2 header
+ *        bytes, ID, LENGTH, ERROR, CHECKSUM)
+ */
+constexpr size_t STATUS_PACKET_OVERHEAD = 6;
+
+// Protocol 2.0
+// ----------------------------------------------------------------------------
+// PING, READ_DATA, WRITE_DATA, REG_WRITE, ACTION, RESET and SYNC_WRITE share
+// their instruction codes with Protocol 1.0. The instructions below are
+// Protocol 2.0 only
+
+/** @brief Instruction field of every Protocol 2.0 status packet */
+constexpr uint8_t INST2_STATUS         = 0x55;
+
+/**
+ * @brief Reads data of the same length from the same address on multiple
+ *        devices. Each device replies with its own status packet
+ */
+constexpr uint8_t INST2_SYNC_READ      = 0x82;
+
+/**
+ * @brief Like INST2_SYNC_READ, but the devices reply together with a single
+ *        status packet, which saves the header, length and instruction bytes
+ *        for all but the first device
+ */
+constexpr uint8_t INST2_FAST_SYNC_READ = 0x8A;
+
+/** @brief Third byte of the 4-byte Protocol 2.0 header {0xFF, 0xFF, 0xFD, 0} */
+constexpr uint8_t PACKET2_HEADER_BYTE_3 = 0xFD;
+
+/** @brief Byte inserted after every 0xFF 0xFF 0xFD found outside the header */
+constexpr uint8_t PACKET2_STUFFING_BYTE = 0xFD;
+
+/**
+ * @brief Number of bytes in an instruction packet besides its parameters
+ *        (4 header bytes, ID, 2 LENGTH bytes, INSTRUCTION, 2 CRC bytes)
+ */
+constexpr size_t PACKET2_OVERHEAD = 10;
+
+/**
+ * @brief Number of bytes in a status packet besides its parameters (4 header
+ *        bytes, ID, 2 LENGTH bytes, INSTRUCTION, ERROR, 2 CRC bytes)
+ */
+constexpr size_t STATUS_PACKET2_OVERHEAD = 11;
+
+/**
+ * @brief Number of bytes in a packet that are not counted by its LENGTH field
+ *        (4 header bytes, ID, 2 LENGTH bytes)
+ */
+constexpr size_t PACKET2_LENGTH_OFFSET = 7;
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/**
+ * @brief  Compute the checksum for data passes in, according to a modular
+ *         checksum algorithm employed by the Dynamixel V1.0 protocol
+ * @param  arr the array to be ran through the checksum function
+ * @param  length the total length of the array arr
+ * @return The 1-byte number that is the checksum
+ */
+inline uint8_t computeChecksum(const uint8_t *arr, size_t length){
+    uint8_t accumulate = 0;
+
+    /* Loop through the array starting from the 2nd element of the array and
+     * finishing before the last since the last is where the checksum will
+     * be stored */
+    for(size_t i = 2; i < length - 1; i++){
+        accumulate += arr[i];
+    }
+
+    return (~accumulate) & 0xFF; // Lower 8 bits of the logical NOT of the sum
+}
+
+/**
+ * @brief Returns the largest number of bytes that numParams parameters can
+ *        take up once stuffed. @see buildPacket2
+ * @param numParams The number of parameters before stuffing
+ * @return The worst-case number of parameter bytes after stuffing
+ */
+constexpr size_t maxStuffedSize(size_t numParams){
+    return numParams + numParams / 3;
+}
+
+/**
+ * @brief Computes the CRC-16 used by the Dynamixel V2.0 protocol
+ *        (polynomial 0x8005, initial value 0, no reflection) using a
+ *        256-entry lookup table
+ * @param arr The bytes to run through the CRC, from the first header byte up
+ *        to the byte before the CRC field
+ * @param length The number of bytes in arr
+ * @return The CRC. It is sent low byte first
+ */
+uint16_t computeCrc16(const uint8_t* arr, size_t length);
+
+/**
+ * @brief Builds a Dynamixel V2.0 instruction packet. The parameters are
+ *        byte stuffed so that the header sequence never appears in them
+ * @param id The ID of the device the packet is addressed to
+ * @param instruction The instruction code
+ * @param params The instruction parameters, before stuffing
+ * @param numParams The number of parameters
+ * @param[out] buf The buffer to build the packet into. To be safe, it should
+ *             hold PACKET2_OVERHEAD + maxStuffedSize(numParams) bytes
+ * @param bufSize The number of bytes buf can hold
+ * @return The length of the packet, or 0 if it does not fit in buf
+ */
+size_t buildPacket2(
+    uint8_t id,
+    uint8_t instruction,
+    const uint8_t* params,
+    size_t numParams,
+    uint8_t* buf,
+    size_t bufSize
+);
+
+/**
+ * @brief Validates a Dynamixel V2.0 status packet and removes its byte
+ *        stuffing in place
+ * @param buf The received bytes, starting with the header
+ * @param length The number of bytes received
+ * @param[out] id The ID of the device that sent the packet
+ * @param[out] params Points to the first parameter after the ERROR byte,
+ *             inside buf
+ * @param[out] numParams The number of parameters after the ERROR byte, once
+ *             unstuffed
+ * @return true if the header, LENGTH, instruction and CRC are all valid,
+ *         otherwise false. The outputs are not modified upon failure
+ */
+bool parseStatusPacket2(
+    uint8_t* buf,
+    size_t length,
+    uint8_t& id,
+    const uint8_t*& params,
+    size_t& numParams
+);
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - DynamixelProtocol */
+
+#endif /* DYNAMIXEL_PROTOCOL_H */
@@ -0,0 +1,82 @@
+/**
+  *****************************************************************************
+  * @file    GlobalMockTest.h
+  * @author  Tyler Gamvrelis
+  * @brief   Test fixture base for tests whose mocks are globals
+  *
+  * @defgroup GlobalMockTest
+  * @ingroup  Mocks
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef GLOBAL_MOCK_TEST_H
+#define GLOBAL_MOCK_TEST_H
+
+
+
+
+/********************************* Includes **********************************/
+#include "MockUartInterface.h"
+#include "MockOsInterface.h"
+#include "MockGpioInterface.h"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+
+
+
+/******************************* GlobalMockTest ******************************/
+namespace mocks{
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @class GlobalMockTest Base for fixtures whose UART, OS and GPIO mocks are
+ *        file-scope objects. Such mocks outlive gmock's leak check, and their
+ *        expectations would otherwise carry over from one test to the next,
+ *        so they're verified and cleared after each test instead
+ */
+class GlobalMockTest : public ::testing::Test {
+protected:
+    GlobalMockTest(
+        MockUartInterface& uart,
+        MockOsInterface& os,
+        MockGpioInterface& gpio
+    )
+        :
+            m_uart(uart),
+            m_os(os),
+            m_gpio(gpio)
+    {
+
+    }
+
+    void TearDown() override {
+        ::testing::Mock::VerifyAndClearExpectations(&m_uart);
+        ::testing::Mock::VerifyAndClearExpectations(&m_os);
+        ::testing::Mock::VerifyAndClearExpectations(&m_gpio);
+        ::testing::Mock::AllowLeak(&m_uart);
+        ::testing::Mock::AllowLeak(&m_os);
+        ::testing::Mock::AllowLeak(&m_gpio);
+    }
+
+private:
+    MockUartInterface& m_uart;
+    MockOsInterface& m_os;
+    MockGpioInterface& m_gpio;
+};
+
+} // end namespace mocks
+
+
+
+
+/**
+ * @}
+ */
+/* end - GlobalMockTest */
+
+#endif /* GLOBAL_MOCK_TEST_H */
@@ -0,0 +1,274 @@
+/**
+  *****************************************************************************
+  * @file    GoalFrameParser.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup GoalFrameParser
+  * @brief Extracts goal messages from the byte stream sent by the PC,
+  *        checking each against its CRC, and frames the state messages sent
+  *        back
+  * @ingroup Communication
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef GOAL_FRAME_PARSER_H
+#define GOAL_FRAME_PARSER_H
+
+
+
+
+/********************************* Includes **********************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "WireFormat.h"
+
+
+
+
+/****************************** GoalFrameParser ******************************/
+namespace comm{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Number of 0xFF bytes that start each frame */
+constexpr size_t FRAME_HEADER_SIZE = 4;
+
+/** @brief Number of bytes of the CRC that ends each frame */
+constexpr size_t FRAME_CRC_SIZE = 4;
+
+/**
+ * @brief Size of a frame from the PC carrying a full goal: the header, the
+ *        goal message, and the CRC of the goal message. @see WireFormat
+ */
+constexpr size_t FRAME_SIZE =
+    FRAME_HEADER_SIZE + GOAL_MESSAGE_SIZE + FRAME_CRC_SIZE;
+
+/** @brief Size of the largest frame from the PC */
+constexpr size_t MAX_FRAME_SIZE =
+    FRAME_HEADER_SIZE + MAX_GOAL_MESSAGE_SIZE + FRAME_CRC_SIZE;
+
+/** @brief Size of a frame to the PC, carrying a state message */
+constexpr size_t STATE_FRAME_SIZE =
+    FRAME_HEADER_SIZE + STATE_MESSAGE_SIZE + FRAME_CRC_SIZE;
+
+
+
+
+// Types & enums
+// ----------------------------------------------------------------------------
+/**
+ * @brief Computes the CRC of a frame's payload, as the STM32 CRC unit does
+ *        after a reset: CRC-32 polynomial 0x04C11DB7, initial value
+ *        0xFFFFFFFF, fed one little-endian 32-bit word at a time, without
+ *        reflection or a final XOR
+ * @param data The payload, 4-byte aligned
+ * @param numBytes The size of the payload, a multiple of 4
+ * @return The CRC
+ */
+using Crc32Function = uint32_t (*)(const uint8_t* data, size_t numBytes);
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/** @brief Computes the CRC in software. @see Crc32Function */
+uint32_t crc32Software(const uint8_t* data, size_t numBytes);
+
+/**
+ * @brief Wraps a message in a frame: the header, the message, then its CRC
+ * @param message The message, 4-byte aligned
+ * @param len The size of the message, a multiple of 4
+ * @param[out] out The frame, len + FRAME_HEADER_SIZE + FRAME_CRC_SIZE bytes
+ * @param crc Computes the CRC of the message
+ * @return The size of the frame
+ */
+size_t writeFrame(
+    const uint8_t* message,
+    size_t len,
+    uint8_t* out,
+    Crc32Function crc = crc32Software
+);
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @class GoalFrameParser Finds the frames in the bytes received from the PC
+ *        and keeps the goal message of the last one whose CRC matched
+ * @details While looking for a header, the input is skipped 4 bytes at a time
+ *          until a word with a 0xFF byte in it turns up. The rest of the
+ *          frame is copied straight into one of two frame buffers, its size
+ *          being known once the start of the goal message is in; the buffers
+ *          swap roles once a frame's CRC matches, so the goal that is handed
+ *          out is never being written to. If the goal message is of an
+ *          unknown kind or the CRC does not match, the header that was locked
+ *          onto may have been bytes of payload, so the frame is held back and
+ *          scanned again from its second byte
+ */
+class GoalFrameParser{
+public:
+    /**
+     * @brief GoalFrameParser constructor
+     * @param crc Computes the CRC of each payload, e.g. using the CRC unit
+     */
+    explicit GoalFrameParser(Crc32Function crc = crc32Software);
+
+    ~GoalFrameParser() {}
+
+    /**
+     * @brief Parses received bytes, stopping early once a frame is complete
+     *        and its CRC matches
+     * @details Bytes held back from rejected frames are parsed before data.
+     *          Since a frame may complete before all of them are used up, it
+     *          is worth calling again after a complete frame even if no new
+     *          bytes have been received
+     * @param data The received bytes
+     * @param len The number of received bytes
+     * @param[out] complete Set to true if a frame was completed. It is left
+     *             alone otherwise
+     * @return The number of bytes parsed. Those after a complete frame are
+     *         left for the next call
+     */
+    size_t parse(const uint8_t* data, size_t len, bool& complete);
+
+    /**
+     * @brief Returns the goal message of the last frame whose CRC matched,
+     *        GOAL_MESSAGE_SIZE bytes. It stays valid until the next frame is
+     *        complete. @see decodeGoal
+     */
+    const uint8_t* getGoal() const;
+
+    /** @brief Returns the size of the goal message returned by getGoal */
+    size_t getGoalSize() const;
+
+    /** @brief Discards any partly received frame and held back bytes */
+    void reset();
+
+    /** @brief Returns the number of frames whose CRC matched */
+    uint32_t getNumFrames() const;
+
+    /** @brief Returns the number of frames whose CRC did not match */
+    uint32_t getNumCrcErrors() const;
+
+    /**
+     * @brief Returns the number of frames dropped because their goal message
+     *        was of another version or kind
+     */
+    uint32_t getNumUnknownMessages() const;
+
+    /**
+     * @brief Returns the number of times bytes had to be skipped to find a
+     *        header, e.g. after a corrupted frame or when starting mid-frame
+     */
+    uint32_t getNumResyncs() const;
+
+    /** @brief Returns the number of bytes skipped to find headers */
+    uint32_t getNumDiscardedBytes() const;
+
+private:
+    /** @brief A frame, laid out as it is sent */
+    struct Frame{
+        uint8_t header[FRAME_HEADER_SIZE];
+        uint32_t body[(MAX_GOAL_MESSAGE_SIZE + FRAME_CRC_SIZE) / 4];
+    };
+
+    static_assert(GOAL_MESSAGE_SIZE % 4 == 0, "The CRC is fed whole words");
+    static_assert(sizeof(Frame) == MAX_FRAME_SIZE, "Frame must not be padded");
+
+    /**
+     * @brief Looks for a header
+     * @return The number of bytes parsed
+     */
+    size_t findHeader(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Copies bytes into the frame being received, up to the end of
+     *        the frame or, if its size is not yet known, the end of the part
+     *        of the goal message that gives it
+     * @return The number of bytes parsed
+     */
+    size_t receiveFrame(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Checks the frame being received once enough of it is in, and
+     *        rejects it if it's bad
+     * @return true if the frame is complete and its CRC matched
+     */
+    bool checkFrame();
+
+    /** @brief Holds back all but the first byte of a frame to parse again */
+    void rejectFrame();
+
+    /** @brief Counts the skipped bytes, once a header is found */
+    void countDiscarded();
+
+    /** @see GoalFrameParser */
+    const Crc32Function m_crc;
+
+    /** @brief The frame being received, and the last good one */
+    Frame m_frames[2] = {};
+
+    /** @brief Index of the frame being received in m_frames */
+    uint8_t m_rxIdx = 0;
+
+    /**
+     * @brief Number of bytes of the frame being received so far, including
+     *        the header
+     */
+    size_t m_numFrameBytes = 0;
+
+    /** @brief Size of the frame being received, or 0 until it is known */
+    size_t m_frameSize = 0;
+
+    /** @see getGoalSize */
+    size_t m_goalSize = 0;
+
+    /**
+     * @brief Bytes held back from rejected frames. These are always the bytes
+     *        following the start of the last rejected frame, so there are
+     *        fewer than in a frame
+     */
+    uint8_t m_replay[MAX_FRAME_SIZE - 1] = {};
+
+    /** @brief Index of the next held back byte to parse in m_replay */
+    size_t m_replayIdx = 0;
+
+    /** @brief Number of bytes in m_replay */
+    size_t m_replaySize = 0;
+
+    /** @brief Bytes skipped since the last header */
+    uint32_t m_numSkipped = 0;
+
+    /** @see getNumFrames */
+    uint32_t m_numFrames = 0;
+
+    /** @see getNumCrcErrors */
+    uint32_t m_numCrcErrors = 0;
+
+    /** @see getNumUnknownMessages */
+    uint32_t m_numUnknownMessages = 0;
+
+    /** @see getNumResyncs */
+    uint32_t m_numResyncs = 0;
+
+    /** @see getNumDiscardedBytes */
+    uint32_t m_numDiscardedBytes = 0;
+};
+
+} // end namespace comm
+
+
+
+
+/**
+ * @}
+ */
+/* end - GoalFrameParser */
+
+#endif /* GOAL_FRAME_PARSER_H */
@@ -0,0 +1,64 @@
+/**
+  *****************************************************************************
+  * @file    HalTimerInterface.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup   HalTimerInterface
+  * @addtogroup Timer
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef HAL_TIMER_INTERFACE_H
+#define HAL_TIMER_INTERFACE_H
+
+
+
+
+/********************************* Includes **********************************/
+#include "TimerInterface.h"
+
+
+
+
+/**************************** HalTimerInterface ******************************/
+namespace timer{
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @class Concrete implementation of the abstract TimerInterface class, to be
+ *        used in production builds. The timer must already be counting up at
+ *        1 MHz with its auto-reload at the maximum, and its channels must be
+ *        in output compare timing mode
+ */
+class HalTimerInterface : public TimerInterface{
+public:
+    HalTimerInterface();
+    ~HalTimerInterface();
+
+    void startOneShot(
+        TIM_HandleTypeDef* htim,
+        uint32_t channel,
+        uint32_t delayUs
+    ) const override final;
+
+    void stopOneShot(
+        TIM_HandleTypeDef* htim,
+        uint32_t channel
+    ) const override final;
+};
+
+} // end namespace timer
+
+
+
+
+/**
+ * @}
+ */
+/* end - HalTimerInterface */
+
+#endif /* HAL_TIMER_INTERFACE_H */
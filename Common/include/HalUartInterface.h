@@ -76,6 +76,12 @@ public:
         size_t numBytes
     ) const override final;
 
+    HAL_StatusTypeDef receiveToIdleDMA(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint8_t* arrReceive,
+        size_t numBytes
+    ) const override final;
+
     __IO uint32_t getDmaRxInstanceNDTR(
         const UART_HandleTypeDef* uartHandlePtr
     ) const override final;
@@ -93,6 +99,26 @@ public:
     __IO uint32_t getErrorCode(
         const UART_HandleTypeDef* uartHandlePtr
     ) const override final;
+
+    HAL_StatusTypeDef setBaudRate(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint32_t baud
+    ) const override final;
+
+    uint32_t getBaudRate(
+        const UART_HandleTypeDef* uartHandlePtr
+    ) const override final;
+
+    uint32_t getAttainableBaudRate(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint32_t baud
+    ) const override final;
+
+    HAL_StatusTypeDef enableDriverEnable(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint8_t assertionTime,
+        uint8_t deassertionTime
+    ) const override final;
 };
 
 } // end namespace uart
@@ -100,6 +126,38 @@ public:
 
 
 
+// Functions
+// ----------------------------------------------------------------------------
+#if defined(THREADED)
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Handles the idle line interrupt of a UART receiving with
+ *        receiveToIdleDMA. Must be called from the UART's IRQ handler, since
+ *        HAL_UART_IRQHandler does not handle this interrupt
+ * @param huart The UART
+ */
+void UART_IdleLineIRQHandler(UART_HandleTypeDef* huart);
+
+/**
+ * @brief Called from UART_IdleLineIRQHandler when the line goes idle during a
+ *        reception started with receiveToIdleDMA. Named after the callback
+ *        of newer HAL versions, which have this feature built in
+ * @param huart The UART
+ * @param Size Number of bytes written into the reception buffer so far
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+
+
+
 /**
  * @}
  */
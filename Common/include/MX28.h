@@ -21,7 +21,7 @@
 
 
 /********************************* Includes **********************************/
-#include "Dynamixel.h"
+#include "MotorT.h"
 
 
 
@@ -70,7 +70,15 @@ constexpr float MX28_MAX_VELOCITY = 117.0;
 
 // Classes and structs
 // ----------------------------------------------------------------------------
-class MX28 : public Motor{
+/** @brief Compile-time description of the MX28. @see MotorT */
+struct MX28Traits{
+    static constexpr ResolutionDivider RESOLUTION = ResolutionDivider::MX28;
+    static constexpr float MAX_VELOCITY = MX28_MAX_VELOCITY;
+    static constexpr uint32_t MAX_BAUD_RATE = 3000000;
+    static constexpr bool SUPPORTS_BULK_READ = true;
+};
+
+class MX28 : public MotorT<MX28Traits>{
 public:
     /** @see Motor */
     MX28(
@@ -81,7 +89,6 @@ public:
     ~MX28();
 
 
-
     // Setters (use the WRITE DATA instruction)
     // ------------------------------------------------------------------------
 
@@ -96,16 +103,6 @@ public:
 
     // RAM
     // ------------------------------------------------------------------------
-    /**
-     * @brief Sets the goal velocity of the motor in RAM
-     * @param goalVelocity the goal velocity in RPM. Arguments of 0-117 are
-     *        valid when in joint mode. 0 corresponds to MAX motion in joint
-     *        mode, and minimum motion in wheel mode. In wheel mode, negative
-     *        arguments correspond to CW rotation
-     * @return true if successful, otherwise false
-     */
-    bool setGoalVelocity(float goalVelocity) const override;
-
     /**
      * @brief Sets the goal acceleration. The argument should be in units of
      *        degree/s^2. Direction is determined by the sign of the goal
@@ -146,16 +143,6 @@ public:
      * @return true if successful, otherwise false
      */
     bool setPGain(uint8_t PGain) const;
-
-
-    // Getters (use the READ DATA instruction)
-    // ------------------------------------------------------------------------
-    /**
-     * @brief Reads the angular velocity of the motor, in RPM
-     * @param[out] retVal R-val return type (not modified upon failure)
-     * @return true if successful, otherwise false
-     */
-    bool getVelocity(float& retVal) const override;
 };
 
 } // end namespace dynamixel
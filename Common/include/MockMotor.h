@@ -72,6 +72,13 @@ public:
             float& retVal
         )
     );
+
+    MOCK_CONST_METHOD1(
+        rawToVelocity,
+        float(
+            uint16_t raw
+        )
+    );
 };
 
 } // end namespace mocks
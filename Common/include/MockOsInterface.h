@@ -141,6 +141,8 @@ public:
             osSemaphoreId semaphore_id
         )
     );
+
+    MOCK_CONST_METHOD0(OS_xTaskGetTickCount, TickType_t());
 };
 
 } // end namespace mocks
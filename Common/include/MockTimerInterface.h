@@ -0,0 +1,66 @@
+/**
+  *****************************************************************************
+  * @file    MockTimerInterface.h
+  * @author  Tyler Gamvrelis
+  * @brief   Mocks hardware timer functions
+  *
+  * @defgroup MockTimerInterface
+  * @ingroup  Mocks
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef MOCK_TIMER_INTERFACE_H
+#define MOCK_TIMER_INTERFACE_H
+
+
+
+
+/********************************* Includes **********************************/
+#include "TimerInterface.h"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using timer::TimerInterface;
+
+
+
+
+/**************************** MockTimerInterface *****************************/
+namespace mocks{
+// Classes and structs
+// ----------------------------------------------------------------------------
+class MockTimerInterface : public TimerInterface{
+public:
+    MOCK_CONST_METHOD3(
+        startOneShot,
+        void(
+            TIM_HandleTypeDef*,
+            uint32_t,
+            uint32_t
+        )
+    );
+
+    MOCK_CONST_METHOD2(
+        stopOneShot,
+        void(
+            TIM_HandleTypeDef*,
+            uint32_t
+        )
+    );
+};
+
+} // end namespace mocks
+
+
+
+
+/**
+ * @}
+ */
+/* end - MockTimerInterface */
+
+#endif /* MOCK_TIMER_INTERFACE_H */
@@ -67,6 +67,11 @@ public:
         HAL_StatusTypeDef(const UART_HandleTypeDef*, uint8_t*, size_t)
     );
 
+    MOCK_CONST_METHOD3(
+        receiveToIdleDMA,
+        HAL_StatusTypeDef(const UART_HandleTypeDef*, uint8_t*, size_t)
+    );
+
     MOCK_CONST_METHOD3(
         transmitIT,
         HAL_StatusTypeDef(const UART_HandleTypeDef*, uint8_t*, size_t)
@@ -82,6 +87,23 @@ public:
 
     MOCK_CONST_METHOD1(getDmaRxInstanceNDTR, __IO uint32_t(const UART_HandleTypeDef*));
     MOCK_CONST_METHOD1(getErrorCode, __IO uint32_t(const UART_HandleTypeDef*));
+
+    MOCK_CONST_METHOD2(
+        setBaudRate,
+        HAL_StatusTypeDef(const UART_HandleTypeDef*, uint32_t)
+    );
+
+    MOCK_CONST_METHOD1(getBaudRate, uint32_t(const UART_HandleTypeDef*));
+
+    MOCK_CONST_METHOD2(
+        getAttainableBaudRate,
+        uint32_t(const UART_HandleTypeDef*, uint32_t)
+    );
+
+    MOCK_CONST_METHOD3(
+        enableDriverEnable,
+        HAL_StatusTypeDef(const UART_HandleTypeDef*, uint8_t, uint8_t)
+    );
 };
 
 } // end namespace mocks
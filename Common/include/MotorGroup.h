@@ -0,0 +1,394 @@
+/**
+  *****************************************************************************
+  * @file    MotorGroup.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup MotorGroup
+  * @brief Batches commands for all the motors on a daisy chain into single
+  *        packets
+  * @ingroup Dynamixel
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef MOTOR_GROUP_H
+#define MOTOR_GROUP_H
+
+
+
+
+/********************************* Includes **********************************/
+#include <array>
+#include <initializer_list>
+#include "Dynamixel.h"
+
+
+
+
+/******************************** MotorGroup *********************************/
+namespace dynamixel{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Maximum number of motors that can belong to a MotorGroup */
+constexpr size_t MAX_GROUP_SIZE = 6;
+
+
+
+
+// Types & enums
+// ----------------------------------------------------------------------------
+/** @brief The quantities that can be read from every motor in a group */
+enum class Telemetry : uint8_t{
+    POSITION,    /**< Angular position, in degrees                */
+    LOAD,        /**< Load, as a percentage of the maximum torque */
+    VOLTAGE,     /**< Supply voltage, in volts                    */
+    TEMPERATURE, /**< Internal temperature, in degrees Celsius    */
+    NUM_TELEMETRY
+};
+
+/** @brief Number of quantities in Telemetry */
+constexpr size_t NUM_TELEMETRY = static_cast<size_t>(Telemetry::NUM_TELEMETRY);
+
+/** @brief Largest number of readings that can be made from a group at once */
+constexpr size_t MAX_TELEMETRY_READS = MAX_GROUP_SIZE * NUM_TELEMETRY;
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/** @brief One reading of one quantity from one motor in a group */
+struct TelemetryRead{
+    uint8_t motorIdx; /**< Index of the motor in the group        */
+    Telemetry item;   /**< The quantity to read                   */
+    float value;      /**< [out] The reading                      */
+    bool isValid;     /**< [out] true if value holds a new reading */
+};
+
+/**
+ * @class MotorGroup Collection of motors attached to the same DaisyChain.
+ *        Commands issued through the group are packed into one broadcast
+ *        packet (e.g. SYNC_WRITE) instead of one packet per motor, so the
+ *        per-packet overhead (bus direction change, transfer setup, task
+ *        wake-up) is paid once per chain instead of once per motor
+ */
+class MotorGroup{
+public:
+    /**
+     * @brief MotorGroup constructor
+     * @param daisyChain I/O manager class for the port the motors are
+     *        attached to
+     * @param motors The motors in the group. The order of this list defines
+     *        the order of the values passed to the group commands. Motors
+     *        that are not attached to daisyChain, and motors beyond
+     *        MAX_GROUP_SIZE, are not added to the group
+     */
+    MotorGroup(
+        DaisyChain* daisyChain,
+        std::initializer_list<Motor*> motors
+    );
+
+    ~MotorGroup();
+
+    /**
+     * @brief Returns the number of motors in the group
+     * @return the number of motors in the group
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the motor at the specified position in the group
+     * @param idx The position of the motor in the group
+     * @return the motor if idx is valid, otherwise nullptr
+     */
+    Motor* motor(size_t idx) const;
+
+    /**
+     * @brief Sets the goal position of every motor in the group using a
+     *        single SYNC_WRITE instruction
+     * @details No status packet is returned for SYNC_WRITE, regardless of
+     *          the status return level of the motors. Motors whose shadow
+     *          control table already holds their goal are left out of the
+     *          packet, and if that leaves nothing to send, no packet is sent.
+     *          @see Motor::setShadowRefreshPeriod
+     * @param goalAngles Array of goal angles, one per motor in the order
+     *        the motors were given at construction. Arguments between 0 and
+     *        300 are valid
+     * @param numAngles The number of elements in goalAngles. Must be equal
+     *        to size()
+     * @return true if successful, otherwise false. Nothing is sent if any
+     *         of the goal angles are invalid
+     */
+    bool setGoalPositions(const float* goalAngles, size_t numAngles) const;
+
+    /**
+     * @brief Registers the goal position of every motor in the group using
+     *        one REG_WRITE instruction per motor. The motors do not start
+     *        moving until action() is called
+     * @details Staging goals on all chains first, then triggering them all
+     *          with action(), makes the motors on different chains start
+     *          moving at nearly the same time regardless of how long it took
+     *          to transfer the goals on each chain
+     * @param goalAngles Array of goal angles, one per motor in the order
+     *        the motors were given at construction. Arguments between 0 and
+     *        300 are valid
+     * @param numAngles The number of elements in goalAngles. Must be equal
+     *        to size()
+     * @return true if successful, otherwise false. Nothing is sent if any
+     *         of the goal angles are invalid
+     */
+    bool stageGoalPositions(const float* goalAngles, size_t numAngles) const;
+
+    /**
+     * @brief Broadcasts the ACTION instruction on the group's daisy chain,
+     *        which makes every motor on it execute the instruction it
+     *        registered through REG_WRITE
+     * @details No status packet is returned for broadcast instructions. If
+     *          the ACTION cannot be sent, the goal positions registered
+     *          since are forgotten by the shadow control table, so that the
+     *          next ones are sent even if they are unchanged
+     * @return true if successful, otherwise false
+     */
+    bool action() const;
+
+    /**
+     * @brief Returns whether goals have been staged on the group's daisy chain
+     *        and are waiting for action()
+     * @details While an ACTION is pending, the chain should not start any
+     *          other transfer (e.g. a read), since the ACTION would have to
+     *          wait for it and the chains would no longer start moving
+     *          together
+     * @return true from stageGoalPositions() until the next action(),
+     *         otherwise false
+     */
+    bool isActionPending() const;
+
+    /**
+     * @brief Reads the angular position of every motor in the group, in
+     *        degrees
+     * @details On a Protocol 2.0 daisy chain, a single FAST_SYNC_READ (or
+     *          SYNC_READ, @see useFastSyncRead) instruction is sent. On a
+     *          Protocol 1.0 daisy chain, if every motor in the group supports
+     *          BULK_READ, a single BULK_READ instruction is sent and the
+     *          status packets that the motors return back-to-back are
+     *          received in one transfer. Otherwise, each motor is read
+     *          individually
+     * @param[out] retVals Array of angles, one per motor in the order the
+     *             motors were given at construction. Entries for motors that
+     *             could not be read are not modified
+     * @param[out] isValid Array of flags, one per motor, set to true if the
+     *             corresponding entry in retVals was updated, otherwise false
+     * @param numVals The number of elements in retVals and isValid. Must be
+     *        equal to size()
+     * @return true if every motor was read successfully, otherwise false
+     */
+    bool getPositions(float* retVals, bool* isValid, size_t numVals) const;
+
+    /**
+     * @brief Makes a set of readings from the motors in the group
+     * @details If the position of every motor is asked for, the positions
+     *          are read together as for getPositions. The other readings are
+     *          made one register at a time
+     * @param[in,out] reads The readings to make. motorIdx and item are
+     *                inputs; value and isValid are outputs
+     * @param numReads The number of readings. At most MAX_TELEMETRY_READS
+     * @return true if every reading was made, otherwise false
+     */
+    bool readTelemetry(TelemetryRead* reads, size_t numReads) const;
+
+    /**
+     * @brief Estimates the bus time taken to read one quantity from one motor
+     *        on its own, from the bytes exchanged at the daisy chain's baud
+     *        rate plus a fixed allowance for the motor's return delay and the
+     *        turnaround of the bus
+     * @param item The quantity
+     * @return The estimate, in microseconds
+     */
+    uint32_t estimateReadTime(Telemetry item) const;
+
+    /**
+     * @brief Indicates whether group reads are done with one BULK_READ
+     *        instruction, rather than one READ_DATA instruction per motor
+     * @return true if the group is on a Protocol 1.0 daisy chain and every
+     *         motor in it supports BULK_READ, otherwise false
+     */
+    bool usesBulkRead() const;
+
+    /**
+     * @brief Selects the instruction used for group reads on a Protocol 2.0
+     *        daisy chain
+     * @details FAST_SYNC_READ gets every motor's data in one status packet,
+     *          which is the fastest option, but is only supported by recent
+     *          firmware and a single corrupted byte invalidates the data from
+     *          every motor. SYNC_READ has each motor reply with its own status
+     *          packet. Defaults to FAST_SYNC_READ
+     * @param enable true to use FAST_SYNC_READ, false to use SYNC_READ
+     */
+    void useFastSyncRead(bool enable);
+
+    /**
+     * @brief Pings the motors in rounds until every one of them has answered
+     *        once. Meant to be called right after power-up (or a brownout),
+     *        to start talking to the motors as soon as they have booted rather
+     *        than after a fixed delay
+     * @details Each round pings only the motors that have not answered yet.
+     *          A ping to a motor that is still booting fails after the
+     *          UART's max block time, which paces the rounds
+     * @param maxRounds The number of rounds after which to give up
+     * @return true if every motor answered, otherwise false
+     */
+    bool waitUntilReady(uint16_t maxRounds) const;
+
+    /**
+     * @brief Switches the group's daisy chain to the fastest baud rate that
+     *        every motor in the group and the UART support
+     * @details Meant to be called once at boot, with polled IO. First, every
+     *          motor is pinged at the UART's current baud rate. If they do not
+     *          all respond, the other rates are scanned in case a previous
+     *          boot already switched them, and the rate they are found at is
+     *          kept without trying any other. Otherwise, the supported rates
+     *          above the current one are tried slowest first: the motors are
+     *          told to switch, the UART is reconfigured, and every motor is
+     *          pinged again. At the first rate where any ping fails, the
+     *          motors and the UART are switched back to the last rate that
+     *          worked, and no faster rate is tried. So a rate the chain can't
+     *          hold is tried (and written to EEPROM) at most once per boot,
+     *          and only until the chain is left at a faster rate than the
+     *          UART starts at. Only Protocol 1.0 daisy chains are supported
+     * @note The baud rate is stored in the motors' EEPROM, so firmware that
+     *       does not negotiate will not be able to talk to them afterward
+     *       unless its UART is configured for the negotiated rate
+     * @return true if every motor responds at the baud rate in use upon
+     *         return, otherwise false
+     */
+    bool negotiateBaudRate() const;
+
+private:
+    /**
+     * @brief Writes data of the same length to the same address in every
+     *        motor of the group using the SYNC_WRITE instruction
+     * @param addr The control table address to write to, in the control table
+     *        of the protocol spoken on the daisy chain
+     * @param dataLen The number of bytes to write to each motor
+     * @param data The bytes to write, of the form `{M1_PARAM_1, ...,
+     *        M1_PARAM_L, ..., MN_PARAM_1, ..., MN_PARAM_L}` where N = size()
+     *        and L = dataLen
+     * @param isIncluded Array of flags, one per motor, set to true if the
+     *        motor's data is to be sent. If nullptr, every motor is included
+     * @return true if successful, otherwise false
+     */
+    bool syncWriter(
+        uint16_t addr,
+        uint8_t dataLen,
+        const uint8_t* data,
+        const bool* isIncluded = nullptr
+    ) const;
+
+    /**
+     * @brief Reads data of the same length from the same address in every
+     *        motor of the group using the BULK_READ instruction
+     * @details The status packets returned by the motors are validated
+     *          independently, so a motor which fails to respond (or responds
+     *          with a corrupted packet) does not invalidate the data received
+     *          from the motors before it
+     * @param readAddr The address inside the motor memory table where reading
+     *        is to begin
+     * @param readLength The number of bytes to be read. Must be either 1 or 2
+     * @param[out] retVals Array of raw values, one per motor
+     * @param[out] isValid Array of flags, one per motor, set to true if the
+     *             corresponding entry in retVals was received successfully
+     * @return true if all motors were read successfully, otherwise false
+     */
+    bool bulkReader(
+        uint8_t readAddr,
+        uint8_t readLength,
+        uint16_t* retVals,
+        bool* isValid
+    ) const;
+
+    /** @brief A read of one register from one motor in the group */
+    struct RegisterRead{
+        uint8_t motorIdx; /**< Index of the motor in the group        */
+        uint8_t addr;     /**< Address of the register                */
+        uint8_t length;   /**< Width of the register. Either 1 or 2   */
+        uint16_t value;   /**< [out] The raw value                    */
+        bool isValid;     /**< [out] true if value was read           */
+    };
+
+    /**
+     * @brief Converts a raw register value into a reading
+     * @param motorIdx Index of the motor the value was read from
+     * @param item The quantity the value is for
+     * @param raw The raw value
+     * @return The reading, in the units of item
+     */
+    float decodeTelemetry(
+        size_t motorIdx,
+        Telemetry item,
+        uint16_t raw
+    ) const;
+
+    /**
+     * @brief Reads data of the same length from the same address in every
+     *        motor of the group using the Protocol 2.0 FAST_SYNC_READ or
+     *        SYNC_READ instruction. @see useFastSyncRead
+     * @param readAddr The address inside the Protocol 2.0 control table where
+     *        reading is to begin
+     * @param readLength The number of bytes to be read. Must be in the range
+     *        [1, 4]
+     * @param[out] retVals Array of raw values, one per motor
+     * @param[out] isValid Array of flags, one per motor, set to true if the
+     *             corresponding entry in retVals was received successfully
+     * @return true if all motors were read successfully, otherwise false
+     */
+    bool syncReader2(
+        uint16_t readAddr,
+        uint8_t readLength,
+        uint32_t* retVals,
+        bool* isValid
+    ) const;
+
+    /**
+     * @brief Pings every motor in the group, retrying a few times each
+     * @return true if every motor responded with its own ID, otherwise false
+     */
+    bool pingAll() const;
+
+    /**
+     * @brief Moves the motors and the UART from one baud rate to another,
+     *        then checks that every motor responds at the new one
+     * @param baud The new baud rate. The UART must already be at the rate the
+     *        motors are listening at
+     * @return true if every motor responds at the new baud rate, otherwise
+     *         false. The UART is left at the new baud rate either way
+     */
+    bool switchBaudRate(uint32_t baud) const;
+
+    const DaisyChain* daisyChain;                /**< @see DaisyChain       */
+    std::array<Motor*, MAX_GROUP_SIZE> m_motors; /**< Motors in the group   */
+    size_t m_numMotors;                          /**< Size of m_motors used */
+
+    /** @brief true if every motor in the group supports BULK_READ */
+    bool m_supportsBulkRead;
+
+    /** @brief true if Protocol 2.0 reads use FAST_SYNC_READ */
+    bool m_useFastSyncRead;
+
+    /** @brief @see isActionPending */
+    mutable bool m_actionPending;
+};
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - MotorGroup */
+
+#endif /* MOTOR_GROUP_H */
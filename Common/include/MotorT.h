@@ -0,0 +1,179 @@
+/**
+  *****************************************************************************
+  * @file    MotorT.h
+  * @author  Tyler
+  *
+  * @defgroup MotorT
+  * @brief Motor base class specialized at compile time for one actuator
+  *        model. The model's resolution, limits, and scale factors are
+  *        given as constexpr traits, so the conversions to and from raw
+  *        register codes reduce to multiplications by constants
+  * @ingroup Dynamixel
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef MOTOR_T_H
+#define MOTOR_T_H
+
+
+
+
+/********************************* Includes **********************************/
+#include "Dynamixel.h"
+
+
+
+
+/********************************** MotorT ***********************************/
+namespace dynamixel{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Largest magnitude of a raw velocity code (bits 0-9) */
+constexpr uint16_t MAX_RAW_VELOCITY = 1023;
+
+/** @brief Direction bit of a raw velocity code, set for CW rotation */
+constexpr uint16_t RAW_VELOCITY_CW_BIT = 0x400;
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @brief Motor whose model-specific behaviour is fixed at compile time
+ * @details Traits must provide:
+ *          - `RESOLUTION`: the model's ResolutionDivider
+ *          - `MAX_VELOCITY`: the velocity in RPM that a raw code of
+ *            MAX_RAW_VELOCITY corresponds to
+ *          - `SUPPORTS_BULK_READ`: whether the model supports BULK_READ
+ *          - `MAX_BAUD_RATE`: the fastest baud rate the model supports
+ *
+ *          Overrides are final, so calls made through a reference to the
+ *          model class bind statically. Code holding a Motor* keeps working
+ *          unchanged
+ * @tparam Traits The model's traits (e.g. AX12ATraits, MX28Traits)
+ */
+template<class Traits>
+class MotorT : public Motor{
+public:
+    /** @brief Raw velocity code magnitude per RPM */
+    static constexpr float TICKS_PER_RPM =
+        (MAX_RAW_VELOCITY + 0.01f) / Traits::MAX_VELOCITY;
+
+    /** @brief RPM per unit of raw velocity code magnitude */
+    static constexpr float RPM_PER_TICK =
+        Traits::MAX_VELOCITY / MAX_RAW_VELOCITY;
+
+    /** @see Motor */
+    MotorT(uint8_t id, DaisyChain* daisyChain)
+        :   Motor(id, daisyChain, Traits::RESOLUTION)
+    {
+
+    }
+
+    /** @see Motor */
+    bool supportsBulkRead() const override final{
+        return Traits::SUPPORTS_BULK_READ;
+    }
+
+    /** @see Motor */
+    uint32_t getMaxBaudRate() const override final{
+        return Traits::MAX_BAUD_RATE;
+    }
+
+    /**
+     * @brief Sets the goal velocity of the motor in RAM
+     * @param goalVelocity the goal velocity in RPM. Arguments in range
+     *        [MIN_VELOCITY, Traits::MAX_VELOCITY] are valid when in joint
+     *        mode. 0 corresponds to MAX motion in joint mode, and minimum
+     *        motion in wheel mode. In wheel mode, negative arguments
+     *        correspond to CW rotation
+     * @return true if successful, otherwise false
+     */
+    bool setGoalVelocity(float goalVelocity) const override final{
+        if(m_isJointMode){
+            if((goalVelocity < MIN_VELOCITY) ||
+               (goalVelocity > Traits::MAX_VELOCITY))
+            {
+                return false;
+            }
+        }
+
+        uint16_t normalized_value;
+        if(goalVelocity > 0){
+            normalized_value = static_cast<uint16_t>(
+                goalVelocity * TICKS_PER_RPM
+            );
+        }
+        else{
+            normalized_value = static_cast<uint16_t>(
+                -goalVelocity * TICKS_PER_RPM
+            );
+
+            normalized_value |= RAW_VELOCITY_CW_BIT;
+        }
+
+        uint8_t lowByte = static_cast<uint8_t>(normalized_value & 0xFF);
+        uint8_t highByte = static_cast<uint8_t>((normalized_value >> 8) & 0xFF);
+
+        // Write data to motor
+        uint8_t args[3] = {REG_GOAL_VELOCITY, lowByte, highByte};
+        return dataWriter(args, sizeof(args));
+    }
+
+    /**
+     * @brief Reads the angular velocity of the motor, in RPM
+     * @param[out] retVal R-val return type (not modified upon failure)
+     * @return true if successful, otherwise false
+     */
+    bool getVelocity(float& retVal) const override final{
+        uint16_t raw = 0;
+        bool success = dataReader(REG_CURRENT_VELOCITY, 2, raw);
+
+        if(!success){
+            return false;
+        }
+
+        retVal = rawToVelocity(raw);
+
+        return success;
+    }
+
+protected:
+    /**
+     * @brief Converts a raw velocity code into RPM, where a magnitude of
+     *        MAX_RAW_VELOCITY corresponds to Traits::MAX_VELOCITY
+     * @param raw The raw velocity code (bit 10 is the direction bit)
+     * @return The angular velocity in RPM. CW rotation is negative
+     */
+    float rawToVelocity(uint16_t raw) const override final{
+        float retVal = (raw & MAX_RAW_VELOCITY) * RPM_PER_TICK;
+        if(raw & RAW_VELOCITY_CW_BIT){
+            retVal *= -1;
+        }
+
+        return retVal;
+    }
+};
+
+template<class Traits>
+constexpr float MotorT<Traits>::TICKS_PER_RPM;
+
+template<class Traits>
+constexpr float MotorT<Traits>::RPM_PER_TICK;
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - MotorT */
+
+#endif /* MOTOR_T_H */
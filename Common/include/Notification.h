@@ -35,6 +35,7 @@
 #define NOTIFIED_FROM_TX_ISR 0x80   /**< Notification from a transmitter ISR */
 #define NOTIFIED_FROM_RX_ISR 0x20   /**< Notification from a receiver ISR    */
 #define NOTIFIED_FROM_TASK 0x40     /**< Notification from another task      */
+#define NOTIFIED_FROM_TIMER_ISR 0x10 /**< Notification from a timer ISR      */
 
 
 // Timeouts
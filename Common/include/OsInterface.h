@@ -98,6 +98,8 @@ public:
     virtual osStatus OS_osSemaphoreRelease (
             osSemaphoreId semaphore_id
     ) const = 0;
+
+    virtual TickType_t OS_xTaskGetTickCount() const = 0;
 };
 
 } // end namespace os
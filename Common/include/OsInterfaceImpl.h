@@ -99,6 +99,8 @@ public:
      osStatus OS_osSemaphoreRelease (
         osSemaphoreId semaphore_id
     ) const override final;
+
+    TickType_t OS_xTaskGetTickCount() const override final;
 };
 
 } // end namespace os
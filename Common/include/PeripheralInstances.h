@@ -23,12 +23,18 @@
 #include <array>
 #include "AX12A.h"
 #include "MX28.h"
+#include "MotorGroup.h"
 #include "MPU6050.h"
+#include "ReturnDelayTuner.h"
+#include "TelemetryScheduler.h"
 
 using std::array;
 using dynamixel::Motor;
 using dynamixel::AX12A;
 using dynamixel::MX28;
+using dynamixel::MotorGroup;
+using dynamixel::ReturnDelayTuner;
+using dynamixel::TelemetryScheduler;
 using imu::MPU6050;
 
 
@@ -43,6 +49,17 @@ using imu::MPU6050;
 
 /************************** insert module name here **************************/
 namespace periph{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Rate at which the motor readings are scheduled, in Hz. Matches the
+ *        period of the MotorCmdGen thread
+ */
+constexpr uint32_t TELEMETRY_CYCLE_RATE_HZ = 500;
+
+
+
+
 // Types & enums
 // ----------------------------------------------------------------------------
 enum motorNames_e : uint8_t {
@@ -67,12 +84,28 @@ enum motorNames_e : uint8_t {
     NUM_MOTORS
 };
 
+/**
+ * @brief Names of the motor daisy chains. These are ordered such that the
+ *        motors in each chain follow on from those in the previous chain
+ */
+enum chainNames_e : uint8_t {
+    LOWER_RIGHT_LEG, /**< MOTOR1 - MOTOR3   */
+    UPPER_RIGHT_LEG, /**< MOTOR4 - MOTOR6   */
+    UPPER_LEFT_LEG,  /**< MOTOR7 - MOTOR9   */
+    LOWER_LEFT_LEG,  /**< MOTOR10 - MOTOR12 */
+    HEAD_AND_ARMS,   /**< MOTOR13 - MOTOR18 */
+    NUM_CHAINS
+};
+
 
 
 
 // Variables
 // ----------------------------------------------------------------------------
 extern std::array<Motor*, 18> motors;
+extern std::array<MotorGroup*, NUM_CHAINS> motorGroups;
+extern std::array<ReturnDelayTuner*, NUM_CHAINS> returnDelayTuners;
+extern std::array<TelemetryScheduler*, NUM_CHAINS> telemetrySchedulers;
 extern MPU6050 imuData;
 
 
@@ -86,6 +119,78 @@ extern MPU6050 imuData;
  */
 void initMotorIOType(IO_Type io_type);
 
+/**
+ * @brief Sets up the bus direction control of all the motor daisy chains,
+ *        leaving their buses in RX. Must be called before any other
+ *        communication with the motors
+ * @return true if every chain uses the direction control it was configured
+ *         for, otherwise false (those that don't fall back to software)
+ */
+bool initMotorDirectionControl();
+
+/**
+ * @brief Releases the bus of the motor daisy chain driven by a UART, for
+ *        chains using DirectionControl::TC_INTERRUPT. Called from the UART
+ *        transmission complete callback
+ * @param huart The UART whose transmission completed
+ * @return false if the thread using the UART is waiting for a reply rather
+ *         than for the transmission, and must not be notified, otherwise
+ *         true
+ */
+bool onMotorTransmitComplete(const UART_HandleTypeDef* huart);
+
+/**
+ * @brief Counts a lap of the streaming reception of the motor daisy chain
+ *        driven by a UART, so that overruns of its buffer are detected.
+ *        Called from the UART reception complete callback
+ * @param huart The UART whose circular DMA wrapped around
+ */
+void onMotorStreamWrapped(const UART_HandleTypeDef* huart);
+
+/**
+ * @brief Starts streaming reception on all the motor daisy chains. The motors
+ *        must already be using DMA
+ */
+void initMotorStreaming();
+
+/**
+ * @brief Brings up the motors on one daisy chain: pings them until they have
+ *        all booted, then configures them with one broadcast write per
+ *        setting. Meant to be run by the chain's UART thread, so that the
+ *        chains are brought up concurrently
+ * @param chain The daisy chain. @see chainNames_e
+ * @return true if every motor answered and every write went out, otherwise
+ *         false
+ */
+bool bringUpChain(uint8_t chain);
+
+/**
+ * @brief Sets the rate at which each quantity is read from the motors on
+ *        every daisy chain
+ */
+void initTelemetrySchedules();
+
+/**
+ * @brief Starts the DWT cycle counter, which times the reads made by the
+ *        return delay tuners and the motor UARTs' microsecond timeouts
+ */
+void initCycleCounter();
+
+/**
+ * @brief Starts the timers that wake up the motor UART threads once their
+ *        microsecond timeouts run out, and gives each motor UART a channel.
+ *        Must be called before the UART threads start
+ */
+void initWakeupTimers();
+
+/**
+ * @brief Returns the motor UART whose thread a wakeup timer channel is for.
+ *        Called from the timer's output compare callback
+ * @param htim The timer, whose Channel holds the channel that fired
+ * @return The UART, or nullptr if the channel isn't a wakeup timer's
+ */
+const UART_HandleTypeDef* getWakeupTimerUart(const TIM_HandleTypeDef* htim);
+
 } // end namespace periph
 
 
@@ -0,0 +1,150 @@
+/**
+  *****************************************************************************
+  * @file    ReturnDelayTuner.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup ReturnDelayTuner
+  * @brief Finds the smallest return delay time at which each motor in a group
+  *        still answers reads reliably
+  * @ingroup Dynamixel
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef RETURN_DELAY_TUNER_H
+#define RETURN_DELAY_TUNER_H
+
+
+
+
+/********************************* Includes **********************************/
+#include "MotorGroup.h"
+
+
+
+
+/***************************** ReturnDelayTuner ******************************/
+namespace dynamixel{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Default number of reads made at each candidate return delay */
+constexpr uint16_t DEFAULT_RETURN_DELAY_TRIALS = 50;
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/** @brief Read statistics for one motor at one return delay time */
+struct ReturnDelayStats{
+    uint16_t delay = 0; /**< Return delay time, in microseconds */
+    uint16_t numTrials = 0; /**< Number of reads made */
+    uint16_t numSuccesses = 0; /**< Number of reads that were answered */
+    uint32_t meanLatency = 0; /**< Mean duration of the answered reads, in
+                                   cycle counter ticks */
+
+    /** @brief Whether every read was answered */
+    bool isReliable() const{
+        return (numTrials != 0) && (numSuccesses == numTrials);
+    }
+};
+
+/**
+ * @class ReturnDelayTuner Sweeps the return delay time of each motor in a
+ *        group downwards, making a series of 1-byte reads at each step, and
+ *        settles on the smallest delay at which every read was answered. The
+ *        shorter the delay, the less time each read holds up the bus, but if
+ *        it is shorter than the time the UART takes to turn the bus around,
+ *        the start of the status packet is lost
+ * @details Tuning should be done in the I/O mode the motors will be used in,
+ *          since the turnaround time depends on it. The return delay time
+ *          register is in the motors' EEPROM, so every step of the sweep is
+ *          an EEPROM write
+ */
+class ReturnDelayTuner{
+public:
+    /**
+     * @brief ReturnDelayTuner constructor
+     * @param group The motors to tune
+     * @param readCycles Returns the current value of a free-running cycle
+     *        counter, used to time the reads (e.g. the DWT cycle counter)
+     * @param numTrials Number of reads made at each candidate return delay
+     */
+    ReturnDelayTuner(
+        MotorGroup* group,
+        uint32_t (*readCycles)(void),
+        uint16_t numTrials = DEFAULT_RETURN_DELAY_TRIALS
+    );
+
+    ~ReturnDelayTuner() {}
+
+    /**
+     * @brief Tunes every motor in the group. The results are available
+     *        through result() afterwards
+     * @param persist If true, each motor is left at its tuned return delay,
+     *        which is kept in its EEPROM. If false, each motor is restored to
+     *        its original return delay, and the sweep is only a measurement
+     * @return true if a reliable return delay was found for every motor,
+     *         otherwise false
+     */
+    bool tune(bool persist);
+
+    /**
+     * @brief Tunes one motor
+     * @param motor The motor to tune
+     * @param[out] best The statistics at the smallest reliable return delay.
+     *             Not modified if none was found
+     * @param persist See tune(bool)
+     * @return true if a reliable return delay was found, otherwise false. A
+     *         motor for which none was found is left at its original return
+     *         delay
+     */
+    bool tuneMotor(
+        const Motor& motor,
+        ReturnDelayStats& best,
+        bool persist
+    ) const;
+
+    /**
+     * @brief Makes numTrials reads at the motor's current return delay
+     * @param motor The motor to read from
+     * @param[out] stats The read statistics. The delay field is not modified
+     */
+    void measure(const Motor& motor, ReturnDelayStats& stats) const;
+
+    /**
+     * @brief Gets the result of the last call to tune(bool) for a motor
+     * @param idx The index of the motor in the group
+     * @return The statistics at the motor's smallest reliable return delay,
+     *         or a default-constructed (unreliable) entry if none was found
+     */
+    const ReturnDelayStats& result(size_t idx) const;
+
+private:
+    /** @brief The motors to tune */
+    MotorGroup* m_group = nullptr;
+
+    /** @brief Cycle counter used to time the reads */
+    uint32_t (*m_readCycles)(void) = nullptr;
+
+    /** @brief Number of reads made at each candidate return delay */
+    uint16_t m_numTrials = DEFAULT_RETURN_DELAY_TRIALS;
+
+    /** @brief Results of the last call to tune(bool), in group order */
+    ReturnDelayStats m_results[MAX_GROUP_SIZE];
+};
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - ReturnDelayTuner */
+
+#endif /* RETURN_DELAY_TUNER_H */
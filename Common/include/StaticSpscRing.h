@@ -0,0 +1,236 @@
+/**
+  *****************************************************************************
+  * @file    StaticSpscRing.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup StaticSpscRing
+  * @brief Lock-free ring buffer for handing data from one producer (e.g. an
+  *        ISR) to one consumer (e.g. a thread) without kernel calls
+  * @ingroup Buffer
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef STATIC_SPSC_RING_H
+#define STATIC_SPSC_RING_H
+
+
+
+
+/********************************* Includes **********************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+
+
+
+/****************************** StaticSpscRing *******************************/
+namespace buffer{
+// Types & enums
+// ----------------------------------------------------------------------------
+/**
+ * @brief Called by the producer when it puts data into an empty ring, e.g. to
+ *        notify the consumer's thread from an ISR
+ * @param context The context given along with the notifier
+ */
+using SpscNotifier = void (*)(void* context);
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @class StaticSpscRing Fixed-size FIFO shared by exactly one producer and one
+ *        consumer, which may run in different threads or in an ISR
+ * @details The producer only ever writes m_head and the consumer only ever
+ *          writes m_tail, so neither needs a lock. Both indices run freely
+ *          and wrap around at 2^32, which N divides since it is a power of 2;
+ *          the ring is full when they are N apart. An element is published
+ *          by storing m_head with release semantics after writing it, and
+ *          the consumer loads m_head with acquire semantics before reading
+ *          it (and the other way around for freeing slots). On Cortex-M these
+ *          compile to plain loads and stores fenced by DMB, which also
+ *          drains the Cortex-M7 write buffer
+ * @tparam T Element type. Copied in and out, so keep it small
+ * @tparam N Number of elements, which must be a power of 2
+ */
+template<typename T, size_t N>
+class StaticSpscRing{
+    static_assert((N >= 2) && ((N & (N - 1)) == 0), "N must be a power of 2");
+    static_assert(N <= (static_cast<uint32_t>(1) << 31), "N is too large");
+
+public:
+    StaticSpscRing() {}
+    ~StaticSpscRing() {}
+
+    StaticSpscRing(const StaticSpscRing&) = delete;
+    StaticSpscRing& operator=(const StaticSpscRing&) = delete;
+
+    /**
+     * @brief Sets the function the producer calls when the ring goes from
+     *        empty to non-empty. Set it before either side starts using the
+     *        ring
+     * @param notifier The function. nullptr disables notifications
+     * @param context Passed to notifier
+     */
+    void setNotifier(SpscNotifier notifier, void* context){
+        m_notifier = notifier;
+        m_notifierContext = context;
+    }
+
+    /**
+     * @brief Appends an element. Producer only
+     * @param item The element
+     * @return false if the ring is full, in which case the element is dropped
+     */
+    bool push(const T& item){
+        return write(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Appends as many elements as fit. Producer only
+     * @param items The elements
+     * @param numItems The number of elements
+     * @return The number of elements appended. The rest are dropped
+     */
+    size_t write(const T* items, size_t numItems){
+        const uint32_t head = m_head.load(std::memory_order_relaxed);
+        const uint32_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t numFree = N - static_cast<size_t>(head - tail);
+
+        const size_t n = (numItems < numFree) ? numItems : numFree;
+        for(size_t i = 0; i < n; ++i){
+            m_data[(head + i) & MASK] = items[i];
+        }
+
+        if(n < numItems){
+            m_numDropped.store(
+                m_numDropped.load(std::memory_order_relaxed) + (numItems - n),
+                std::memory_order_relaxed
+            );
+        }
+
+        if(n == 0){
+            return 0;
+        }
+
+        m_head.store(head + n, std::memory_order_release);
+
+        if(m_notifier != nullptr){
+            // Pairs with the fence in read, so that either the consumer sees
+            // the new elements, or this sees that it emptied the ring and
+            // notifies it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(m_tail.load(std::memory_order_relaxed) == head){
+                m_notifier(m_notifierContext);
+            }
+        }
+
+        return n;
+    }
+
+    /**
+     * @brief Removes the oldest element. Consumer only
+     * @param[out] item The element
+     * @return false if the ring is empty
+     */
+    bool pop(T& item){
+        return read(&item, 1) == 1;
+    }
+
+    /**
+     * @brief Removes up to maxItems of the oldest elements. Consumer only
+     * @param[out] items The elements, oldest first
+     * @param maxItems The capacity of items
+     * @return The number of elements removed
+     */
+    size_t read(T* items, size_t maxItems){
+        const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint32_t head = m_head.load(std::memory_order_acquire);
+        const size_t numUsed = static_cast<size_t>(head - tail);
+
+        const size_t n = (maxItems < numUsed) ? maxItems : numUsed;
+        for(size_t i = 0; i < n; ++i){
+            items[i] = m_data[(tail + i) & MASK];
+        }
+
+        if(n == 0){
+            return 0;
+        }
+
+        m_tail.store(tail + n, std::memory_order_release);
+
+        if(m_notifier != nullptr){
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        return n;
+    }
+
+    /**
+     * @brief Returns true if there are no elements. Exact from the consumer's
+     *        side, and may lag the other side's latest operation otherwise
+     */
+    bool empty() const{
+        return size() == 0;
+    }
+
+    /** @brief Returns the number of elements. @see empty */
+    size_t size() const{
+        const uint32_t tail = m_tail.load(std::memory_order_acquire);
+        const uint32_t head = m_head.load(std::memory_order_acquire);
+        return static_cast<size_t>(head - tail);
+    }
+
+    /** @brief Returns the number of elements the ring holds when full */
+    static constexpr size_t capacity(){
+        return N;
+    }
+
+    /**
+     * @brief Returns the number of elements the producer dropped because the
+     *        ring was full, since construction
+     */
+    uint32_t getNumDropped() const{
+        return m_numDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    /** @brief Maps the free-running indices onto m_data */
+    static constexpr uint32_t MASK = static_cast<uint32_t>(N - 1);
+
+    /** @brief Index of the next element to write. Written by the producer */
+    std::atomic<uint32_t> m_head{0};
+
+    /** @brief Index of the next element to read. Written by the consumer */
+    std::atomic<uint32_t> m_tail{0};
+
+    /** @see getNumDropped. Written by the producer */
+    std::atomic<uint32_t> m_numDropped{0};
+
+    /** @see setNotifier */
+    SpscNotifier m_notifier = nullptr;
+
+    /** @see setNotifier */
+    void* m_notifierContext = nullptr;
+
+    /** @brief The elements */
+    T m_data[N];
+};
+
+} // end namespace buffer
+
+
+
+
+/**
+ * @}
+ */
+/* end - StaticSpscRing */
+
+#endif /* STATIC_SPSC_RING_H */
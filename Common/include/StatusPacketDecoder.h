@@ -0,0 +1,184 @@
+/**
+  *****************************************************************************
+  * @file    StatusPacketDecoder.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup StatusPacketDecoder
+  * @brief Incremental decoder that picks valid status packets out of a stream
+  *        of received bytes
+  * @ingroup Dynamixel
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef STATUS_PACKET_DECODER_H
+#define STATUS_PACKET_DECODER_H
+
+
+
+
+/********************************* Includes **********************************/
+#include "DynamixelProtocol.h"
+
+
+
+
+/**************************** StatusPacketDecoder ****************************/
+namespace dynamixel{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Largest status packet the decoder accepts, in bytes. Packets whose
+ *        LENGTH field claims more than this are treated as line noise
+ */
+constexpr size_t MAX_STATUS_PACKET_SIZE = 64;
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/** @brief A status packet that passed its integrity check */
+struct StatusPacket{
+    uint8_t id;            /**< ID of the motor that sent the packet */
+    uint8_t error;         /**< The motor's ERROR byte               */
+    const uint8_t* params; /**< The parameters after the ERROR byte,
+                                unstuffed. Only valid until the
+                                handler returns                      */
+    size_t numParams;      /**< Number of parameters                 */
+};
+
+/**
+ * @class StatusPacketDecoder Consumes received bytes in chunks of any size
+ *        and reports each complete, valid status packet as soon as its last
+ *        byte is fed in
+ * @details Bytes are scanned for the packet header, and the LENGTH field and
+ *          checksum (Protocol 1.0) or CRC (Protocol 2.0) are checked before
+ *          a packet is reported. When a check fails, only the first byte of
+ *          the would-be header is dropped and the scan resumes from the next
+ *          one, so a dropped or extra byte costs at most one packet instead
+ *          of desynchronizing everything after it. Back-to-back packets of
+ *          different lengths are reported one by one
+ */
+class StatusPacketDecoder{
+public:
+    /**
+     * @brief Called for each valid status packet
+     * @param packet The packet
+     * @param context The context pointer passed to setHandler
+     */
+    using Handler = void (*)(const StatusPacket& packet, void* context);
+
+    /**
+     * @brief StatusPacketDecoder constructor
+     * @param protocol The protocol the packets are framed with
+     */
+    StatusPacketDecoder(Protocol protocol);
+
+    ~StatusPacketDecoder() {}
+
+    /**
+     * @brief Sets the function that valid packets are reported to
+     * @param handler The function, or nullptr to drop valid packets
+     * @param context Passed through to handler
+     */
+    void setHandler(Handler handler, void* context);
+
+    /**
+     * @brief Consumes received bytes, reporting each packet they complete
+     * @param data The received bytes
+     * @param len The number of bytes
+     * @return The number of valid packets reported
+     */
+    size_t feed(const uint8_t* data, size_t len);
+
+    /** @brief Discards any partially received packet */
+    void reset();
+
+    /** @brief Returns the number of valid packets reported */
+    uint32_t getNumPackets() const;
+
+    /** @brief Returns the number of headers whose checksum or CRC failed */
+    uint32_t getNumChecksumErrors() const;
+
+    /** @brief Returns the number of bytes dropped while resynchronizing */
+    uint32_t getNumDiscardedBytes() const;
+
+private:
+    /** @brief Outcome of looking for a packet at the start of the buffer */
+    enum class Framing{
+        COMPLETE,   /**< A whole packet is buffered, pending integrity check */
+        INCOMPLETE, /**< More bytes are needed to tell                       */
+        INVALID     /**< The first byte cannot start a packet                */
+    };
+
+    /**
+     * @brief Decodes as many packets as possible from the buffered bytes
+     * @return The number of valid packets reported
+     */
+    size_t process();
+
+    /**
+     * @brief Checks the header and LENGTH field of a Protocol 1.0 packet at
+     *        the start of the buffer
+     * @param[out] packetLen The length of the packet, if COMPLETE
+     * @return @see Framing
+     */
+    Framing frame1(size_t& packetLen) const;
+
+    /** @brief Protocol 2.0 version of frame1. @see frame1 */
+    Framing frame2(size_t& packetLen) const;
+
+    /**
+     * @brief Checks the integrity of the packet at the start of the buffer
+     * @param packetLen The length of the packet
+     * @param[out] packet The decoded packet, if valid
+     * @return true if the checksum or CRC is valid, otherwise false
+     */
+    bool validate(size_t packetLen, StatusPacket& packet);
+
+    /**
+     * @brief Drops bytes from the start of the buffer
+     * @param n The number of bytes to drop
+     */
+    void drop(size_t n);
+
+    /** @brief Protocol the packets are framed with */
+    const Protocol m_protocol;
+
+    /** @brief Function that valid packets are reported to */
+    Handler m_handler = nullptr;
+
+    /** @brief Passed through to m_handler */
+    void* m_context = nullptr;
+
+    /** @brief Bytes received since the end of the last packet */
+    uint8_t m_buf[MAX_STATUS_PACKET_SIZE];
+
+    /** @brief Number of bytes in m_buf */
+    size_t m_len = 0;
+
+    /** @see getNumPackets */
+    uint32_t m_numPackets = 0;
+
+    /** @see getNumChecksumErrors */
+    uint32_t m_numChecksumErrors = 0;
+
+    /** @see getNumDiscardedBytes */
+    uint32_t m_numDiscardedBytes = 0;
+};
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - StatusPacketDecoder */
+
+#endif /* STATUS_PACKET_DECODER_H */
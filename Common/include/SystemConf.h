@@ -53,6 +53,67 @@ extern UART_HandleTypeDef huart6;
  */
 #define THREADED
 
+/**
+ * @brief Flag for whether goal positions are staged on every daisy chain
+ * with REG_WRITE and then triggered together with ACTION, rather than being
+ * executed as soon as each chain's SYNC_WRITE arrives. This makes the motors
+ * on different chains start moving at nearly the same time, at the cost of
+ * one packet per motor instead of one packet per chain. Once a chain has
+ * staged its goals it starts no more reads until its ACTION is sent, so the
+ * ACTIONs go out back to back
+ */
+#define USE_SYNCHRONIZED_MOTION
+
+/**
+ * @brief Flag for whether the motor daisy chains are switched at boot to the
+ * fastest baud rate supported by both their motors and their UART (up to 3
+ * Mbaud for MX28 chains). The rate is saved in the motors' EEPROM, so builds
+ * without this flag will only find them again if usart.cpp is configured for
+ * the negotiated rate. Faster rates are stepped through once, and a chain
+ * found at a rate other than the one it starts at is left there, so the
+ * EEPROM is only rewritten on later boots by a chain that can't hold even
+ * the first rate above its starting one (@see MotorGroup::negotiateBaudRate)
+ */
+#define USE_BAUD_RATE_NEGOTIATION
+
+/**
+ * @brief Flag for whether the motor daisy chains receive into a circular DMA
+ * buffer that runs continuously, instead of starting an exact-size transfer
+ * for every reply. Status packets are then picked out of the stream as they
+ * arrive, so a dropped or extra byte costs one packet instead of a timeout
+ * followed by a desynchronized bus
+ */
+#define USE_STREAMING_RECEPTION
+
+/**
+ * @brief Flag for whether the return delay time of each motor is tuned at
+ * boot, by sweeping it downwards until reads start to go unanswered. The
+ * sweep runs in the UART threads so that it sees the same bus turnaround time
+ * as normal operation, starting from the fixed 100 us delay set at bring-up,
+ * at the cost of a few seconds of boot time and a dozen or so EEPROM writes
+ * per motor per boot
+ */
+//#define USE_RETURN_DELAY_TUNING
+
+/**
+ * @brief Flag for whether each motor daisy chain is read by a telemetry
+ * scheduler, which reads each quantity (position, load, voltage,
+ * temperature) at its own rate and packs the slow ones into the bus time left
+ * over by the fast ones. Without it, only the positions of the leg motors are
+ * read, every cycle, and the state sent to the PC carries no loads or motor
+ * health
+ */
+#define USE_TELEMETRY_SCHEDULER
+
+/**
+ * @brief Flag for whether timed goals from the PC are queued as setpoints of
+ * a trajectory, which CommandTask samples every few milliseconds and sends to
+ * the motors. The PC can then send setpoints well ahead of time at a low rate
+ * and the motors still move smoothly between them. Without it, timed goals
+ * are dropped, and only untimed goals move the motors
+ */
+#define USE_GOAL_TRAJECTORIES
+
 /**
  * @brief USE_DEBUG_UART is a flag to use the debug UART handle at the default
  * pins for the board specified for communication with the PC, instead of the
@@ -104,6 +165,9 @@ constexpr UART_HandleTypeDef* UART_HANDLE_HeadAndArms = &huart3;
 
 #if defined(STM32F767xx)
 #define USE_MANUAL_UART_ABORT_DEFINITIONS
+
+/* The F7's USARTs can drive an RS-485 transceiver's DE line themselves. */
+#define USE_UART_DRIVER_ENABLE
 #endif
 
 #if defined(STM32F446xx)
@@ -0,0 +1,152 @@
+/**
+  *****************************************************************************
+  * @file    TelemetryScheduler.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup TelemetryScheduler
+  * @brief Decides which readings to make from a motor group in each control
+  *        cycle, so that each quantity is read at its own rate
+  * @ingroup Dynamixel
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef TELEMETRY_SCHEDULER_H
+#define TELEMETRY_SCHEDULER_H
+
+
+
+
+/********************************* Includes **********************************/
+#include "MotorGroup.h"
+
+
+
+
+/**************************** TelemetryScheduler *****************************/
+namespace dynamixel{
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Default share of each cycle, in percent, that the scheduled reads
+ *        may hold the bus for. The rest is left for writes
+ */
+constexpr uint8_t DEFAULT_TELEMETRY_BUDGET_PERCENT = 75;
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @class TelemetryScheduler Reads each quantity from each motor of a group
+ *        at its own rate, e.g. leg positions every cycle, loads at a fifth of
+ *        that and temperatures a couple of times a second
+ * @details Each (motor, quantity) pair has a period, in cycles, derived from
+ *          its rate. Every cycle, the pairs whose period has elapsed are due.
+ *          The pairs with the shortest period of all are always read when
+ *          due, so the fastest quantities are never held up. The slower ones
+ *          are packed into the bus time left in the cycle's budget, the most
+ *          overdue first, using MotorGroup::estimateReadTime; those that do
+ *          not fit stay due and are tried again the next cycle
+ */
+class TelemetryScheduler{
+public:
+    /**
+     * @brief TelemetryScheduler constructor. Every pair starts disabled
+     * @param group The motors to read from
+     * @param cycleRateHz Rate at which runCycle or schedule is called, in Hz
+     */
+    TelemetryScheduler(MotorGroup* group, uint32_t cycleRateHz);
+
+    ~TelemetryScheduler() {}
+
+    /**
+     * @brief Sets the rate at which a quantity is read from every motor
+     * @param item The quantity
+     * @param rateHz The rate, in Hz. 0 disables the reads. Rounded to a
+     *        whole number of cycles, and capped at the cycle rate
+     * @return true if successful, otherwise false
+     */
+    bool setRate(Telemetry item, uint32_t rateHz);
+
+    /**
+     * @brief Sets the rate at which a quantity is read from one motor
+     * @param motorIdx Index of the motor in the group
+     * @param item The quantity
+     * @param rateHz @see setRate(Telemetry, uint32_t)
+     * @return true if successful, otherwise false
+     */
+    bool setRate(size_t motorIdx, Telemetry item, uint32_t rateHz);
+
+    /**
+     * @brief Sets the bus time the reads of one cycle may take. Defaults to
+     *        DEFAULT_TELEMETRY_BUDGET_PERCENT of the cycle
+     * @param budgetUs The budget, in microseconds
+     */
+    void setCycleBudget(uint32_t budgetUs);
+
+    /**
+     * @brief Advances the schedule by one cycle and picks the readings to
+     *        make in it
+     * @param[out] reads The readings to make, with motorIdx and item set
+     * @param maxReads The capacity of reads
+     * @return The number of readings picked
+     */
+    size_t schedule(TelemetryRead* reads, size_t maxReads);
+
+    /**
+     * @brief Picks the readings for one cycle, then makes them
+     * @param[out] reads The readings made. @see MotorGroup::readTelemetry
+     * @param maxReads The capacity of reads
+     * @param[out] numReads The number of readings made
+     * @return true if every reading was made, otherwise false
+     */
+    bool runCycle(TelemetryRead* reads, size_t maxReads, size_t& numReads);
+
+    /**
+     * @brief Returns the number of due readings that did not fit in the
+     *        budget of the cycle they were due in, since construction
+     */
+    uint32_t getNumDeferred() const;
+
+    /** @brief Returns the group that readings are made from */
+    MotorGroup* group() const;
+
+private:
+    /** @brief Index into m_period and m_age of a (motor, quantity) pair */
+    static size_t entry(size_t motorIdx, Telemetry item);
+
+    /** @brief The motors to read from */
+    MotorGroup* const m_group;
+
+    /** @brief Rate at which the schedule is advanced, in Hz */
+    const uint32_t m_cycleRateHz;
+
+    /** @see setCycleBudget */
+    uint32_t m_budgetUs;
+
+    /** @brief Cycles between readings of each pair. 0 if disabled */
+    uint16_t m_period[MAX_TELEMETRY_READS] = {0};
+
+    /** @brief Cycles since each pair was last read, saturating */
+    uint16_t m_age[MAX_TELEMETRY_READS] = {0};
+
+    /** @see getNumDeferred */
+    uint32_t m_numDeferred = 0;
+};
+
+} // end namespace dynamixel
+
+
+
+
+/**
+ * @}
+ */
+/* end - TelemetryScheduler */
+
+#endif /* TELEMETRY_SCHEDULER_H */
@@ -0,0 +1,77 @@
+/**
+  *****************************************************************************
+  * @file    TimerInterface.h
+  * @author  Tyler Gamvrelis
+  * @brief   Abstract interface for hardware timer functions
+  *
+  * @defgroup TimerInterface
+  * @ingroup  Timer
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef TIMER_INTERFACE_H
+#define TIMER_INTERFACE_H
+
+
+
+
+/********************************* Includes **********************************/
+#include <stdint.h>
+#include "SystemConf.h"
+#include "main.h"
+
+
+
+
+/****************************** TimerInterface *******************************/
+namespace timer{
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @class TimerInterface Abstract interface for the channels of a free-running
+ *        timer counting microseconds, each of which can raise its compare
+ *        interrupt once after a delay
+ */
+class TimerInterface{
+public:
+    virtual ~TimerInterface() {}
+
+    /**
+     * @brief Arms a channel to raise its compare interrupt once, delayUs from
+     *        now. Re-arming a channel replaces its previous deadline
+     * @param htim The timer
+     * @param channel The channel, e.g. TIM_CHANNEL_1
+     * @param delayUs The delay, in microseconds
+     */
+    virtual void startOneShot(
+        TIM_HandleTypeDef* htim,
+        uint32_t channel,
+        uint32_t delayUs
+    ) const = 0;
+
+    /**
+     * @brief Disarms a channel, if it has not fired yet
+     * @param htim The timer
+     * @param channel The channel, e.g. TIM_CHANNEL_1
+     */
+    virtual void stopOneShot(
+        TIM_HandleTypeDef* htim,
+        uint32_t channel
+    ) const = 0;
+};
+
+} // end namespace timer
+
+
+
+
+/**
+ * @}
+ */
+/* end - TimerInterface */
+
+#endif /* TIMER_INTERFACE_H */
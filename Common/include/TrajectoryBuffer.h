@@ -0,0 +1,209 @@
+/**
+  *****************************************************************************
+  * @file    TrajectoryBuffer.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup TrajectoryBuffer
+  * @brief Queues timed joint setpoints from the PC and interpolates between
+  *        them, so that the motors can be commanded faster than goals arrive
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef TRAJECTORY_BUFFER_H
+#define TRAJECTORY_BUFFER_H
+
+
+
+
+/********************************* Includes **********************************/
+#include <stdint.h>
+#include <stddef.h>
+
+
+
+
+/***************************** TrajectoryBuffer ******************************/
+namespace trajectory{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Number of joints in each setpoint */
+constexpr size_t NUM_JOINTS = 18;
+
+/** @brief Number of setpoints that can be queued ahead of the current one */
+constexpr size_t TRAJECTORY_CAPACITY = 16;
+
+
+
+
+// Types & enums
+// ----------------------------------------------------------------------------
+/** @brief How the joint angles are interpolated between setpoints */
+enum class Interpolation : uint8_t{
+    LINEAR,       /**< Straight lines, with a change in speed at each setpoint */
+    CUBIC_HERMITE /**< Cubics matching the speeds at each setpoint           */
+};
+
+/** @brief A setpoint to reach some time after the one before it */
+struct Setpoint{
+    /**
+     * @brief Time to reach the setpoint from the one before it, or from where
+     *        the trajectory is if it replaces the queued ones, in ms
+     */
+    uint32_t durationMs;
+
+    /**
+     * @brief Whether the setpoint replaces those queued, instead of being
+     *        queued after them
+     */
+    bool replace;
+
+    /** @brief The joint angles, in degrees */
+    float angles[NUM_JOINTS];
+};
+
+
+
+
+// Classes and structs
+// ----------------------------------------------------------------------------
+/**
+ * @class TrajectoryBuffer Follows a trajectory through timed setpoints,
+ *        giving the joint angles at any time
+ * @details The trajectory is made of segments from one setpoint to the next.
+ *          A segment's end speeds are fixed when it starts: each is the
+ *          harmonic mean of the slopes of the segments on either side of the
+ *          setpoint, or 0 if the setpoint is a peak or trough or no setpoint
+ *          is queued after it. So the joints come to rest at the last
+ *          setpoint if the PC stops sending them, and move without jumps in
+ *          position or speed otherwise. Each joint only ever moves between
+ *          the angles at the ends of the segment under way, so it never
+ *          overshoots a setpoint (and can't be sent past a joint limit the
+ *          setpoints respect). A setpoint
+ *          that arrives after the trajectory has come to rest is moved to
+ *          over its duration from the time it arrives. Times are in ms, from
+ *          a clock that may wrap
+ */
+class TrajectoryBuffer{
+public:
+    /**
+     * @brief TrajectoryBuffer constructor
+     * @param interpolation How to interpolate between setpoints
+     */
+    explicit TrajectoryBuffer(
+        Interpolation interpolation = Interpolation::CUBIC_HERMITE
+    );
+
+    ~TrajectoryBuffer() {}
+
+    /**
+     * @brief Adds a setpoint to the trajectory. The first one ever added is
+     *        jumped to, since there is no position to move from
+     * @param setpoint The setpoint
+     * @param nowMs The current time
+     * @return false if the queue is full, in which case the setpoint is
+     *         dropped, otherwise true
+     */
+    bool push(const Setpoint& setpoint, uint32_t nowMs);
+
+    /**
+     * @brief Brings the trajectory to rest at the given joint angles,
+     *        discarding the queued setpoints. Used when the joints are
+     *        commanded directly
+     * @param angles The joint angles, NUM_JOINTS of them
+     * @param nowMs The current time
+     */
+    void hold(const float* angles, uint32_t nowMs);
+
+    /**
+     * @brief Returns the joint angles at the given time, moving on to the
+     *        next setpoints as they are reached
+     * @param nowMs The current time, which must not go backwards
+     * @param[out] angles The joint angles, NUM_JOINTS of them
+     * @return false if no setpoint has been added yet, otherwise true
+     */
+    bool sample(uint32_t nowMs, float* angles);
+
+    /**
+     * @brief Returns true if the joint angles will change after the given
+     *        time, i.e. a segment is under way or setpoints are queued
+     */
+    bool isMoving(uint32_t nowMs) const;
+
+    /** @brief Returns the number of setpoints queued */
+    size_t size() const;
+
+    /** @brief Returns the number of setpoints dropped as the queue was full */
+    uint32_t getNumDropped() const;
+
+private:
+    /** @brief A queued setpoint, with the time it is to be reached at */
+    struct Point{
+        uint32_t timeMs;
+        uint32_t durationMs;
+        float angles[NUM_JOINTS];
+    };
+
+    /** @brief Starts the segments whose start time has been reached */
+    void advance(uint32_t nowMs);
+
+    /** @brief Starts the segment to the next queued setpoint */
+    void startNextSegment();
+
+    /** @brief Sets the speeds at the end of the segment, as it starts */
+    void setEndSpeeds();
+
+    /**
+     * @brief Evaluates the segment under way
+     * @param[out] angles The joint angles
+     * @param[out] speeds The joint speeds in deg/ms, or nullptr
+     */
+    void evaluate(uint32_t nowMs, float* angles, float* speeds) const;
+
+    /** @see TrajectoryBuffer */
+    const Interpolation m_interpolation;
+
+    /** @brief Queued setpoints, oldest first from m_head */
+    Point m_queue[TRAJECTORY_CAPACITY];
+
+    /** @brief Index of the oldest queued setpoint in m_queue */
+    size_t m_head = 0;
+
+    /** @see size */
+    size_t m_count = 0;
+
+    /** @brief Whether the segment below has been set */
+    bool m_haveSegment = false;
+
+    /** @brief Time the segment under way starts */
+    uint32_t m_startMs = 0;
+
+    /** @brief Duration of the segment under way */
+    uint32_t m_durationMs = 0;
+
+    /** @brief Joint angles and speeds (deg/ms) at the start of the segment */
+    float m_startAngles[NUM_JOINTS] = {};
+    float m_startSpeeds[NUM_JOINTS] = {};
+
+    /** @brief Joint angles and speeds (deg/ms) at the end of the segment */
+    float m_endAngles[NUM_JOINTS] = {};
+    float m_endSpeeds[NUM_JOINTS] = {};
+
+    /** @see getNumDropped */
+    uint32_t m_numDropped = 0;
+};
+
+} // end namespace trajectory
+
+
+
+
+/**
+ * @}
+ */
+/* end - TrajectoryBuffer */
+
+#endif /* TRAJECTORY_BUFFER_H */
@@ -20,12 +20,15 @@
 
 
 /********************************* Includes **********************************/
+#include <atomic>
 #include "UartInterface.h"
 
 #if defined(THREADED)
 #include "cmsis_os.h"
 #include "OsInterface.h"
+#include "TimerInterface.h"
 using os::OsInterface;
+using timer::TimerInterface;
 #endif
 
 
@@ -85,6 +88,45 @@ public:
      */
     void setMaxBlockTime(uint32_t timeout);
 
+    /**
+     * @brief Sets the data transfer timeout in microseconds, which takes the
+     *        place of the one in OS ticks set by setMaxBlockTime. Each
+     *        transfer is additionally allowed the time its bytes take on the
+     *        wire at the current baud rate. Only takes effect once a cycle
+     *        counter is set
+     * @param timeoutUs The timeout, in microseconds, or 0 to go back to the
+     *        one in OS ticks
+     * @see setCycleCounter
+     */
+    void setMaxBlockTimeUs(uint32_t timeoutUs);
+
+    /**
+     * @brief Sets the clock that microsecond timeouts are measured with
+     * @param readCycles Returns the current value of a free-running cycle
+     *        counter (e.g. the DWT cycle counter)
+     * @param cyclesPerUs Number of cycles counted per microsecond
+     */
+    void setCycleCounter(uint32_t (*readCycles)(void), uint32_t cyclesPerUs);
+
+#if defined(THREADED)
+    /**
+     * @brief Sets a timer channel that wakes up the thread using this driver
+     *        once a microsecond timeout runs out, rather than on the first OS
+     *        tick after it. The channel's interrupt must notify the thread
+     *        with NOTIFIED_FROM_TIMER_ISR
+     * @param timer_if Pointer to the object handling the calls to the timer,
+     *        or nullptr to go back to waking up on OS ticks
+     * @param htim The timer
+     * @param channel The timer channel, which is used by this driver only
+     * @see setMaxBlockTimeUs
+     */
+    void setWakeupTimer(
+        const TimerInterface* timer_if,
+        TIM_HandleTypeDef* htim,
+        uint32_t channel
+    );
+#endif
+
     /**
      * @brief Configures the driver to use a particular IO type. This is used
      *        to change it between using blocking and asynchronous transfers
@@ -127,7 +169,182 @@ public:
      */
     bool receive(uint8_t* arrReceive, size_t numBytes) const;
 
+    /**
+     * @brief  Receives a message of unknown length, which ends once the line
+     *         goes idle for one frame after at least one byte has arrived,
+     *         or once maxBytes have arrived. With POLL and IT, exactly
+     *         maxBytes are received instead
+     * @param  arrReceive The byte array which the received data is to be
+     *         written into
+     * @param  maxBytes The most bytes to be received
+     * @param  numReceived [out] The number of bytes received, even if the
+     *         transfer timed out
+     * @return True if at least one byte was received and the line went idle
+     *         or the array filled up, otherwise false
+     */
+    bool receiveToIdle(
+        uint8_t* arrReceive,
+        size_t maxBytes,
+        size_t& numReceived
+    ) const;
+
+    /**
+     * @brief  Sends a request and receives the reply to it as one transfer.
+     *         With DMA and IT, the reception is started before the
+     *         transmission, so no part of the reply can arrive before the
+     *         UART is ready for it, and the caller is only woken up once,
+     *         when the reply is complete. The bus must be released from the
+     *         transmission complete interrupt or by the UART itself, and
+     *         the interrupt must not notify the caller while isTransceiving
+     *         returns true. With POLL, this is a transmit then a receive
+     * @param  arrTransmit The byte array to be sent
+     * @param  numTransmit The number of bytes to be sent from the array
+     * @param  arrReceive The byte array which the reply is to be written into.
+     *         Must not overlap arrTransmit
+     * @param  numReceive The number of bytes to be received
+     * @return True if the whole reply was received, otherwise false
+     */
+    bool transceive(
+        uint8_t* arrTransmit,
+        size_t numTransmit,
+        uint8_t* arrReceive,
+        size_t numReceive
+    ) const;
+
+    /**
+     * @brief  Starts a transmission and returns without waiting for it to
+     *         complete, for when the reply is received by other means (e.g.
+     *         a circular DMA reception that is always running). As with
+     *         transceive, isTransceiving returns true until endTransceive is
+     *         called. Only available with DMA and IT
+     * @param  arrTransmit The byte array to be sent
+     * @param  numTransmit The number of bytes to be sent from the array
+     * @return True if the transmission started, in which case endTransceive
+     *         must be called once the reply is in or the wait for it is given
+     *         up, otherwise false
+     */
+    bool beginTransceive(uint8_t* arrTransmit, size_t numTransmit) const;
+
+    /**
+     * @brief  Ends a transfer started by beginTransceive
+     * @param  success Whether the reply was received. If not, the
+     *         transmission is aborted in case it is still in progress
+     */
+    void endTransceive(bool success) const;
+
+    /**
+     * @brief  Indicates whether a transceive is waiting for its reply, in
+     *         which case the transmission complete interrupt must not notify
+     *         the waiting thread. Safe to call from an ISR
+     */
+    bool isTransceiving() const;
+
+    /**
+     * @brief  Reconfigures the UART to run at a new baud rate. This must only
+     *         be called while no transfer is in progress
+     * @param  baud The new baud rate
+     * @return True if the UART supports the new baud rate and was
+     *         reconfigured, otherwise false. @see supportsBaudRate
+     */
+    bool setBaudRate(uint32_t baud) const;
+
+    /**
+     * @brief  Returns the baud rate the UART is configured for
+     * @return The baud rate, or 0 if the driver is not initialized
+     */
+    uint32_t getBaudRate() const;
+
+    /**
+     * @brief  Indicates whether the UART can run at a baud rate closely enough
+     *         for the other end of the line to receive it reliably
+     * @param  baud The baud rate
+     * @return True if the baud rate the UART can actually generate is within
+     *         a couple percent of baud, otherwise false
+     */
+    bool supportsBaudRate(uint32_t baud) const;
+
+    /**
+     * @brief  Has the UART drive the bus direction (RS-485 DE) line in
+     *         hardware. @see UartInterface::enableDriverEnable
+     * @param  assertionTime Time between DE rising and the start bit, in
+     *         sample times
+     * @param  deassertionTime Time between the end of the last stop bit and
+     *         DE falling, in sample times
+     * @return True if the UART supports it and was reconfigured, otherwise
+     *         false
+     */
+    bool enableDriverEnable(
+        uint8_t assertionTime,
+        uint8_t deassertionTime
+    ) const;
+
+    /**
+     * @brief  Returns the current time, to mark the start of a loop waiting
+     *         on a reception that is always running. @see waitForStream
+     * @return The cycle count if microsecond timeouts are in use, otherwise
+     *         the OS tick count, or 0 if there is no OS
+     */
+    TickType_t getTickCount() const;
+
+    /**
+     * @brief  Checks whether a loop waiting on a reception that is always
+     *         running (e.g. a circular DMA reception) has run for the max
+     *         block time. If not, blocks until the reception notifies the
+     *         thread with NOTIFIED_FROM_RX_ISR (e.g. from its idle line,
+     *         half-transfer and transfer complete interrupts) or the time
+     *         runs out, so the loop can check for data again
+     * @param  start The time the loop started, from getTickCount
+     * @param  numBytes Number of bytes the loop waits for, whose time on the
+     *         wire is added to microsecond timeouts
+     * @return False if the loop should give up, otherwise true. Always false
+     *         if there is no OS and no cycle counter, so the loop makes a
+     *         single pass
+     */
+    bool waitForStream(TickType_t start, size_t numBytes = 0) const;
+
 private:
+    /** @brief Whether timeouts are measured in microseconds */
+    bool usesMicrosecondTimeouts() const;
+
+    /**
+     * @brief Returns the timeout for a transfer in microseconds, including
+     *        the time its bytes take on the wire
+     * @param numBytes The number of bytes transferred
+     */
+    uint32_t getTimeoutUs(size_t numBytes) const;
+
+    /**
+     * @brief Returns the timeout for a polled HAL transfer, which the HAL
+     *        measures in milliseconds
+     * @param numBytes The number of bytes transferred
+     */
+    uint32_t getPollTimeout(size_t numBytes) const;
+
+#if defined(THREADED)
+    /**
+     * @brief Waits for an ISR to signal the end of a transfer
+     * @param notification The notification bit the ISR sets
+     * @param numBytes The number of bytes transferred
+     * @return True if the bit was set before the timeout, otherwise false
+     */
+    bool waitForNotification(uint32_t notification, size_t numBytes) const;
+
+    /**
+     * @brief Blocks until a notification bit is set or a microsecond
+     *        timeout runs out, whichever comes first. With a wakeup timer,
+     *        the OS timeout only backs it up
+     * @param notification The notification bit to wait for
+     * @param remainingUs Time left before the timeout, in microseconds
+     * @param value [out] The notification value the thread woke up with
+     * @return The status of the OS wait
+     */
+    BaseType_t waitMicroseconds(
+        uint32_t notification,
+        uint32_t remainingUs,
+        uint32_t* value
+    ) const;
+#endif
+
     /**
      * @brief IO Type used by the driver, i.e. whether the driver uses polled,
      *        interrupt-driven, or DMA-driven IO
@@ -158,6 +375,29 @@ private:
 
     /** @brief Maximum permitted time for blocking on a data transfer */
     TickType_t m_max_block_time;
+
+    /** @see setMaxBlockTimeUs */
+    uint32_t m_max_block_time_us = 0;
+
+    /** @see setCycleCounter */
+    uint32_t (*m_readCycles)(void) = nullptr;
+
+    /** @see setCycleCounter */
+    uint32_t m_cyclesPerUs = 0;
+
+#if defined(THREADED)
+    /** @see setWakeupTimer */
+    const TimerInterface* m_timer_if = nullptr;
+
+    /** @see setWakeupTimer */
+    TIM_HandleTypeDef* m_htim = nullptr;
+
+    /** @see setWakeupTimer */
+    uint32_t m_timerChannel = 0;
+#endif
+
+    /** @see isTransceiving. Written by the thread and read by the ISR */
+    mutable std::atomic<bool> m_isTransceiving{false};
 };
 
 } // end namespace uart
@@ -150,6 +150,25 @@ public:
         size_t numBytes
     ) const = 0;
 
+    /**
+     * @brief  DMA-driven reception that also signals the receiving thread
+     *         when the line goes idle for one frame after at least one byte
+     *         has arrived, so that messages of unknown length are delivered
+     *         as soon as they end. The transfer keeps running until it
+     *         completes or abortReceive() is called; the number of bytes
+     *         received so far follows from getDmaRxInstanceNDTR()
+     * @param  uartHandlePtr Pointer to a structure that contains
+     *         the configuration information for the desired UART module
+     * @param  arrReceive Pointer to the receive buffer
+     * @param  numBytes The most bytes to be received
+     * @return 0 if success, otherwise an error code from 1 to 3
+     */
+    virtual HAL_StatusTypeDef receiveToIdleDMA(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint8_t* arrReceive,
+        size_t numBytes
+    ) const = 0;
+
     /**
      * @brief Gets the Number of Data Transfer Register for a UART using RX DMA.
      * @param uartHandlePtr Pointer to a structure that contains
@@ -188,6 +207,64 @@ public:
     virtual __IO uint32_t getErrorCode(
         const UART_HandleTypeDef* uartHandlePtr
     ) const = 0;
+
+    /**
+     * @brief Reconfigures the UART to run at a new baud rate. Any transfer in
+     *        progress is corrupted, so this should only be called while the
+     *        UART is idle
+     * @param uartHandlePtr Pointer to a structure that contains
+     *        the configuration information for the desired UART module
+     * @param baud The new baud rate
+     * @return 0 if success, otherwise an error code from 1 to 3
+     */
+    virtual HAL_StatusTypeDef setBaudRate(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint32_t baud
+    ) const = 0;
+
+    /**
+     * @brief Gets the baud rate the UART is configured for
+     * @param uartHandlePtr Pointer to a structure that contains
+     *        the configuration information for the desired UART module
+     * @return the BaudRate member of the Init member of *huart
+     */
+    virtual uint32_t getBaudRate(
+        const UART_HandleTypeDef* uartHandlePtr
+    ) const = 0;
+
+    /**
+     * @brief Gets the baud rate the UART would actually run at if it were
+     *        configured for the given one, which depends on the peripheral
+     *        clock and the oversampling setting
+     * @param uartHandlePtr Pointer to a structure that contains
+     *        the configuration information for the desired UART module
+     * @param baud The requested baud rate
+     * @return the attainable baud rate, or 0 if the requested one is faster
+     *         than the UART can run
+     */
+    virtual uint32_t getAttainableBaudRate(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint32_t baud
+    ) const = 0;
+
+    /**
+     * @brief Hands the RS-485 driver enable (DE) line over to the UART, which
+     *        then asserts it for exactly as long as each transmission lasts.
+     *        The DE line must be routed to the UART's DE (RTS) pin
+     * @param uartHandlePtr Pointer to a structure that contains
+     *        the configuration information for the desired UART module
+     * @param assertionTime Time between DE rising and the start bit, in
+     *        sample times (1/8 or 1/16 of a bit). At most 31
+     * @param deassertionTime Time between the end of the last stop bit and
+     *        DE falling, in sample times. At most 31
+     * @return 0 if success, otherwise an error code from 1 to 3. Always an
+     *         error on UARTs without hardware driver enable (STM32F4)
+     */
+    virtual HAL_StatusTypeDef enableDriverEnable(
+        const UART_HandleTypeDef* uartHandlePtr,
+        uint8_t assertionTime,
+        uint8_t deassertionTime
+    ) const = 0;
 };
 
 } // end namespace uart
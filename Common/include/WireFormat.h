@@ -0,0 +1,315 @@
+/**
+  *****************************************************************************
+  * @file    WireFormat.h
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup WireFormat
+  * @brief Fixed-point encoding of the goals and states exchanged with the PC
+  * @ingroup Communication
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+
+
+
+/********************************* Includes **********************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "Dynamixel.h"
+
+
+
+
+/******************************** WireFormat *********************************/
+namespace comm{
+// Types & enums
+// ----------------------------------------------------------------------------
+/** @brief The kinds of message, sent as the second byte of each message */
+enum class MessageType : uint8_t{
+    GOAL = 1,        /**< Every joint's goal angle, from the PC            */
+    STATE = 2,       /**< Joint readings and IMU readings, to the PC       */
+    SPARSE_GOAL = 3, /**< The goal angles of some joints only, from the PC */
+    TIMED_GOAL = 4   /**< A setpoint of a trajectory, from the PC          */
+};
+
+/** @brief The kinds of quantity carried, each with its own resolution */
+enum class FieldType : uint8_t{
+    JOINT_MX28,  /**< Joint angle of an MX28, in its position ticks (deg) */
+    JOINT_AX12A, /**< Joint angle of an AX12A, in its position ticks (deg) */
+    GYRO,        /**< Angular velocity, in MPU6050 LSBs at +/- 250 deg/s   */
+    ACCEL,       /**< Acceleration, in MPU6050 LSBs at +/- 2 g (m/s^2)    */
+    LOAD,        /**< Joint load, in 0.1% of the maximum torque (%)      */
+    TEMPERATURE, /**< Motor temperature, in degrees Celsius              */
+    VOLTAGE      /**< Motor supply voltage, in 0.1 V (V)                 */
+};
+
+
+
+
+// Constants
+// ----------------------------------------------------------------------------
+/**
+ * @brief Version of the format, sent as the first byte of each message.
+ *        Messages of any other version are rejected
+ */
+constexpr uint8_t WIRE_FORMAT_VERSION = 3;
+
+/** @brief Number of joints in a goal */
+constexpr size_t NUM_GOAL_JOINTS = 18;
+
+/** @brief Joint mask with a bit set for every joint in a goal */
+constexpr uint32_t ALL_GOAL_JOINTS = (1u << NUM_GOAL_JOINTS) - 1;
+
+/** @brief Number of joints in a state */
+constexpr size_t NUM_STATE_JOINTS = 12;
+
+/** @brief Number of IMU readings in a state (gyro XYZ, then accel XYZ) */
+constexpr size_t NUM_STATE_IMU = 6;
+
+/**
+ * @brief Number of motor health readings in a state, taken over every motor
+ *        that has answered: the hottest temperature, then the lowest supply
+ *        voltage. Both are 0 until a motor has answered
+ */
+constexpr size_t NUM_STATE_HEALTH = 2;
+
+/** @brief Index of the hottest motor temperature in the health readings */
+constexpr size_t STATE_HEALTH_TEMPERATURE = 0;
+
+/** @brief Index of the lowest motor supply voltage in the health readings */
+constexpr size_t STATE_HEALTH_VOLTAGE = 1;
+
+/**
+ * @brief Number of fields in a state: a joint angle and a joint load per
+ *        joint, the IMU readings and the health readings
+ */
+constexpr size_t NUM_STATE_FIELDS =
+    2 * NUM_STATE_JOINTS + NUM_STATE_IMU + NUM_STATE_HEALTH;
+
+/**
+ * @brief Field map of a goal message. Every message starts with the version,
+ *        the message type and a 16-bit ID, followed by one little-endian
+ *        int16 per field, in this order. A sparse goal has a 32-bit joint
+ *        mask after the ID, with bit i set if joint i is present, then the
+ *        fields of the joints present in this order, zero-padded to a
+ *        multiple of 4 bytes. A timed goal has a 16-bit duration in ms, a
+ *        flags byte and a zero byte after the ID, then every field
+ */
+constexpr FieldType GOAL_FIELDS[NUM_GOAL_JOINTS] = {
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::JOINT_AX12A, FieldType::JOINT_AX12A, FieldType::JOINT_AX12A,
+    FieldType::JOINT_AX12A, FieldType::JOINT_AX12A, FieldType::JOINT_AX12A
+};
+
+/** @brief Field map of a state message. @see GOAL_FIELDS */
+constexpr FieldType STATE_FIELDS[NUM_STATE_FIELDS] = {
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::JOINT_MX28, FieldType::JOINT_MX28, FieldType::JOINT_MX28,
+    FieldType::GYRO, FieldType::GYRO, FieldType::GYRO,
+    FieldType::ACCEL, FieldType::ACCEL, FieldType::ACCEL,
+    FieldType::LOAD, FieldType::LOAD, FieldType::LOAD,
+    FieldType::LOAD, FieldType::LOAD, FieldType::LOAD,
+    FieldType::LOAD, FieldType::LOAD, FieldType::LOAD,
+    FieldType::LOAD, FieldType::LOAD, FieldType::LOAD,
+    FieldType::TEMPERATURE, FieldType::VOLTAGE
+};
+
+/** @brief Size of the version, type and ID that start each message */
+constexpr size_t MESSAGE_PREAMBLE_SIZE = 4;
+
+/** @brief Size of the joint mask of a sparse goal */
+constexpr size_t JOINT_MASK_SIZE = 4;
+
+/**
+ * @brief Flag of a timed goal that makes it replace the setpoints queued on
+ *        the MCU, instead of being queued after them
+ */
+constexpr uint8_t TIMED_GOAL_REPLACE = 0x01;
+
+/** @brief Size of a goal message */
+constexpr size_t GOAL_MESSAGE_SIZE =
+    MESSAGE_PREAMBLE_SIZE + 2 * sizeof(GOAL_FIELDS) / sizeof(GOAL_FIELDS[0]);
+
+/** @brief Size of the largest sparse goal message, which has every joint */
+constexpr size_t MAX_SPARSE_GOAL_MESSAGE_SIZE =
+    GOAL_MESSAGE_SIZE + JOINT_MASK_SIZE;
+
+/** @brief Number of bytes at the start of a goal message that give its size */
+constexpr size_t GOAL_SIZE_PREFIX = MESSAGE_PREAMBLE_SIZE + JOINT_MASK_SIZE;
+
+/** @brief Size of a timed goal message */
+constexpr size_t TIMED_GOAL_MESSAGE_SIZE = GOAL_SIZE_PREFIX + 2 * NUM_GOAL_JOINTS;
+
+/** @brief Size of the largest message of any kind of goal */
+constexpr size_t MAX_GOAL_MESSAGE_SIZE =
+    (TIMED_GOAL_MESSAGE_SIZE > MAX_SPARSE_GOAL_MESSAGE_SIZE) ?
+    TIMED_GOAL_MESSAGE_SIZE :
+    MAX_SPARSE_GOAL_MESSAGE_SIZE;
+
+/** @brief Size of a state message */
+constexpr size_t STATE_MESSAGE_SIZE =
+    MESSAGE_PREAMBLE_SIZE + 2 * sizeof(STATE_FIELDS) / sizeof(STATE_FIELDS[0]);
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/**
+ * @brief Returns the value of one LSB of a field
+ * @param type The kind of field
+ * @return The resolution, in the engineering units of the field
+ */
+float fieldScale(FieldType type);
+
+/**
+ * @brief Returns the size of a goal message, from its first bytes
+ * @param in The first GOAL_SIZE_PREFIX bytes of the message
+ * @return The size of the message, or 0 if it is not a goal of this version
+ */
+size_t goalMessageSize(const uint8_t* in);
+
+/**
+ * @brief Encodes a goal, as the PC does
+ * @param id The goal's ID
+ * @param angles The joint angles in degrees, NUM_GOAL_JOINTS of them
+ * @param[out] out The message, GOAL_MESSAGE_SIZE bytes
+ */
+void encodeGoal(uint16_t id, const float* angles, uint8_t* out);
+
+/**
+ * @brief Encodes a sparse goal, as the PC does
+ * @param id The goal's ID
+ * @param jointMask The joints to encode, bit i set for joint i
+ * @param angles The joint angles in degrees, NUM_GOAL_JOINTS of them, of
+ *        which only those in jointMask are read
+ * @param[out] out The message, up to MAX_SPARSE_GOAL_MESSAGE_SIZE bytes
+ * @return The size of the message
+ */
+size_t encodeSparseGoal(
+    uint16_t id,
+    uint32_t jointMask,
+    const float* angles,
+    uint8_t* out
+);
+
+/**
+ * @brief Encodes a timed goal, as the PC does
+ * @param id The goal's ID
+ * @param durationMs Time to reach the goal from the previous one
+ * @param flags E.g. TIMED_GOAL_REPLACE
+ * @param angles The joint angles in degrees, NUM_GOAL_JOINTS of them
+ * @param[out] out The message, TIMED_GOAL_MESSAGE_SIZE bytes
+ */
+void encodeTimedGoal(
+    uint16_t id,
+    uint16_t durationMs,
+    uint8_t flags,
+    const float* angles,
+    uint8_t* out
+);
+
+/**
+ * @brief Decodes a timed goal
+ * @param in The message
+ * @param len The size of the message
+ * @param[out] id The goal's ID
+ * @param[out] durationMs Time to reach the goal from the previous one
+ * @param[out] flags E.g. TIMED_GOAL_REPLACE
+ * @param[out] angles The joint angles in degrees, NUM_GOAL_JOINTS of them
+ * @return false if the message is of another version or type, or is cut
+ *         short, in which case nothing is written, otherwise true
+ */
+bool decodeTimedGoal(
+    const uint8_t* in,
+    size_t len,
+    uint16_t& id,
+    uint16_t& durationMs,
+    uint8_t& flags,
+    float* angles
+);
+
+/**
+ * @brief Decodes a goal or a sparse goal
+ * @param in The message
+ * @param len The size of the message
+ * @param[out] id The goal's ID
+ * @param[out] jointMask The joints in the goal, ALL_GOAL_JOINTS unless it is
+ *             sparse
+ * @param[out] angles The joint angles in degrees, NUM_GOAL_JOINTS of them, of
+ *             which only those in jointMask are written
+ * @return false if the message is of another version or type, or is cut
+ *         short, in which case nothing is written, otherwise true
+ */
+bool decodeGoal(
+    const uint8_t* in,
+    size_t len,
+    uint16_t& id,
+    uint32_t& jointMask,
+    float* angles
+);
+
+/**
+ * @brief Encodes a state
+ * @param id The state's ID, i.e. that of the goal it answers
+ * @param angles The joint angles in degrees, NUM_STATE_JOINTS of them
+ * @param imu The IMU readings in deg/s and m/s^2, NUM_STATE_IMU of them
+ * @param loads The joint loads in percent, NUM_STATE_JOINTS of them
+ * @param health The motor health readings in degrees Celsius and volts,
+ *        NUM_STATE_HEALTH of them
+ * @param[out] out The message, STATE_MESSAGE_SIZE bytes
+ */
+void encodeState(
+    uint16_t id,
+    const float* angles,
+    const float* imu,
+    const float* loads,
+    const float* health,
+    uint8_t* out
+);
+
+/**
+ * @brief Decodes a state, as the PC does
+ * @param in The message
+ * @param len The size of the message
+ * @param[out] id The state's ID
+ * @param[out] angles The joint angles in degrees, NUM_STATE_JOINTS of them
+ * @param[out] imu The IMU readings, NUM_STATE_IMU of them
+ * @param[out] loads The joint loads in percent, NUM_STATE_JOINTS of them
+ * @param[out] health The motor health readings, NUM_STATE_HEALTH of them
+ * @return false if the message is of another version or type, or is cut
+ *         short, in which case nothing is written, otherwise true
+ */
+bool decodeState(
+    const uint8_t* in,
+    size_t len,
+    uint16_t& id,
+    float* angles,
+    float* imu,
+    float* loads,
+    float* health
+);
+
+} // end namespace comm
+
+
+
+
+/**
+ * @}
+ */
+/* end - WireFormat */
+
+#endif /* WIRE_FORMAT_H */
@@ -20,7 +20,8 @@ extern "C" {
 
 /**
  * @brief Data structure sent from the PC to the MCU. Contains "goal" motor
- *        positions
+ *        positions. It is decoded from the compact message that goes over the
+ *        wire, with the positions as floats in msg. @see WireFormat
  */
 typedef struct robot_goal{
 	uint32_t id;        /**< Message ID */
@@ -18,7 +18,11 @@ extern "C" {
 
 
 
-/** @brief Data structure sent from the MCU to the PC. Contains sensor data */
+/**
+ * @brief Data structure sent from the MCU to the PC. Contains sensor data as
+ *        floats in msg, which are encoded into a compact message before being
+ *        sent. @see WireFormat
+ */
 typedef struct robot_state {
 	uint32_t start_seq; /**< Start sequence to attach to message (for data
 	                         integrity purposes)                             */
@@ -19,16 +19,14 @@
 /*********************************** Includes ********************************/
 #include <stdint.h>
 #include <stddef.h>
+#include "TrajectoryBuffer.h"
 
 
 /***************************** Function prototypes ***************************/
 void initializeVars(void);
-void parseByteSequence(uint8_t *in_buff, size_t in_buff_size, bool& complete);
-void copyParsedData(void);
-
-enum class RxParseState {
-    CHECKING_HEADER,
-    READING_DATA
-};
+size_t parseByteSequence(const uint8_t *in_buff, size_t in_buff_size, bool& complete);
+bool copyParsedData(void);
+uint32_t takeChangedJoints(void);
+bool takeSetpoint(trajectory::Setpoint& setpoint);
 
 #endif /* RX_HELPER_H */
@@ -14,10 +14,13 @@
 
 
 /********************************* Includes **********************************/
+#include <stdint.h>
+#include <stddef.h>
 #include "BufferBase.h"
 
 
 /***************************** Function prototypes ***************************/
 void copySensorDataToSend(buffer::BufferMaster*);
+size_t encodeStateFrame(uint8_t* out);
 
 #endif /* TX_HELPER_H */
@@ -26,6 +26,9 @@
 
 /********************************** Includes **********************************/
 #include "Dynamixel.h"
+#include "MotorGroup.h"
+#include "ReturnDelayTuner.h"
+#include "TelemetryScheduler.h"
 #if defined(THREADED)
 #include "cmsis_os.h"
 #endif
@@ -40,7 +43,23 @@
 typedef enum{
     cmdReadPosition,  /**< Command to read motor position */
     cmdWritePosition, /**< Command to set new motor goal position */
-    cmdWriteTorque    /**< Command to refresh the motor torque enable */
+    cmdWriteTorque,   /**< Command to refresh the motor torque enable */
+    cmdSyncWritePosition, /**< Command to set new goal positions for all
+                               motors in a group with one packet         */
+    cmdReadGroupPosition, /**< Command to read the positions of all motors
+                               in a group                                */
+    cmdStageWritePosition, /**< Command to register new goal positions for
+                                all motors in a group, to be executed upon
+                                cmdAction                                */
+    cmdAction,            /**< Command to execute the goal positions
+                               registered through cmdStageWritePosition  */
+    cmdTuneReturnDelay,   /**< Command to tune the return delay time of
+                               all motors in a group                     */
+    cmdBringUp,           /**< Command to wait for all motors on a daisy
+                               chain to boot, then configure them. value
+                               is the index of the chain                 */
+    cmdReadTelemetry      /**< Command to make the readings that are due
+                               this cycle from all motors in a group     */
 }eUARTcmd_t;
 
 /**
@@ -57,6 +76,27 @@ typedef struct {
                                           case of a write instruction    */
     QueueHandle_t    qHandle;       /**< Pointer to the queue for this
                                           motor's commands               */
+    dynamixel::MotorGroup* groupHandle; /**< Pointer to the motor group
+                                             container (group commands
+                                             only)                       */
+    float            values[dynamixel::MAX_GROUP_SIZE]; /**< The values
+                                         to be written, one per motor in
+                                         the group (group commands only).
+                                         Copied into the command so that
+                                         the sender is free to overwrite
+                                         its own copy once it's queued   */
+    dynamixel::ReturnDelayTuner* tunerHandle; /**< Pointer to the tuner
+                                                   for the group
+                                                   (cmdTuneReturnDelay
+                                                   only). value is
+                                                   nonzero to keep the
+                                                   tuned delays          */
+    dynamixel::TelemetryScheduler* schedulerHandle; /**< Pointer to the
+                                                         telemetry
+                                                         scheduler for the
+                                                         group
+                                                         (cmdReadTelemetry
+                                                         only)           */
 }UARTcmd_t;
 
 /**
@@ -77,6 +117,7 @@ typedef struct{
     enum{
         T_FLOAT
     }type;
+    dynamixel::Telemetry item; /**< The quantity payload is a reading of */
 }MotorData_t;
 
 /**
@@ -105,7 +105,31 @@ TEST_F(CircularDmaBufferTest, SucceedSelfCheck) {
     EXPECT_TRUE(buff.selfCheck());
 }
 
-// TODO: define different test fixtures with variants of m_transmission_size vs. m_buffer_size comparison?
+TEST_F(CircularDmaBufferTest, SucceedSelfCheckWithRoomForTwoTransmissions) {
+    constexpr size_t BUFFER_SIZE = 20;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+    const uint16_t transmission_size = 10;
+    const size_t buffer_size = BUFFER_SIZE;
+
+    CircularDmaBuffer buff(&huart, &uart_if, transmission_size, buffer_size,
+            raw_buff);
+
+    EXPECT_TRUE(buff.selfCheck());
+}
+
+TEST_F(CircularDmaBufferTest, FailSelfCheckWithRoomForLessThanTwoTransmissions) {
+    constexpr size_t BUFFER_SIZE = 15;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+    const uint16_t transmission_size = 10;
+    const size_t buffer_size = BUFFER_SIZE;
+
+    CircularDmaBuffer buff(&huart, &uart_if, transmission_size, buffer_size,
+            raw_buff);
+
+    EXPECT_FALSE(buff.selfCheck());
+}
 
 TEST_F(CircularDmaBufferTest, FailSelfCheck) {
     constexpr size_t BUFFER_SIZE = 8;
@@ -137,6 +161,42 @@ TEST_F(CircularDmaBufferTest, Initiate) {
     EXPECT_TRUE(buff.selfCheck());
 }
 
+TEST_F(CircularDmaBufferTest, InitiateOverWholeBuffer) {
+    constexpr size_t BUFFER_SIZE = 40;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+    const uint16_t transmission_size = 10;
+    const size_t buffer_size = BUFFER_SIZE;
+
+    EXPECT_CALL(uart_if, receiveDMA(&huart, raw_buff, BUFFER_SIZE)).Times(1);
+
+    CircularDmaBuffer buff(&huart, &uart_if, transmission_size, buffer_size,
+            raw_buff);
+
+    buff.initiate();
+}
+
+TEST_F(CircularDmaBufferTest, InitiateWithIdleLineNotification) {
+    constexpr size_t BUFFER_SIZE = 20;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+    const uint16_t transmission_size = BUFFER_SIZE;
+    const size_t buffer_size = BUFFER_SIZE;
+
+    EXPECT_CALL(uart_if, receiveDMA(_, _, _)).Times(0);
+    EXPECT_CALL(uart_if, receiveToIdleDMA(&huart, raw_buff, BUFFER_SIZE)).Times(2);
+    EXPECT_CALL(uart_if, abortReceive(_)).Times(1);
+    EXPECT_CALL(uart_if, getErrorCode(_)).Times(1).WillOnce(Return(HAL_UART_ERROR_ORE));
+
+    CircularDmaBuffer buff(&huart, &uart_if, transmission_size, buffer_size,
+            raw_buff, true);
+
+    buff.initiate();
+
+    /* Restarting after an error keeps the idle line notification. */
+    EXPECT_TRUE(buff.reinitiateIfError());
+}
+
 TEST_F(CircularDmaBufferTest, AbortReinitiateIfError) {
     constexpr size_t BUFFER_SIZE = 20;
     UART_HandleTypeDef huart;
@@ -334,7 +394,199 @@ TEST_F(CircularDmaBufferTest, ReadBuff) {
     EXPECT_EQ(buff_->getBuffTail(), (num_bytes_received[0] + num_bytes_received[1]) % transmission_size_);
 }
 
-// TODO (future): tests with edge cases like m_transmission_size != m_buffer_size.
+TEST_F(CircularDmaBufferTest, PeekSpansInPlace) {
+    const size_t num_bytes_received[2] = {11, 96};
+
+    EXPECT_CALL(uart_if, getDmaRxInstanceNDTR(_)).Times(2)
+                                                 .WillOnce(Return(transmission_size_ - num_bytes_received[0]))
+                                                 .WillOnce(Return(transmission_size_ - ((num_bytes_received[0] + num_bytes_received[1]) % transmission_size_)));
+
+    /* Unwrapped data comes back as a single span starting at the tail. */
+    EXPECT_EQ(buff_->updateHead(), num_bytes_received[0]);
+    uart::ReadSpans spans = buff_->peekSpans();
+    EXPECT_EQ(spans.first, raw_buff_);
+    EXPECT_EQ(spans.first_size, num_bytes_received[0]);
+    EXPECT_EQ(spans.second_size, 0);
+
+    /* Peeking does not move the tail. */
+    EXPECT_EQ(buff_->getBuffTail(), 0);
+    EXPECT_EQ(buff_->consume(num_bytes_received[0]), num_bytes_received[0]);
+    EXPECT_FALSE(buff_->dataAvail());
+
+    /* Wrapped data is split at the end of the buffer. */
+    EXPECT_EQ(buff_->updateHead(), (num_bytes_received[0] + num_bytes_received[1]) % transmission_size_);
+    spans = buff_->peekSpans();
+    EXPECT_EQ(spans.first, &raw_buff_[num_bytes_received[0]]);
+    EXPECT_EQ(spans.first_size, BUFFER_SIZE_TEST - num_bytes_received[0]);
+    EXPECT_EQ(spans.second, raw_buff_);
+    EXPECT_EQ(spans.second_size, num_bytes_received[0] + num_bytes_received[1] - BUFFER_SIZE_TEST);
+}
+
+TEST_F(CircularDmaBufferTest, ConsumeAcrossWrap) {
+    EXPECT_CALL(uart_if, getDmaRxInstanceNDTR(_)).Times(2)
+                                                 .WillOnce(Return(transmission_size_ - 90))
+                                                 .WillOnce(Return(transmission_size_ - 20));
+
+    EXPECT_EQ(buff_->updateHead(), 90);
+    EXPECT_EQ(buff_->consume(80), 80);
+    EXPECT_EQ(buff_->updateHead(), 20);
+
+    /* Part of the data, up to past the wrap. */
+    EXPECT_EQ(buff_->consume(25), 25);
+    EXPECT_EQ(buff_->getBuffTail(), 5);
+
+    uart::ReadSpans spans = buff_->peekSpans();
+    EXPECT_EQ(spans.first, &raw_buff_[5]);
+    EXPECT_EQ(spans.first_size, 15);
+    EXPECT_EQ(spans.second_size, 0);
+
+    /* Consuming more than is available stops at the head. */
+    EXPECT_EQ(buff_->consume(100), 15);
+    EXPECT_EQ(buff_->getBuffTail(), buff_->getBuffHead());
+    EXPECT_FALSE(buff_->dataAvail());
+}
+
+TEST_F(CircularDmaBufferTest, ReadFullBuffer) {
+    uint8_t process_buff[BUFFER_SIZE_TEST] = {};
+
+    for (size_t i = 0; i < BUFFER_SIZE_TEST; i++) {
+        raw_buff_[i] = static_cast<uint8_t>(i);
+    }
+
+    /* The DMA went exactly once around, so head is back on tail. */
+    EXPECT_CALL(uart_if, getDmaRxInstanceNDTR(_)).Times(1).WillOnce(Return(transmission_size_));
+    buff_->onTransferComplete();
+
+    EXPECT_EQ(buff_->updateHead(), 0);
+    EXPECT_TRUE(buff_->dataAvail());
+    EXPECT_EQ(buff_->getNumOverruns(), 0);
+
+    EXPECT_EQ(buff_->readBuff(process_buff), BUFFER_SIZE_TEST);
+    for (size_t i = 0; i < BUFFER_SIZE_TEST; i++) {
+        EXPECT_EQ(process_buff[i], i);
+    }
+    EXPECT_FALSE(buff_->dataAvail());
+}
+
+TEST_F(CircularDmaBufferTest, ReadAcrossWrapWithBufferLargerThanTransmission) {
+    constexpr size_t BUFFER_SIZE = 40;
+    constexpr uint16_t TRANSMISSION_SIZE = 10;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+    uint8_t process_buff[BUFFER_SIZE] = { };
+
+    CircularDmaBuffer buff(&huart, &uart_if, TRANSMISSION_SIZE, BUFFER_SIZE, raw_buff);
+    ASSERT_TRUE(buff.selfCheck());
+
+    /* Three transmissions arrive, then a fourth and fifth that wrap around. */
+    EXPECT_CALL(uart_if, getDmaRxInstanceNDTR(_)).Times(2)
+                                                 .WillOnce(Return(BUFFER_SIZE - 3 * TRANSMISSION_SIZE))
+                                                 .WillOnce(Return(BUFFER_SIZE - TRANSMISSION_SIZE));
+    for (size_t i = 0; i < 3 * TRANSMISSION_SIZE; i++) {
+        raw_buff[i] = static_cast<uint8_t>(i);
+    }
+
+    EXPECT_EQ(buff.updateHead(), 3 * TRANSMISSION_SIZE);
+    EXPECT_EQ(buff.readBuff(process_buff, TRANSMISSION_SIZE), TRANSMISSION_SIZE);
+    EXPECT_EQ(process_buff[0], 0);
+
+    for (size_t i = 3 * TRANSMISSION_SIZE; i < 5 * TRANSMISSION_SIZE; i++) {
+        raw_buff[i % BUFFER_SIZE] = static_cast<uint8_t>(i);
+    }
+
+    /* The wrap is inferred from head moving backwards. */
+    EXPECT_EQ(buff.updateHead(), TRANSMISSION_SIZE);
+    EXPECT_EQ(buff.getNumOverruns(), 0);
+    EXPECT_EQ(buff.readBuff(process_buff), 4 * TRANSMISSION_SIZE);
+    for (size_t i = 0; i < 4 * TRANSMISSION_SIZE; i++) {
+        EXPECT_EQ(process_buff[i], i + TRANSMISSION_SIZE);
+    }
+    EXPECT_EQ(buff.getBuffTail(), TRANSMISSION_SIZE);
+}
+
+TEST_F(CircularDmaBufferTest, DetectOverrunWithinALap) {
+    constexpr size_t BUFFER_SIZE = 40;
+    constexpr uint16_t TRANSMISSION_SIZE = 10;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+    uint8_t process_buff[BUFFER_SIZE] = { };
+
+    CircularDmaBuffer buff(&huart, &uart_if, TRANSMISSION_SIZE, BUFFER_SIZE, raw_buff);
+
+    /* Tail is left at 20, then the DMA wraps around past it to 25. */
+    EXPECT_CALL(uart_if, getDmaRxInstanceNDTR(_)).Times(3)
+                                                 .WillOnce(Return(BUFFER_SIZE - 20))
+                                                 .WillOnce(Return(BUFFER_SIZE - 30))
+                                                 .WillOnce(Return(BUFFER_SIZE - 25));
+
+    EXPECT_EQ(buff.updateHead(), 20);
+    EXPECT_EQ(buff.readBuff(process_buff), 20);
+    EXPECT_EQ(buff.updateHead(), 30);
+    EXPECT_EQ(buff.updateHead(), 25);
+
+    /* Everything unread is dropped, and reading resumes from head. */
+    EXPECT_EQ(buff.getNumOverruns(), 1);
+    EXPECT_EQ(buff.getNumBytesLost(), BUFFER_SIZE + 5);
+    EXPECT_FALSE(buff.dataAvail());
+    EXPECT_EQ(buff.getBuffTail(), 25);
+}
+
+TEST_F(CircularDmaBufferTest, DetectOverrunOfWholeLapsFromTransferComplete) {
+    constexpr size_t BUFFER_SIZE = 40;
+    constexpr uint16_t TRANSMISSION_SIZE = 10;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+
+    CircularDmaBuffer buff(&huart, &uart_if, TRANSMISSION_SIZE, BUFFER_SIZE, raw_buff);
+
+    /* Head ends up ahead of where it was, but two laps later. */
+    EXPECT_CALL(uart_if, getDmaRxInstanceNDTR(_)).Times(3)
+                                                 .WillOnce(Return(BUFFER_SIZE - 10))
+                                                 .WillOnce(Return(BUFFER_SIZE - 15))
+                                                 .WillOnce(Return(BUFFER_SIZE - 20));
+
+    EXPECT_EQ(buff.updateHead(), 10);
+    EXPECT_EQ(buff.catchupTail(), 10);
+
+    buff.onTransferComplete();
+    buff.onTransferComplete();
+    EXPECT_EQ(buff.updateHead(), 15);
+    EXPECT_EQ(buff.getNumOverruns(), 1);
+    EXPECT_EQ(buff.getNumBytesLost(), 2 * BUFFER_SIZE + 5);
+
+    /* Laps that were already counted are not counted again. */
+    EXPECT_EQ(buff.updateHead(), 20);
+    EXPECT_EQ(buff.getNumOverruns(), 1);
+    EXPECT_TRUE(buff.dataAvail());
+}
+
+TEST_F(CircularDmaBufferTest, NoOverrunWhenTransferCompleteLagsWrap) {
+    constexpr size_t BUFFER_SIZE = 40;
+    constexpr uint16_t TRANSMISSION_SIZE = 10;
+    UART_HandleTypeDef huart;
+    uint8_t raw_buff[BUFFER_SIZE] = { };
+    uint8_t process_buff[BUFFER_SIZE] = { };
+
+    CircularDmaBuffer buff(&huart, &uart_if, TRANSMISSION_SIZE, BUFFER_SIZE, raw_buff);
+
+    EXPECT_CALL(uart_if, getDmaRxInstanceNDTR(_)).Times(3)
+                                                 .WillOnce(Return(BUFFER_SIZE - 35))
+                                                 .WillOnce(Return(BUFFER_SIZE - 5))
+                                                 .WillOnce(Return(BUFFER_SIZE - 8));
+
+    EXPECT_EQ(buff.updateHead(), 35);
+    EXPECT_EQ(buff.readBuff(process_buff), 35);
+
+    /* The DMA wrapped, but its interrupt has not run yet. */
+    EXPECT_EQ(buff.updateHead(), 5);
+    EXPECT_EQ(buff.readBuff(process_buff), 10);
+
+    /* The interrupt for the lap that was already inferred. */
+    buff.onTransferComplete();
+    EXPECT_EQ(buff.updateHead(), 8);
+    EXPECT_EQ(buff.readBuff(process_buff), 3);
+    EXPECT_EQ(buff.getNumOverruns(), 0);
+}
 
 } // end anonymous namespace
 
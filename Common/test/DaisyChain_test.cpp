@@ -15,17 +15,24 @@
 
 /********************************* Includes **********************************/
 #include "DaisyChain.h"
+#include "Notification.h"
 
 #include "MockUartInterface.h"
 #include "MockOsInterface.h"
 #include "MockGpioInterface.h"
+#include "GlobalMockTest.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 
+using ::testing::AnyNumber;
 using ::testing::DoAll;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
+using ::testing::SetArgPointee;
 using ::testing::_;
 
 using uart::UartDriver;
@@ -33,9 +40,14 @@ using uart::IO_Type;
 using mocks::MockOsInterface;
 using mocks::MockUartInterface;
 using mocks::MockGpioInterface;
+using mocks::GlobalMockTest;
+
+using uart::CircularDmaBuffer;
 
 using dynamixel::DaisyChainParams;
 using dynamixel::DaisyChain;
+using dynamixel::DirectionControl;
+using dynamixel::StatusPacket;
 
 
 
@@ -54,18 +66,116 @@ GPIO_TypeDef dataDirPort;
 
 DaisyChainParams p;
 
+uint8_t rxRaw[64];
+uint32_t rxNdtr = sizeof(rxRaw);
+CircularDmaBuffer rxBuffer(&UARTx, &uart, sizeof(rxRaw), sizeof(rxRaw), rxRaw);
+
+TickType_t ticks = 0;
+
+/** @brief A READ_DATA of 2 bytes at 0x24, sent to motor 1 */
+uint8_t readRequest[] = {0xFF, 0xFF, 0x01, 0x04, 0x02, 0x24, 0x02, 0xD2};
+
+/** @brief Motor 1's reply to readRequest */
+uint8_t readReply[] = {0xFF, 0xFF, 0x01, 0x04, 0x00, 0x34, 0x12, 0xB4};
+
 
 
 
 // Classes & structs
 // ----------------------------------------------------------------------------
-class DaisyChainShould : public ::testing::Test {
+class DaisyChainShould : public GlobalMockTest {
 protected:
+    DaisyChainShould() : GlobalMockTest(uart, os, gpio) {}
+
     void SetUp() override {
         p.uartDriver = &UARTxDriver;
         p.gpioif = &gpio;
         p.dataDirPort = &dataDirPort;
         p.dataDirPinNum = 1;
+        p.dirControl = DirectionControl::SOFTWARE;
+        p.rxBuffer = nullptr;
+    }
+
+    /**
+     * @brief Starts streaming into rxBuffer, the DMA transfer of which is
+     *        driven by arrive
+     */
+    void startStreaming(DaisyChain& chain){
+        rxNdtr = sizeof(rxRaw);
+        EXPECT_CALL(uart, receiveDMA(&UARTx, rxRaw, sizeof(rxRaw)))
+            .WillOnce(Return(HAL_OK));
+        EXPECT_CALL(uart, getDmaRxInstanceNDTR(&UARTx))
+            .WillRepeatedly(Invoke([](const UART_HandleTypeDef*){
+                return rxNdtr;
+            }));
+        EXPECT_CALL(uart, getErrorCode(&UARTx))
+            .WillRepeatedly(Return(HAL_UART_ERROR_NONE));
+        EXPECT_CALL(os, OS_xTaskGetTickCount())
+            .WillRepeatedly(Invoke([](){ return ticks++; }));
+        EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, _))
+            .WillRepeatedly(Return(pdFALSE));
+        EXPECT_CALL(gpio, writePin).Times(AnyNumber());
+
+        chain.setIOType(IO_Type::DMA);
+        ASSERT_TRUE(chain.startStreaming());
+    }
+
+    /** @brief Stops streaming and puts the UART driver back to polled IO */
+    void stopStreaming(DaisyChain& chain){
+        EXPECT_CALL(uart, abortReceive(&UARTx));
+        chain.setIOType(IO_Type::POLL);
+    }
+
+    /** @brief Has the DMA write bytes into rxBuffer as if they were received */
+    static void arrive(const uint8_t* bytes, size_t numBytes){
+        for(size_t i = 0; i < numBytes; ++i){
+            rxRaw[sizeof(rxRaw) - rxNdtr] = bytes[i];
+            rxNdtr = (rxNdtr == 1) ? sizeof(rxRaw) : rxNdtr - 1;
+        }
+    }
+
+    /**
+     * @brief Expects a DMA transmission of request, during which the bytes
+     *        in rx arrive. The thread is then notified that it completed
+     */
+    void expectTransmission(
+        uint8_t* request,
+        size_t requestLen,
+        const uint8_t* rx,
+        size_t rxLen
+    )
+    {
+        EXPECT_CALL(uart, transmitDMA(&UARTx, request, requestLen))
+            .WillOnce(DoAll(
+                Invoke([rx, rxLen](const UART_HandleTypeDef*, uint8_t*, size_t){
+                    arrive(rx, rxLen);
+                }),
+                Return(HAL_OK)
+            ));
+        EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_TX_ISR, _, _))
+            .WillOnce(
+                DoAll(SetArgPointee<2>(NOTIFIED_FROM_TX_ISR), Return(pdTRUE))
+            );
+    }
+
+    /**
+     * @brief Expects a DMA transmission of request that nobody waits for,
+     *        during which the bytes in rx arrive
+     */
+    void expectStreamedRequest(
+        uint8_t* request,
+        size_t requestLen,
+        const uint8_t* rx,
+        size_t rxLen
+    )
+    {
+        EXPECT_CALL(uart, transmitDMA(&UARTx, request, requestLen))
+            .WillOnce(DoAll(
+                Invoke([rx, rxLen](const UART_HandleTypeDef*, uint8_t*, size_t){
+                    arrive(rx, rxLen);
+                }),
+                Return(HAL_OK)
+            ));
     }
 };
 
@@ -131,6 +241,242 @@ TEST_F(DaisyChainShould, GetIOTypeForDriver){
     EXPECT_EQ(typeGot, typeToSet);
 }
 
+TEST_F(DaisyChainShould, HandBusDirectionToUartWithDriverEnable){
+    p.dirControl = DirectionControl::DRIVER_ENABLE;
+    DaisyChain chain(p);
+
+    EXPECT_CALL(uart, enableDriverEnable(&UARTx, _, _))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(gpio, writePin).Times(0);
+
+    ASSERT_TRUE(chain.initDirectionControl());
+    EXPECT_EQ(chain.getDirectionControl(), DirectionControl::DRIVER_ENABLE);
+
+    char msg[] = "hey!";
+    uint8_t buf[10];
+    EXPECT_TRUE(chain.requestTransmission((uint8_t*)msg, sizeof(msg)));
+    EXPECT_TRUE(chain.requestReception(buf, 5));
+    chain.onTransmitComplete();
+}
+
+TEST_F(DaisyChainShould, FallBackToSoftwareWithoutDriverEnable){
+    p.dirControl = DirectionControl::DRIVER_ENABLE;
+    DaisyChain chain(p);
+
+    EXPECT_CALL(uart, enableDriverEnable(&UARTx, _, _))
+        .WillOnce(Return(HAL_ERROR));
+    EXPECT_CALL(gpio, writePin(&dataDirPort, 1, GPIO_PIN_RESET));
+
+    ASSERT_FALSE(chain.initDirectionControl());
+    EXPECT_EQ(chain.getDirectionControl(), DirectionControl::SOFTWARE);
+}
+
+TEST_F(DaisyChainShould, ReleaseBusFromTransmitCompleteInterrupt){
+    p.dirControl = DirectionControl::TC_INTERRUPT;
+    DaisyChain chain(p);
+
+    EXPECT_CALL(gpio, writePin(&dataDirPort, 1, GPIO_PIN_RESET));
+    chain.onTransmitComplete();
+}
+
+TEST_F(DaisyChainShould, ReleaseBusInSoftwareForPolledTransfersWithTcInterrupt){
+    p.dirControl = DirectionControl::TC_INTERRUPT;
+    DaisyChain chain(p);
+    chain.setIOType(IO_Type::POLL);
+
+    uint8_t buf[10];
+    EXPECT_CALL(gpio, writePin(&dataDirPort, 1, GPIO_PIN_RESET));
+    EXPECT_TRUE(chain.requestReception(buf, 5));
+}
+
+TEST_F(DaisyChainShould, IgnoreTransmitCompleteWithSoftwareDirectionControl){
+    DaisyChain chain(p);
+
+    EXPECT_CALL(gpio, writePin).Times(0);
+    chain.onTransmitComplete();
+}
+
+TEST_F(DaisyChainShould, ArmReceptionBeforeTransmissionWhenTransceiving){
+    p.dirControl = DirectionControl::TC_INTERRUPT;
+    DaisyChain chain(p);
+    chain.setIOType(IO_Type::DMA);
+
+    uint8_t request[6] = {0};
+    uint8_t reply[6] = {0};
+    {
+        InSequence s;
+        EXPECT_CALL(gpio, writePin(&dataDirPort, 1, GPIO_PIN_SET));
+        EXPECT_CALL(uart, receiveDMA(&UARTx, reply, sizeof(reply)))
+            .WillOnce(Return(HAL_OK));
+        EXPECT_CALL(uart, transmitDMA(&UARTx, request, sizeof(request)))
+            .WillOnce(DoAll(
+                Invoke([&chain](const UART_HandleTypeDef*, uint8_t*, size_t){
+                    // The thread waits for the reply, not this
+                    EXPECT_FALSE(chain.onTransmitComplete());
+                }),
+                Return(HAL_OK)
+            ));
+        EXPECT_CALL(gpio, writePin(&dataDirPort, 1, GPIO_PIN_RESET));
+        EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, _))
+            .WillOnce(
+                DoAll(SetArgPointee<2>(NOTIFIED_FROM_RX_ISR), Return(pdTRUE))
+            );
+    }
+
+    EXPECT_TRUE(
+        chain.transceive(request, sizeof(request), reply, sizeof(reply))
+    );
+
+    chain.setIOType(IO_Type::POLL);
+}
+
+TEST_F(DaisyChainShould, TransceiveAsSeparateTransfersWithSoftwareDirControl){
+    DaisyChain chain(p);
+    chain.setIOType(IO_Type::DMA);
+
+    uint8_t request[6] = {0};
+    uint8_t reply[6] = {0};
+    {
+        InSequence s;
+        EXPECT_CALL(gpio, writePin(&dataDirPort, 1, GPIO_PIN_SET));
+        EXPECT_CALL(uart, transmitDMA(&UARTx, request, sizeof(request)))
+            .WillOnce(Return(HAL_OK));
+        EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_TX_ISR, _, _))
+            .WillOnce(
+                DoAll(SetArgPointee<2>(NOTIFIED_FROM_TX_ISR), Return(pdTRUE))
+            );
+        EXPECT_CALL(gpio, writePin(&dataDirPort, 1, GPIO_PIN_RESET));
+        EXPECT_CALL(uart, receiveDMA(&UARTx, reply, sizeof(reply)))
+            .WillOnce(Return(HAL_OK));
+        EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, _))
+            .WillOnce(
+                DoAll(SetArgPointee<2>(NOTIFIED_FROM_RX_ISR), Return(pdTRUE))
+            );
+    }
+
+    EXPECT_TRUE(
+        chain.transceive(request, sizeof(request), reply, sizeof(reply))
+    );
+
+    chain.setIOType(IO_Type::POLL);
+}
+
+TEST_F(DaisyChainShould, KeepReplyThatArrivesBeforeTransmitCompleteWakeup){
+    p.dirControl = DirectionControl::TC_INTERRUPT;
+    p.rxBuffer = &rxBuffer;
+    DaisyChain chain(p);
+    startStreaming(chain);
+
+    // A late reply to an earlier request is still in the buffer
+    const uint8_t stale[] = {0xFF, 0xFF, 0x02, 0x04, 0x00, 0x00, 0x00, 0xF9};
+    arrive(stale, sizeof(stale));
+
+    // The bus is released from the interrupt, so the reply is already in by
+    // the time the thread is woken up
+    expectTransmission(
+        readRequest,
+        sizeof(readRequest),
+        readReply,
+        sizeof(readReply)
+    );
+    ASSERT_TRUE(chain.requestTransmission(readRequest, sizeof(readRequest)));
+
+    uint8_t buf[2] = {0};
+    StatusPacket packet;
+    ASSERT_TRUE(chain.requestStatusPacket(1, buf, sizeof(buf), packet));
+    EXPECT_EQ(packet.numParams, 2);
+    EXPECT_EQ(buf[0], 0x34);
+    EXPECT_EQ(buf[1], 0x12);
+
+    stopStreaming(chain);
+}
+
+TEST_F(DaisyChainShould, SkipEchoOfRequestWhenStreaming){
+    p.dirControl = DirectionControl::TC_INTERRUPT;
+    p.rxBuffer = &rxBuffer;
+    DaisyChain chain(p);
+    startStreaming(chain);
+
+    // The echo of a READ_DATA would pass for motor 1's reply, with the
+    // address and length as its parameters
+    uint8_t rx[sizeof(readRequest) + sizeof(readReply)];
+    memcpy(rx, readRequest, sizeof(readRequest));
+    memcpy(&rx[sizeof(readRequest)], readReply, sizeof(readReply));
+
+    expectTransmission(readRequest, sizeof(readRequest), rx, sizeof(rx));
+    ASSERT_TRUE(chain.requestTransmission(readRequest, sizeof(readRequest)));
+
+    uint8_t buf[2] = {0};
+    StatusPacket packet;
+    ASSERT_TRUE(chain.requestStatusPacket(1, buf, sizeof(buf), packet));
+    EXPECT_EQ(packet.error, 0x00);
+    EXPECT_EQ(buf[0], 0x34);
+    EXPECT_EQ(buf[1], 0x12);
+
+    stopStreaming(chain);
+}
+
+TEST_F(DaisyChainShould, ReceiveStreamedReplyThatWrapsAroundBuffer){
+    p.dirControl = DirectionControl::TC_INTERRUPT;
+    p.rxBuffer = &rxBuffer;
+    DaisyChain chain(p);
+    startStreaming(chain);
+
+    // Leave the DMA 3 bytes short of the end of the buffer
+    uint8_t filler[sizeof(rxRaw) - 3] = {0};
+    arrive(filler, sizeof(filler));
+
+    expectTransmission(
+        readRequest,
+        sizeof(readRequest),
+        readReply,
+        sizeof(readReply)
+    );
+    ASSERT_TRUE(chain.requestTransmission(readRequest, sizeof(readRequest)));
+
+    uint8_t buf[2] = {0};
+    StatusPacket packet;
+    ASSERT_TRUE(chain.requestStatusPacket(1, buf, sizeof(buf), packet));
+    EXPECT_EQ(buf[0], 0x34);
+    EXPECT_EQ(buf[1], 0x12);
+
+    stopStreaming(chain);
+}
+
+TEST_F(DaisyChainShould, TransceiveStreamedWithoutWaitingForTransmission){
+    p.dirControl = DirectionControl::TC_INTERRUPT;
+    p.rxBuffer = &rxBuffer;
+    DaisyChain chain(p);
+    startStreaming(chain);
+
+    uint8_t rx[sizeof(readRequest) + sizeof(readReply)];
+    memcpy(rx, readRequest, sizeof(readRequest));
+    memcpy(&rx[sizeof(readRequest)], readReply, sizeof(readReply));
+
+    // Only the start of the echo is in when the thread first looks, and the
+    // rest of it and the reply come in while it blocks on the receiver
+    expectStreamedRequest(readRequest, sizeof(readRequest), rx, 3);
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_TX_ISR, _, _))
+        .Times(0);
+    EXPECT_CALL(uart, abortTransmit(_)).Times(0);
+    EXPECT_CALL(os, OS_xTaskNotifyWait(0, NOTIFIED_FROM_RX_ISR, _, _))
+        .WillOnce(DoAll(
+            InvokeWithoutArgs([&rx](){ arrive(&rx[3], sizeof(rx) - 3); }),
+            SetArgPointee<2>(NOTIFIED_FROM_RX_ISR),
+            Return(pdTRUE)
+        ))
+        .WillRepeatedly(Return(pdFALSE));
+
+    uint8_t buf[sizeof(readReply)] = {0};
+    ASSERT_TRUE(
+        chain.transceive(readRequest, sizeof(readRequest), buf, sizeof(buf))
+    );
+    EXPECT_EQ(memcmp(buf, readReply, sizeof(readReply)), 0);
+    EXPECT_FALSE(UARTxDriver.isTransceiving());
+
+    stopStreaming(chain);
+}
+
 } // end anonymous namespace
 
 
@@ -0,0 +1,150 @@
+/**
+  *****************************************************************************
+  * @file    DynamixelProtocol_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup DynamixelProtocol_Test
+  * @ingroup  DynamixelProtocol
+  * @brief    Unit test driver for the Dynamixel packet-level helpers
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "DynamixelProtocol.h"
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::ElementsAreArray;
+
+using dynamixel::computeCrc16;
+using dynamixel::buildPacket2;
+using dynamixel::parseStatusPacket2;
+using dynamixel::INST_PING;
+using dynamixel::INST_WRITE_DATA;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Functions
+// ----------------------------------------------------------------------------
+TEST(DynamixelProtocolTest, ComputesCrc16ForPingExample){
+    // Protocol 2.0 e-manual, ping example
+    uint8_t packet[] = {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x03, 0x00, 0x01};
+    ASSERT_EQ(computeCrc16(packet, sizeof(packet)), 0x4E19);
+}
+
+TEST(DynamixelProtocolTest, BuildsPacketWithoutParams){
+    uint8_t expected[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x03, 0x00, 0x01, 0x19, 0x4E
+    };
+
+    uint8_t buf[16];
+    size_t len = buildPacket2(0x01, INST_PING, nullptr, 0, buf, sizeof(buf));
+
+    ASSERT_EQ(len, sizeof(expected));
+    ASSERT_THAT(std::vector<uint8_t>(buf, buf + len), ElementsAreArray(expected));
+}
+
+TEST(DynamixelProtocolTest, StuffsHeaderSequenceInParams){
+    uint8_t params[] = {0x74, 0x00, 0xFF, 0xFF, 0xFD, 0x00};
+    uint8_t expected[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x0A, 0x00, 0x03,
+        0x74, 0x00, 0xFF, 0xFF, 0xFD, 0xFD, 0x00,
+        0x21, 0xE7
+    };
+
+    uint8_t buf[32];
+    size_t len = buildPacket2(
+        0x01,
+        INST_WRITE_DATA,
+        params,
+        sizeof(params),
+        buf,
+        sizeof(buf)
+    );
+
+    ASSERT_EQ(len, sizeof(expected));
+    ASSERT_THAT(std::vector<uint8_t>(buf, buf + len), ElementsAreArray(expected));
+}
+
+TEST(DynamixelProtocolTest, RejectsBufferTooSmallForPacket){
+    uint8_t params[] = {0x74, 0x00, 0xFF, 0xFF, 0xFD, 0x00};
+
+    // Big enough for the packet before stuffing, but not after
+    uint8_t buf[16];
+    ASSERT_EQ(
+        buildPacket2(0x01, INST_WRITE_DATA, params, sizeof(params), buf, 16),
+        0
+    );
+}
+
+TEST(DynamixelProtocolTest, ParsesStatusPacket){
+    // Protocol 2.0 e-manual, read example (present position 166)
+    uint8_t packet[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x08, 0x00, 0x55,
+        0x00, 0xA6, 0x00, 0x00, 0x00, 0x8C, 0xC0
+    };
+
+    uint8_t id = 0;
+    const uint8_t* params = nullptr;
+    size_t numParams = 0;
+    ASSERT_TRUE(
+        parseStatusPacket2(packet, sizeof(packet), id, params, numParams)
+    );
+    EXPECT_EQ(id, 0x01);
+    ASSERT_EQ(numParams, 4);
+    EXPECT_EQ(params[0], 0xA6);
+    EXPECT_EQ(params[3], 0x00);
+}
+
+TEST(DynamixelProtocolTest, RejectsCorruptedStatusPacket){
+    uint8_t packet[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x08, 0x00, 0x55,
+        0x00, 0xA7, 0x00, 0x00, 0x00, 0x8C, 0xC0
+    };
+
+    uint8_t id = 0;
+    const uint8_t* params = nullptr;
+    size_t numParams = 0;
+    ASSERT_FALSE(
+        parseStatusPacket2(packet, sizeof(packet), id, params, numParams)
+    );
+    ASSERT_EQ(params, nullptr);
+}
+
+TEST(DynamixelProtocolTest, RemovesStuffingFromStatusPacket){
+    uint8_t packet[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x09, 0x00, 0x55,
+        0x00, 0xFF, 0xFF, 0xFD, 0xFD, 0x01, 0xDD, 0x1C
+    };
+    uint8_t expectedParams[] = {0xFF, 0xFF, 0xFD, 0x01};
+
+    uint8_t id = 0;
+    const uint8_t* params = nullptr;
+    size_t numParams = 0;
+    ASSERT_TRUE(
+        parseStatusPacket2(packet, sizeof(packet), id, params, numParams)
+    );
+    ASSERT_THAT(
+        std::vector<uint8_t>(params, params + numParams),
+        ElementsAreArray(expectedParams)
+    );
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - DynamixelProtocol_Test */
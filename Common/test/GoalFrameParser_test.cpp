@@ -0,0 +1,411 @@
+/**
+  *****************************************************************************
+  * @file    GoalFrameParser_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup GoalFrameParser_Test
+  * @ingroup  GoalFrameParser
+  * @brief    Unit test driver for the PC goal frame parser
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "GoalFrameParser.h"
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using comm::GoalFrameParser;
+using comm::FRAME_SIZE;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Half an MX28 position tick, the most an angle is rounded by */
+constexpr float ANGLE_TOLERANCE = 0.04f;
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+/** @brief Builds a frame whose goal has the given ID and joint angles */
+std::vector<uint8_t> makeFrame(uint16_t id, float angle){
+    float angles[comm::NUM_GOAL_JOINTS];
+    std::fill(angles, angles + comm::NUM_GOAL_JOINTS, angle);
+
+    uint32_t message[comm::GOAL_MESSAGE_SIZE / 4];
+    comm::encodeGoal(id, angles, reinterpret_cast<uint8_t*>(message));
+
+    std::vector<uint8_t> frame(FRAME_SIZE);
+    comm::writeFrame(
+        reinterpret_cast<const uint8_t*>(message),
+        sizeof(message),
+        frame.data()
+    );
+    return frame;
+}
+
+/** @brief Builds a frame whose sparse goal has the given joints' angles */
+std::vector<uint8_t> makeSparseFrame(uint16_t id, uint32_t jointMask, float angle){
+    float angles[comm::NUM_GOAL_JOINTS];
+    std::fill(angles, angles + comm::NUM_GOAL_JOINTS, angle);
+
+    uint32_t message[comm::MAX_SPARSE_GOAL_MESSAGE_SIZE / 4];
+    const size_t size = comm::encodeSparseGoal(
+        id,
+        jointMask,
+        angles,
+        reinterpret_cast<uint8_t*>(message)
+    );
+
+    std::vector<uint8_t> frame(comm::MAX_FRAME_SIZE);
+    frame.resize(
+        comm::writeFrame(
+            reinterpret_cast<const uint8_t*>(message),
+            size,
+            frame.data()
+        )
+    );
+    return frame;
+}
+
+/** @brief Decodes the parser's last goal, returning its ID */
+uint16_t decodeId(const GoalFrameParser& parser, float* angles = nullptr){
+    float decoded[comm::NUM_GOAL_JOINTS] = {};
+    uint16_t id = 0;
+    uint32_t jointMask = 0;
+    EXPECT_TRUE(
+        comm::decodeGoal(
+            parser.getGoal(),
+            parser.getGoalSize(),
+            id,
+            jointMask,
+            decoded
+        )
+    );
+    if(angles != nullptr){
+        std::copy(decoded, decoded + comm::NUM_GOAL_JOINTS, angles);
+    }
+    return id;
+}
+
+/** @brief Decodes the parser's last goal, returning its first joint angle */
+float decodeAngle(const GoalFrameParser& parser){
+    float angles[comm::NUM_GOAL_JOINTS];
+    decodeId(parser, angles);
+    return angles[0];
+}
+
+uint32_t numCrcCalls = 0;
+
+uint32_t countingCrc(const uint8_t* data, size_t numBytes){
+    ++numCrcCalls;
+    return comm::crc32Software(data, numBytes);
+}
+
+TEST(GoalFrameParserTest, MatchesCrcUnit){
+    // The CRC unit's result for the single word 0x12345678
+    const uint8_t word[4] = {0x78, 0x56, 0x34, 0x12};
+    EXPECT_EQ(comm::crc32Software(word, sizeof(word)), 0xDF8A8A2B);
+}
+
+TEST(GoalFrameParserTest, ParsesSingleFrame){
+    GoalFrameParser parser;
+    std::vector<uint8_t> frame = makeFrame(0x1234, 90.0f);
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(frame.data(), frame.size(), complete), FRAME_SIZE);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 0x1234);
+    EXPECT_NEAR(decodeAngle(parser), 90.0f, ANGLE_TOLERANCE);
+    EXPECT_EQ(parser.getNumFrames(), 1);
+    EXPECT_EQ(parser.getNumResyncs(), 0);
+    EXPECT_EQ(parser.getNumCrcErrors(), 0);
+}
+
+TEST(GoalFrameParserTest, StopsAfterCompleteFrame){
+    GoalFrameParser parser;
+    std::vector<uint8_t> stream = makeFrame(1, -45.0f);
+    std::vector<uint8_t> second = makeFrame(2, 45.0f);
+    stream.insert(stream.end(), second.begin(), second.end());
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(stream.data(), stream.size(), complete), FRAME_SIZE);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 1);
+
+    // The first goal stays intact while the second is received
+    complete = false;
+    ASSERT_EQ(parser.parse(&stream[FRAME_SIZE], FRAME_SIZE - 1, complete), FRAME_SIZE - 1);
+    ASSERT_FALSE(complete);
+    EXPECT_EQ(decodeId(parser), 1);
+    EXPECT_NEAR(decodeAngle(parser), -45.0f, ANGLE_TOLERANCE);
+
+    ASSERT_EQ(parser.parse(&stream[2 * FRAME_SIZE - 1], 1, complete), 1);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 2);
+    EXPECT_EQ(parser.getNumFrames(), 2);
+}
+
+TEST(GoalFrameParserTest, ParsesFrameOneByteAtATime){
+    GoalFrameParser parser;
+    std::vector<uint8_t> frame = makeFrame(7, 0.0f);
+
+    bool complete = false;
+    for(size_t i = 0; i < frame.size() - 1; ++i){
+        ASSERT_EQ(parser.parse(&frame[i], 1, complete), 1);
+        ASSERT_FALSE(complete);
+    }
+    ASSERT_EQ(parser.parse(&frame.back(), 1, complete), 1);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 7);
+}
+
+TEST(GoalFrameParserTest, SkipsLeadingGarbage){
+    GoalFrameParser parser;
+    std::vector<uint8_t> stream = {0x01, 0x02, 0x03, 0x04, 0x05, 0xFF, 0xFF, 0x06, 0x07};
+    std::vector<uint8_t> frame = makeFrame(3, 10.0f);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(stream.data(), stream.size(), complete), stream.size());
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 3);
+    EXPECT_EQ(parser.getNumResyncs(), 1);
+    EXPECT_EQ(parser.getNumDiscardedBytes(), 9);
+}
+
+TEST(GoalFrameParserTest, FindsHeaderAfterExtraHeaderByte){
+    GoalFrameParser parser;
+    std::vector<uint8_t> stream = {0xFF};
+    std::vector<uint8_t> frame = makeFrame(4, 20.0f);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(stream.data(), stream.size(), complete), stream.size());
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 4);
+    EXPECT_EQ(parser.getNumUnknownMessages(), 1);
+    EXPECT_EQ(parser.getNumCrcErrors(), 0);
+    EXPECT_EQ(parser.getNumDiscardedBytes(), 1);
+}
+
+TEST(GoalFrameParserTest, RejectsCorruptedFrame){
+    GoalFrameParser parser;
+    std::vector<uint8_t> good = makeFrame(5, 30.0f);
+    std::vector<uint8_t> bad = makeFrame(6, -30.0f);
+    bad[40] ^= 0x01;
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(good.data(), good.size(), complete), FRAME_SIZE);
+    ASSERT_TRUE(complete);
+
+    complete = false;
+    ASSERT_EQ(parser.parse(bad.data(), bad.size(), complete), FRAME_SIZE);
+    EXPECT_FALSE(complete);
+    EXPECT_EQ(parser.getNumCrcErrors(), 1);
+
+    // The corrupted goal never replaces the last good one
+    EXPECT_EQ(decodeId(parser), 5);
+    EXPECT_NEAR(decodeAngle(parser), 30.0f, ANGLE_TOLERANCE);
+}
+
+TEST(GoalFrameParserTest, ResynchronizesAfterDroppedByte){
+    GoalFrameParser parser;
+    std::vector<uint8_t> stream = makeFrame(8, 8.0f);
+    stream.erase(stream.begin() + 20);
+    std::vector<uint8_t> next = makeFrame(9, 9.0f);
+    stream.insert(stream.end(), next.begin(), next.end());
+
+    // The short frame swallows the next frame's header, so the next frame is
+    // only found by scanning the short one again
+    bool complete = false;
+    ASSERT_EQ(parser.parse(stream.data(), stream.size(), complete), stream.size());
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 9);
+    EXPECT_EQ(parser.getNumCrcErrors(), 1);
+    EXPECT_EQ(parser.getNumResyncs(), 1);
+    EXPECT_EQ(parser.getNumDiscardedBytes(), FRAME_SIZE - 1);
+}
+
+TEST(GoalFrameParserTest, DiscardsPartialFrameOnReset){
+    GoalFrameParser parser;
+    std::vector<uint8_t> first = makeFrame(10, 1.0f);
+    std::vector<uint8_t> second = makeFrame(11, -45.0f);
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(first.data(), 30, complete), 30);
+    parser.reset();
+    ASSERT_EQ(parser.parse(second.data(), second.size(), complete), FRAME_SIZE);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 11);
+    EXPECT_EQ(parser.getNumCrcErrors(), 0);
+}
+
+TEST(GoalFrameParserTest, UsesGivenCrcFunction){
+    GoalFrameParser parser(countingCrc);
+    std::vector<uint8_t> frame = makeFrame(12, 2.0f);
+
+    numCrcCalls = 0;
+    bool complete = false;
+    parser.parse(frame.data(), frame.size(), complete);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(numCrcCalls, 1);
+}
+
+TEST(GoalFrameParserTest, ParsesSparseFrame){
+    GoalFrameParser parser;
+    std::vector<uint8_t> frame = makeSparseFrame(13, 1u << 12, 45.0f);
+    ASSERT_EQ(frame.size(), 20);
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(frame.data(), frame.size(), complete), frame.size());
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(parser.getGoalSize(), 12);
+
+    uint16_t id = 0;
+    uint32_t jointMask = 0;
+    float angles[comm::NUM_GOAL_JOINTS] = {};
+    ASSERT_TRUE(
+        comm::decodeGoal(parser.getGoal(), parser.getGoalSize(), id, jointMask, angles)
+    );
+    EXPECT_EQ(id, 13);
+    EXPECT_EQ(jointMask, 1u << 12);
+    EXPECT_NEAR(angles[12], 45.0f, 0.15f);
+    EXPECT_EQ(angles[0], 0.0f);
+}
+
+TEST(GoalFrameParserTest, ParsesMixedFrameSizesOneByteAtATime){
+    GoalFrameParser parser;
+    std::vector<uint8_t> stream = makeSparseFrame(1, 0x3, 1.0f);
+    std::vector<uint8_t> full = makeFrame(2, 2.0f);
+    std::vector<uint8_t> sparse = makeSparseFrame(3, comm::ALL_GOAL_JOINTS, 3.0f);
+    stream.insert(stream.end(), full.begin(), full.end());
+    stream.insert(stream.end(), sparse.begin(), sparse.end());
+
+    std::vector<uint16_t> ids;
+    for(size_t i = 0; i < stream.size(); ++i){
+        bool complete = false;
+        ASSERT_EQ(parser.parse(&stream[i], 1, complete), 1);
+        if(complete){
+            ids.push_back(decodeId(parser));
+        }
+    }
+    EXPECT_EQ(ids, std::vector<uint16_t>({1, 2, 3}));
+    EXPECT_EQ(parser.getNumCrcErrors(), 0);
+}
+
+TEST(GoalFrameParserTest, FindsShortFramesInRejectedFrame){
+    GoalFrameParser parser;
+
+    // A full frame that was cut short swallows the two short frames after it
+    std::vector<uint8_t> stream = makeFrame(20, 20.0f);
+    stream.erase(stream.begin() + 8, stream.begin() + 40);
+    std::vector<uint8_t> first = makeSparseFrame(21, 0, 0.0f);
+    std::vector<uint8_t> second = makeSparseFrame(22, 0, 0.0f);
+    std::vector<uint8_t> next = makeFrame(23, 23.0f);
+    stream.insert(stream.end(), first.begin(), first.end());
+    stream.insert(stream.end(), second.begin(), second.end());
+    stream.insert(stream.end(), next.begin(), next.end());
+
+    bool complete = false;
+    size_t i = parser.parse(stream.data(), stream.size(), complete);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 21);
+    EXPECT_EQ(i, FRAME_SIZE);
+
+    // The second short frame is complete already, though all the bytes
+    // received so far have been parsed
+    complete = false;
+    ASSERT_EQ(parser.parse(nullptr, 0, complete), 0);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 22);
+
+    complete = false;
+    i += parser.parse(&stream[i], stream.size() - i, complete);
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 23);
+    EXPECT_EQ(i, stream.size());
+    EXPECT_EQ(parser.getNumCrcErrors(), 1);
+}
+
+TEST(GoalFrameParserTest, ParsesTimedFrame){
+    float angles[comm::NUM_GOAL_JOINTS];
+    std::fill(angles, angles + comm::NUM_GOAL_JOINTS, -20.0f);
+    uint32_t message[comm::TIMED_GOAL_MESSAGE_SIZE / 4];
+    comm::encodeTimedGoal(
+        40,
+        120,
+        0,
+        angles,
+        reinterpret_cast<uint8_t*>(message)
+    );
+
+    std::vector<uint8_t> frame(comm::MAX_FRAME_SIZE);
+    frame.resize(
+        comm::writeFrame(
+            reinterpret_cast<const uint8_t*>(message),
+            sizeof(message),
+            frame.data()
+        )
+    );
+    ASSERT_EQ(frame.size(), comm::MAX_FRAME_SIZE);
+
+    GoalFrameParser parser;
+    bool complete = false;
+    ASSERT_EQ(parser.parse(frame.data(), frame.size(), complete), frame.size());
+    ASSERT_TRUE(complete);
+
+    uint16_t id = 0;
+    uint16_t durationMs = 0;
+    uint8_t flags = 0;
+    float decoded[comm::NUM_GOAL_JOINTS];
+    ASSERT_TRUE(
+        comm::decodeTimedGoal(
+            parser.getGoal(),
+            parser.getGoalSize(),
+            id,
+            durationMs,
+            flags,
+            decoded
+        )
+    );
+    EXPECT_EQ(id, 40);
+    EXPECT_EQ(durationMs, 120);
+    EXPECT_NEAR(decoded[0], -20.0f, 0.15f);
+}
+
+TEST(GoalFrameParserTest, RejectsUnknownMessages){
+    GoalFrameParser parser;
+    std::vector<uint8_t> stream = makeFrame(30, 30.0f);
+    stream[4] = comm::WIRE_FORMAT_VERSION + 1;
+    std::vector<uint8_t> next = makeFrame(31, 31.0f);
+    stream.insert(stream.end(), next.begin(), next.end());
+
+    bool complete = false;
+    ASSERT_EQ(parser.parse(stream.data(), stream.size(), complete), stream.size());
+    ASSERT_TRUE(complete);
+    EXPECT_EQ(decodeId(parser), 31);
+    EXPECT_EQ(parser.getNumUnknownMessages(), 1);
+    EXPECT_EQ(parser.getNumCrcErrors(), 0);
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - GoalFrameParser_Test */
@@ -19,22 +19,31 @@
 #include "MockUartInterface.h"
 #include "MockOsInterface.h"
 #include "MockGpioInterface.h"
+#include "GlobalMockTest.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 using ::testing::_;
+using ::testing::Args;
+using ::testing::DoAll;
+using ::testing::ElementsAreArray;
+using ::testing::SetArrayArgument;
+using ::testing::Return;
 
 using uart::UartDriver;
 
 using mocks::MockOsInterface;
 using mocks::MockUartInterface;
 using mocks::MockGpioInterface;
+using mocks::GlobalMockTest;
 
 using dynamixel::DaisyChainParams;
 using dynamixel::DaisyChain;
+using dynamixel::Protocol;
 using dynamixel::ResolutionDivider;
 using dynamixel::MX28;
+using dynamixel::JointState;
 
 
 
@@ -57,13 +66,16 @@ DaisyChainParams p;
 
 // Classes & structs
 // ----------------------------------------------------------------------------
-class MX28Test : public ::testing::Test {
+class MX28Test : public GlobalMockTest {
 protected:
+    MX28Test() : GlobalMockTest(uart, os, gpio) {}
+
     void SetUp() override {
         p.uartDriver = &UARTxDriver;
         p.gpioif = &gpio;
         p.dataDirPort = &dataDirPort;
         p.dataDirPinNum = 1;
+        p.protocol = Protocol::V1;
     }
 };
 
@@ -136,6 +148,119 @@ TEST_F(MX28Test, CanGetVelocity){
     m.getVelocity(currentVelocity);
 }
 
+TEST_F(MX28Test, ReadsJointStateInOneReadDataPacket){
+    DaisyChain chain(p);
+    MX28 m(1, &chain);
+
+    uint8_t expectedTxArray[] = {0xFF, 0xFF, 0x01, 0x04, 0x02, 0x24, 0x08, 0xCC};
+
+    // Position 2048, velocity 512 CW, load 256 CCW, 12.0 V, 40 degrees C
+    uint8_t mockedRxArray[] = {
+        0xFF, 0xFF, 0x01, 0x0A, 0x00,
+        0x00, 0x08, 0x00, 0x06, 0x00, 0x01, 0x78, 0x28,
+        0x45
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    EXPECT_CALL(uart, receivePoll(_, _, sizeof(mockedRxArray), _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        );
+
+    JointState state;
+    ASSERT_TRUE(m.readState(state));
+    EXPECT_FLOAT_EQ(state.position, 2048 * dynamixel::MAX_ANGLE / 4095);
+    EXPECT_FLOAT_EQ(state.velocity, -512 / 1023.0 * dynamixel::MX28_MAX_VELOCITY);
+    EXPECT_FLOAT_EQ(state.load, 256 / 1023.0 * 100.0);
+    EXPECT_FLOAT_EQ(state.voltage, 12.0);
+    EXPECT_EQ(state.temperature, 40);
+}
+
+TEST_F(MX28Test, WritesGoalPositionOverProtocol2){
+    p.protocol = Protocol::V2;
+    DaisyChain chain(p);
+    MX28 m(1, &chain);
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x09, 0x00, 0x03,
+        0x74, 0x00, 0xFF, 0x07, 0x00, 0x00,
+        0xA6, 0x85
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    ASSERT_TRUE(m.setGoalPosition(150.0));
+}
+
+TEST_F(MX28Test, ReadsPositionOverProtocol2){
+    p.protocol = Protocol::V2;
+    DaisyChain chain(p);
+    MX28 m(1, &chain);
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x02,
+        0x84, 0x00, 0x04, 0x00,
+        0x1D, 0x15
+    };
+    uint8_t mockedRxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x08, 0x00, 0x55,
+        0x00, 0xFF, 0x07, 0x00, 0x00,
+        0xF8, 0x34
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    EXPECT_CALL(uart, receivePoll(_, _, sizeof(mockedRxArray), _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        );
+
+    float pos = 0;
+    ASSERT_TRUE(m.getPosition(pos));
+    EXPECT_FLOAT_EQ(pos, 2047 * dynamixel::MAX_ANGLE / 4095);
+}
+
+TEST_F(MX28Test, RejectsRegistersWithoutProtocol2Equivalent){
+    p.protocol = Protocol::V2;
+    DaisyChain chain(p);
+    MX28 m(1, &chain);
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _)).Times(0);
+
+    ASSERT_FALSE(m.setPunch(50.0));
+
+    JointState state;
+    ASSERT_FALSE(m.readState(state));
+}
+
+TEST_F(MX28Test, EncodesFullScaleGoalVelocity){
+    DaisyChain chain(p);
+    MX28 m(1, &chain);
+
+    // All 10 magnitude bits must make it into the packet
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0x01, 0x05, 0x03, 0x20, 0xFF, 0x03, 0xD4
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK))
+        .RetiresOnSaturation();
+
+    ASSERT_TRUE(m.setGoalVelocity(dynamixel::MX28_MAX_VELOCITY));
+}
+
 } // end anonymous namespace
 
 
@@ -0,0 +1,766 @@
+/**
+  *****************************************************************************
+  * @file    MotorGroup_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup MotorGroup_Test
+  * @ingroup  MotorGroup
+  * @brief    Unit test driver for MotorGroup
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "MotorGroup.h"
+#include "MX28.h"
+#include "AX12A.h"
+
+#include "MockUartInterface.h"
+#include "MockOsInterface.h"
+#include "MockGpioInterface.h"
+#include "GlobalMockTest.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::Args;
+using ::testing::DoAll;
+using ::testing::ElementsAreArray;
+using ::testing::SetArrayArgument;
+using ::testing::Return;
+
+using uart::UartDriver;
+
+using mocks::MockOsInterface;
+using mocks::MockUartInterface;
+using mocks::MockGpioInterface;
+using mocks::GlobalMockTest;
+
+using dynamixel::MotorGroup;
+using dynamixel::MX28;
+using dynamixel::AX12A;
+using dynamixel::DaisyChainParams;
+using dynamixel::DaisyChain;
+using dynamixel::Protocol;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Variables
+// ----------------------------------------------------------------------------
+MockUartInterface uart;
+MockOsInterface os;
+MockGpioInterface gpio;
+UART_HandleTypeDef UARTx = {0};
+UartDriver UARTxDriver(&os, &uart, &UARTx);
+
+GPIO_TypeDef dataDirPort;
+
+DaisyChainParams p;
+
+
+
+
+// Classes & structs
+// ----------------------------------------------------------------------------
+class MotorGroupTest : public GlobalMockTest {
+protected:
+    MotorGroupTest() : GlobalMockTest(uart, os, gpio) {}
+
+    void SetUp() override {
+        p.uartDriver = &UARTxDriver;
+        p.gpioif = &gpio;
+        p.dataDirPort = &dataDirPort;
+        p.dataDirPinNum = 1;
+        p.protocol = Protocol::V1;
+    }
+};
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+TEST_F(MotorGroupTest, CanBeCreated){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+    ASSERT_EQ(group.size(), 3);
+    ASSERT_EQ(group.motor(0), &m1);
+    ASSERT_EQ(group.motor(2), &m3);
+    ASSERT_EQ(group.motor(3), nullptr);
+}
+
+TEST_F(MotorGroupTest, RejectsMotorsOnOtherChains){
+    DaisyChain chain(p);
+    DaisyChain otherChain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &otherChain);
+
+    MotorGroup group(&chain, {&m1, &m2});
+    ASSERT_EQ(group.size(), 1);
+}
+
+TEST_F(MotorGroupTest, setGoalPositionsBoundsCheckPasses){
+    DaisyChain chain(p);
+    AX12A m1(1, &chain);
+    AX12A m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+
+    float goodAngles[] = {dynamixel::MIN_ANGLE, dynamixel::MAX_ANGLE};
+    group.setGoalPositions(goodAngles, 2);
+
+    ASSERT_FALSE(group.setGoalPositions(goodAngles, 1));
+
+    float badAngles[] = {150.0, dynamixel::MAX_ANGLE + 1};
+    ASSERT_FALSE(group.setGoalPositions(badAngles, 2));
+}
+
+TEST_F(MotorGroupTest, SendsGoalPositionsInOneSyncWritePacket){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFE, 0x0D, 0x83, 0x1E, 0x02,
+        0x01, 0x00, 0x00,
+        0x02, 0xFF, 0x07,
+        0x03, 0xFF, 0x0F,
+        0x37
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    float angles[] = {0.0, 150.0, 300.0};
+    ASSERT_TRUE(group.setGoalPositions(angles, 3));
+}
+
+TEST_F(MotorGroupTest, LeavesUnchangedGoalsOutOfSyncWritePacket){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+
+    uint8_t expectedTxArray1[] = {
+        0xFF, 0xFF, 0xFE, 0x0D, 0x83, 0x1E, 0x02,
+        0x01, 0x00, 0x00,
+        0x02, 0xFF, 0x07,
+        0x03, 0xFF, 0x0F,
+        0x37
+    };
+    uint8_t expectedTxArray2[] = {
+        0xFF, 0xFF, 0xFE, 0x07, 0x83, 0x1E, 0x02,
+        0x02, 0xFF, 0x0F,
+        0x47
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray1)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray2)))
+        .WillOnce(Return(HAL_OK))
+        .RetiresOnSaturation();
+
+    float angles[] = {0.0, 150.0, 300.0};
+    ASSERT_TRUE(group.setGoalPositions(angles, 3));
+
+    // Only the second motor's goal changes
+    angles[1] = 300.0;
+    ASSERT_TRUE(group.setGoalPositions(angles, 3));
+
+    // Nothing changes, so nothing is sent
+    ASSERT_TRUE(group.setGoalPositions(angles, 3));
+    ASSERT_EQ(m1.getShadowHits(), 2);
+    ASSERT_EQ(m2.getShadowMisses(), 2);
+}
+
+TEST_F(MotorGroupTest, StagesGoalPositionsWithRegWrite){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+
+    uint8_t expectedTxArray1[] = {
+        0xFF, 0xFF, 0x01, 0x05, 0x04, 0x1E, 0x00, 0x00, 0xD7
+    };
+    uint8_t expectedTxArray2[] = {
+        0xFF, 0xFF, 0x02, 0x05, 0x04, 0x1E, 0xFF, 0x0F, 0xC8
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray1)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray2)))
+        .WillOnce(Return(HAL_OK))
+        .RetiresOnSaturation();
+
+    float angles[] = {0.0, 300.0};
+    ASSERT_TRUE(group.stageGoalPositions(angles, 2));
+
+    float badAngles[] = {0.0, dynamixel::MAX_ANGLE + 1};
+    ASSERT_FALSE(group.stageGoalPositions(badAngles, 2));
+}
+
+TEST_F(MotorGroupTest, BroadcastsAction){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    uint8_t expectedTxArray[] = {0xFF, 0xFF, 0xFE, 0x02, 0x05, 0xFA};
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    ASSERT_TRUE(group.action());
+}
+
+TEST_F(MotorGroupTest, ActionIsPendingFromStagingUntilAction){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .WillRepeatedly(Return(HAL_OK));
+
+    EXPECT_FALSE(group.isActionPending());
+
+    // Nothing is staged if the goals are invalid
+    float badAngles[] = {dynamixel::MAX_ANGLE + 1};
+    ASSERT_FALSE(group.stageGoalPositions(badAngles, 1));
+    EXPECT_FALSE(group.isActionPending());
+
+    float angles[] = {150.0};
+    ASSERT_TRUE(group.stageGoalPositions(angles, 1));
+    EXPECT_TRUE(group.isActionPending());
+
+    ASSERT_TRUE(group.action());
+    EXPECT_FALSE(group.isActionPending());
+
+    // A failed ACTION still ends the wait
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .WillRepeatedly(Return(HAL_TIMEOUT));
+    float newAngles[] = {200.0};
+    ASSERT_FALSE(group.stageGoalPositions(newAngles, 1));
+    EXPECT_TRUE(group.isActionPending());
+    ASSERT_FALSE(group.action());
+    EXPECT_FALSE(group.isActionPending());
+}
+
+TEST_F(MotorGroupTest, RestagesGoalPositionsAfterFailedAction){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    uint8_t regWriteTxArray[] = {
+        0xFF, 0xFF, 0x01, 0x05, 0x04, 0x1E, 0x00, 0x00, 0xD7
+    };
+    uint8_t actionTxArray[] = {0xFF, 0xFF, 0xFE, 0x02, 0x05, 0xFA};
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(regWriteTxArray)))
+        .Times(2)
+        .WillRepeatedly(Return(HAL_OK));
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(actionTxArray)))
+        .WillOnce(Return(HAL_ERROR));
+
+    // The motor still holds the staged goal, but never applied it, so the
+    // same goal is staged again rather than skipped
+    float angles[] = {0.0};
+    ASSERT_TRUE(group.stageGoalPositions(angles, 1));
+    ASSERT_FALSE(group.action());
+    ASSERT_TRUE(group.stageGoalPositions(angles, 1));
+    ASSERT_EQ(m1.getShadowHits(), 0);
+}
+
+TEST_F(MotorGroupTest, UsesBulkReadOnlyIfAllMotorsSupportIt){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    AX12A m3(3, &chain);
+
+    MotorGroup mx28Group(&chain, {&m1, &m2});
+    ASSERT_TRUE(mx28Group.usesBulkRead());
+
+    MotorGroup mixedGroup(&chain, {&m1, &m2, &m3});
+    ASSERT_FALSE(mixedGroup.usesBulkRead());
+}
+
+TEST_F(MotorGroupTest, ParsesBulkReadPositionsProperly){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFE, 0x0C, 0x92, 0x00,
+        0x02, 0x01, 0x24,
+        0x02, 0x02, 0x24,
+        0x02, 0x03, 0x24,
+        0xEB
+    };
+    uint8_t mockedRxArray[] = {
+        0xFF, 0xFF, 0x01, 0x04, 0x00, 0x00, 0x00, 0xFA,
+        0xFF, 0xFF, 0x02, 0x04, 0x00, 0xFF, 0x07, 0xF3,
+        0xFF, 0xFF, 0x03, 0x04, 0x00, 0xFF, 0x0F, 0xEA
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    EXPECT_CALL(uart, receivePoll(_, _, sizeof(mockedRxArray), _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        );
+
+    float positions[3] = {0};
+    bool isValid[3] = {false};
+    ASSERT_TRUE(group.getPositions(positions, isValid, 3));
+    ASSERT_TRUE(isValid[0] && isValid[1] && isValid[2]);
+    EXPECT_FLOAT_EQ(positions[0], 0.0);
+    EXPECT_FLOAT_EQ(positions[1], 2047 * dynamixel::MAX_ANGLE / 4095);
+    EXPECT_FLOAT_EQ(positions[2], 300.0);
+}
+
+TEST_F(MotorGroupTest, KeepsValidBulkReadPacketsWhenOneIsCorrupted){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+
+    // Second packet has a bad checksum
+    uint8_t mockedRxArray[] = {
+        0xFF, 0xFF, 0x01, 0x04, 0x00, 0xFF, 0x0F, 0xEC,
+        0xFF, 0xFF, 0x02, 0x04, 0x00, 0xFF, 0x07, 0x00
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        );
+
+    float positions[2] = {-1.0, -1.0};
+    bool isValid[2] = {false};
+    ASSERT_FALSE(group.getPositions(positions, isValid, 2));
+    ASSERT_TRUE(isValid[0]);
+    ASSERT_FALSE(isValid[1]);
+    EXPECT_FLOAT_EQ(positions[0], 300.0);
+    EXPECT_FLOAT_EQ(positions[1], -1.0);
+}
+
+TEST_F(MotorGroupTest, MatchesBulkReadPacketsToMotorsById){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+
+    // Motor 2 doesn't respond, and motor 3's packet arrives before motor 1's
+    uint8_t mockedRxArray[] = {
+        0xFF, 0xFF, 0x03, 0x04, 0x00, 0xFF, 0x0F, 0xEA,
+        0xFF, 0xFF, 0x01, 0x04, 0x00, 0x00, 0x00, 0xFA
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        );
+
+    float positions[3] = {-1.0, -1.0, -1.0};
+    bool isValid[3] = {false};
+    ASSERT_FALSE(group.getPositions(positions, isValid, 3));
+    ASSERT_TRUE(isValid[0]);
+    ASSERT_FALSE(isValid[1]);
+    ASSERT_TRUE(isValid[2]);
+    EXPECT_FLOAT_EQ(positions[0], 0.0);
+    EXPECT_FLOAT_EQ(positions[1], -1.0);
+    EXPECT_FLOAT_EQ(positions[2], 300.0);
+}
+
+TEST_F(MotorGroupTest, ReadsAX12APositionsOneAtATime){
+    DaisyChain chain(p);
+    AX12A m1(1, &chain);
+    AX12A m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+
+    EXPECT_CALL(uart, transmitPoll(_, _, 8, _))
+        .Times(2)
+        .WillRepeatedly(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, 8, _))
+        .Times(2)
+        .WillRepeatedly(Return(HAL_ERROR));
+
+    float positions[2];
+    bool isValid[2];
+    ASSERT_FALSE(group.getPositions(positions, isValid, 2));
+}
+
+TEST_F(MotorGroupTest, KeepsAX12APositionsOfMotorsThatAnswered){
+    DaisyChain chain(p);
+    AX12A m1(1, &chain);
+    AX12A m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+
+    uint8_t expectedTxArray1[] = {0xFF, 0xFF, 0x01, 0x04, 0x02, 0x24, 0x02, 0xD2};
+    uint8_t expectedTxArray2[] = {0xFF, 0xFF, 0x02, 0x04, 0x02, 0x24, 0x02, 0xD1};
+    uint8_t mockedRxArray[] = {0xFF, 0xFF, 0x01, 0x04, 0x00, 0xFF, 0x03, 0xF8};
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray1)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray2)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, 8, _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        )
+        .WillOnce(Return(HAL_TIMEOUT));
+
+    float positions[2] = {-1.0, -1.0};
+    bool isValid[2] = {false};
+    ASSERT_FALSE(group.getPositions(positions, isValid, 2));
+    ASSERT_TRUE(isValid[0]);
+    ASSERT_FALSE(isValid[1]);
+    EXPECT_FLOAT_EQ(positions[0], 300.0);
+    EXPECT_FLOAT_EQ(positions[1], -1.0);
+}
+
+TEST_F(MotorGroupTest, ReadsTelemetryOfDifferentWidths){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+
+    uint8_t expectedTxArray1[] = {0xFF, 0xFF, 0x01, 0x04, 0x02, 0x2B, 0x01, 0xCC};
+    uint8_t expectedTxArray2[] = {0xFF, 0xFF, 0x02, 0x04, 0x02, 0x2A, 0x01, 0xCC};
+    uint8_t mockedRxArray1[] = {0xFF, 0xFF, 0x01, 0x03, 0x00, 0x28, 0xD3};
+    uint8_t mockedRxArray2[] = {0xFF, 0xFF, 0x02, 0x03, 0x00, 0x78, 0x82};
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray1)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray2)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, 7, _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray1, mockedRxArray1 + sizeof(mockedRxArray1)),
+                Return(HAL_OK)
+            )
+        )
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray2, mockedRxArray2 + sizeof(mockedRxArray2)),
+                Return(HAL_OK)
+            )
+        );
+
+    dynamixel::TelemetryRead reads[] = {
+        {0, dynamixel::Telemetry::TEMPERATURE, 0.0, false},
+        {1, dynamixel::Telemetry::VOLTAGE, 0.0, false}
+    };
+    ASSERT_TRUE(group.readTelemetry(reads, 2));
+    ASSERT_TRUE(reads[0].isValid);
+    ASSERT_TRUE(reads[1].isValid);
+    EXPECT_FLOAT_EQ(reads[0].value, 40.0);
+    EXPECT_FLOAT_EQ(reads[1].value, 12.0);
+}
+
+TEST_F(MotorGroupTest, SendsProtocol2GoalPositionsInOneSyncWritePacket){
+    p.protocol = Protocol::V2;
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0xFE, 0x16, 0x00, 0x83, 0x74, 0x00, 0x04, 0x00,
+        0x01, 0x00, 0x00, 0x00, 0x00,
+        0x02, 0xFF, 0x07, 0x00, 0x00,
+        0x03, 0xFF, 0x0F, 0x00, 0x00,
+        0x3B, 0xE9
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    float angles[] = {0.0, 150.0, 300.0};
+    ASSERT_TRUE(group.setGoalPositions(angles, 3));
+}
+
+TEST_F(MotorGroupTest, BroadcastsProtocol2Action){
+    p.protocol = Protocol::V2;
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0xFE, 0x03, 0x00, 0x05, 0x2A, 0xC2
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    ASSERT_TRUE(group.action());
+}
+
+TEST_F(MotorGroupTest, ParsesFastSyncReadPositionsProperly){
+    p.protocol = Protocol::V2;
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+    ASSERT_FALSE(group.usesBulkRead());
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0xFE, 0x09, 0x00, 0x8A,
+        0x84, 0x00, 0x04, 0x00, 0x01, 0x02,
+        0x4D, 0x72
+    };
+    uint8_t mockedRxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0xFE, 0x11, 0x00, 0x55,
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x27, 0x23,
+        0x00, 0x02, 0xFF, 0x07, 0x00, 0x00, 0xBB, 0xAF
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    EXPECT_CALL(uart, receivePoll(_, _, sizeof(mockedRxArray), _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        );
+
+    float positions[2] = {0};
+    bool isValid[2] = {false};
+    ASSERT_TRUE(group.getPositions(positions, isValid, 2));
+    ASSERT_TRUE(isValid[0] && isValid[1]);
+    EXPECT_FLOAT_EQ(positions[0], 0.0);
+    EXPECT_FLOAT_EQ(positions[1], 2047 * dynamixel::MAX_ANGLE / 4095);
+}
+
+TEST_F(MotorGroupTest, ParsesSyncReadPositionsProperly){
+    p.protocol = Protocol::V2;
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+    group.useFastSyncRead(false);
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0xFE, 0x09, 0x00, 0x82,
+        0x84, 0x00, 0x04, 0x00, 0x01, 0x02,
+        0xCE, 0xFA
+    };
+    uint8_t mockedRxArray[] = {
+        0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x08, 0x00, 0x55,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0xBF, 0xB8,
+        0xFF, 0xFF, 0xFD, 0x00, 0x02, 0x08, 0x00, 0x55,
+        0x00, 0xFF, 0x0F, 0x00, 0x00, 0xFB, 0xBE
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    EXPECT_CALL(uart, receivePoll(_, _, sizeof(mockedRxArray), _))
+        .WillOnce(DoAll(
+                SetArrayArgument<1>(mockedRxArray, mockedRxArray + sizeof(mockedRxArray)),
+                Return(HAL_OK)
+            )
+        );
+
+    float positions[2] = {0};
+    bool isValid[2] = {false};
+    ASSERT_TRUE(group.getPositions(positions, isValid, 2));
+    ASSERT_TRUE(isValid[0] && isValid[1]);
+    EXPECT_FLOAT_EQ(positions[0], 0.0);
+    EXPECT_FLOAT_EQ(positions[1], 300.0);
+}
+
+TEST_F(MotorGroupTest, NegotiatesFastestSupportedBaudRate){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    uint8_t pingStatus[] = {0xFF, 0xFF, 0x01, 0x02, 0x00, 0xFC};
+
+    EXPECT_CALL(uart, getBaudRate(_)).WillOnce(Return(1000000));
+    EXPECT_CALL(uart, getAttainableBaudRate(_, _))
+        .WillRepeatedly(::testing::ReturnArg<1>());
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .WillRepeatedly(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .WillRepeatedly(DoAll(
+            SetArrayArgument<1>(pingStatus, pingStatus + sizeof(pingStatus)),
+            Return(HAL_OK)
+        ));
+
+    // The rates are stepped up through, slowest first
+    ::testing::InSequence s;
+    EXPECT_CALL(uart, setBaudRate(_, 2000000)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, setBaudRate(_, 2250000)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, setBaudRate(_, 2500000)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, setBaudRate(_, 3000000)).WillOnce(Return(HAL_OK));
+
+    ASSERT_TRUE(group.negotiateBaudRate());
+}
+
+TEST_F(MotorGroupTest, KeepsBaudRateNegotiatedOnPreviousBoot){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    uint8_t pingStatus[] = {0xFF, 0xFF, 0x01, 0x02, 0x00, 0xFC};
+
+    EXPECT_CALL(uart, getBaudRate(_)).WillOnce(Return(1000000));
+    EXPECT_CALL(uart, getAttainableBaudRate(_, _))
+        .WillRepeatedly(::testing::ReturnArg<1>());
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .WillRepeatedly(Return(HAL_OK));
+
+    // The motors are found at 2 Mbaud, and nothing faster is tried, so their
+    // baud rate register isn't written
+    ::testing::InSequence s;
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly(Return(HAL_TIMEOUT));
+    EXPECT_CALL(uart, setBaudRate(_, 2000000)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _)).WillOnce(DoAll(
+        SetArrayArgument<1>(pingStatus, pingStatus + sizeof(pingStatus)),
+        Return(HAL_OK)
+    ));
+
+    ASSERT_TRUE(group.negotiateBaudRate());
+}
+
+TEST_F(MotorGroupTest, FallsBackWhenMotorsStopRespondingAfterBaudRateChange){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    uint8_t pingStatus[] = {0xFF, 0xFF, 0x01, 0x02, 0x00, 0xFC};
+    auto respond = DoAll(
+        SetArrayArgument<1>(pingStatus, pingStatus + sizeof(pingStatus)),
+        Return(HAL_OK)
+    );
+
+    // Only 2 and 3 Mbaud are attainable. Once 2 Mbaud fails, 3 Mbaud isn't
+    // tried
+    EXPECT_CALL(uart, getBaudRate(_)).WillOnce(Return(1000000));
+    EXPECT_CALL(uart, getAttainableBaudRate(_, _))
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(uart, getAttainableBaudRate(_, 3000000))
+        .WillRepeatedly(Return(3000000));
+    EXPECT_CALL(uart, getAttainableBaudRate(_, 2000000))
+        .WillRepeatedly(Return(2000000));
+    EXPECT_CALL(uart, getAttainableBaudRate(_, 1000000))
+        .WillRepeatedly(Return(1000000));
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .WillRepeatedly(Return(HAL_OK));
+    EXPECT_CALL(uart, setBaudRate(_, 3000000)).Times(0);
+
+    ::testing::InSequence s;
+    EXPECT_CALL(uart, receivePoll(_, _, _, _)).WillOnce(respond);
+    EXPECT_CALL(uart, receivePoll(_, _, _, _)).WillOnce(Return(HAL_TIMEOUT));
+    EXPECT_CALL(uart, setBaudRate(_, 2000000)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly(Return(HAL_TIMEOUT));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _)).WillOnce(Return(HAL_TIMEOUT));
+    EXPECT_CALL(uart, setBaudRate(_, 1000000)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _)).WillOnce(respond);
+
+    ASSERT_TRUE(group.negotiateBaudRate());
+}
+
+TEST_F(MotorGroupTest, PingsUntilEveryMotorIsReady){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+
+    uint8_t ping1Status[] = {0xFF, 0xFF, 0x01, 0x02, 0x00, 0xFC};
+    uint8_t ping2Status[] = {0xFF, 0xFF, 0x02, 0x02, 0x00, 0xFB};
+
+    // Motor 1 answers in the first round. Motor 2 is still booting then, so
+    // it is pinged again in the second round, and motor 1 is not
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly(Return(HAL_OK));
+
+    ::testing::InSequence s;
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .WillOnce(DoAll(
+            SetArrayArgument<1>(ping1Status, ping1Status + sizeof(ping1Status)),
+            Return(HAL_OK)
+        ));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _)).WillOnce(Return(HAL_TIMEOUT));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .WillOnce(DoAll(
+            SetArrayArgument<1>(ping2Status, ping2Status + sizeof(ping2Status)),
+            Return(HAL_OK)
+        ));
+
+    ASSERT_TRUE(group.waitUntilReady(10));
+}
+
+TEST_F(MotorGroupTest, GivesUpWaitingForMotorsAfterMaxRounds){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .Times(4)
+        .WillRepeatedly(Return(HAL_OK));
+    EXPECT_CALL(uart, receivePoll(_, _, _, _))
+        .Times(4)
+        .WillRepeatedly(Return(HAL_TIMEOUT));
+
+    ASSERT_FALSE(group.waitUntilReady(4));
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - MotorGroup_Test */
@@ -286,6 +286,14 @@ TEST_F(MotorTest, CanGetTemperature){
     m.getTemperature(temp);
 }
 
+TEST_F(MotorTest, CanGetReturnDelayTime){
+    DaisyChain chain(p);
+    MockMotor m(1, &chain, ResolutionDivider::AX12A);
+
+    uint16_t delay = 0;
+    m.getReturnDelayTime(delay);
+}
+
 TEST_F(MotorTest, CanCheckIfIsJointMode){
     DaisyChain chain(p);
     MockMotor m(1, &chain, ResolutionDivider::AX12A);
@@ -348,6 +356,89 @@ TEST_F(MotorTest, ParsesReadDataExampleProperly){
     ASSERT_TRUE(temp == 32);
 }
 
+TEST_F(MotorTest, SkipsRewritesOfUnchangedGoalPosition){
+    DaisyChain chain(p);
+    MockMotor m(1, &chain, ResolutionDivider::AX12A);
+
+    uint8_t expectedTxArray[] = {
+        0xFF, 0xFF, 0x01, 0x05, 0x03, 0x1E, 0xFF, 0x01, 0xD8
+    };
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .With(Args<1, 2>(ElementsAreArray(expectedTxArray)))
+        .WillOnce(Return(HAL_OK));
+
+    ASSERT_TRUE(m.setGoalPosition(150.0));
+    ASSERT_TRUE(m.setGoalPosition(150.0));
+    ASSERT_EQ(m.getShadowHits(), 1);
+    ASSERT_EQ(m.getShadowMisses(), 1);
+}
+
+TEST_F(MotorTest, ForcesShadowRefreshAfterPeriod){
+    DaisyChain chain(p);
+    MockMotor m(1, &chain, ResolutionDivider::AX12A);
+    m.setShadowRefreshPeriod(2);
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(HAL_OK));
+
+    // Sent, skipped, skipped, sent
+    for(int i = 0; i < 4; ++i){
+        ASSERT_TRUE(m.setGoalPosition(150.0));
+    }
+    ASSERT_EQ(m.getShadowHits(), 2);
+    ASSERT_EQ(m.getShadowMisses(), 2);
+}
+
+TEST_F(MotorTest, CountsShadowRefreshPerRegister){
+    DaisyChain chain(p);
+    MockMotor m(1, &chain, ResolutionDivider::AX12A);
+    m.setShadowRefreshPeriod(2);
+
+    // Each register is sent, skipped twice, sent, and skipped twice. Skips
+    // of the punch must not count towards the goal position's refresh
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .Times(4)
+        .WillRepeatedly(Return(HAL_OK));
+
+    for(int i = 0; i < 6; ++i){
+        ASSERT_TRUE(m.setGoalPosition(150.0));
+        ASSERT_TRUE(m.setPunch(10.0));
+    }
+    ASSERT_EQ(m.getShadowHits(), 8);
+    ASSERT_EQ(m.getShadowMisses(), 4);
+}
+
+TEST_F(MotorTest, ResendsGoalPositionAfterFailedWrite){
+    DaisyChain chain(p);
+    MockMotor m(1, &chain, ResolutionDivider::AX12A);
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .WillOnce(Return(HAL_ERROR))
+        .WillOnce(Return(HAL_OK));
+
+    ASSERT_FALSE(m.setGoalPosition(150.0));
+    ASSERT_TRUE(m.setGoalPosition(150.0));
+    ASSERT_EQ(m.getShadowHits(), 0);
+}
+
+TEST_F(MotorTest, NeverSkipsUnshadowedRegisters){
+    DaisyChain chain(p);
+    MockMotor m(1, &chain, ResolutionDivider::AX12A);
+
+    // The motor clears torque enable by itself upon an alarm shutdown, so
+    // re-enabling it must always go out on the bus
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(HAL_OK));
+
+    ASSERT_TRUE(m.enableTorque(true));
+    ASSERT_TRUE(m.enableTorque(true));
+    ASSERT_EQ(m.getShadowHits(), 0);
+    ASSERT_EQ(m.getShadowMisses(), 0);
+}
+
 } // end anonymous namespace
 
 
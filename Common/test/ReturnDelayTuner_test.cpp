@@ -0,0 +1,241 @@
+/**
+  *****************************************************************************
+  * @file    ReturnDelayTuner_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup ReturnDelayTuner_Test
+  * @ingroup  ReturnDelayTuner
+  * @brief    Unit test driver for the return delay tuner
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "ReturnDelayTuner.h"
+#include "MX28.h"
+
+#include "MockUartInterface.h"
+#include "MockOsInterface.h"
+#include "MockGpioInterface.h"
+#include "GlobalMockTest.h"
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::Invoke;
+
+using uart::UartDriver;
+
+using mocks::MockOsInterface;
+using mocks::MockUartInterface;
+using mocks::MockGpioInterface;
+using mocks::GlobalMockTest;
+
+using dynamixel::DaisyChainParams;
+using dynamixel::DaisyChain;
+using dynamixel::Protocol;
+using dynamixel::MX28;
+using dynamixel::MotorGroup;
+using dynamixel::ReturnDelayTuner;
+using dynamixel::ReturnDelayStats;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+constexpr uint8_t REG_RETURN_DELAY_TIME = 0x05;
+constexpr uint8_t REG_CURRENT_TEMPERATURE = 0x2B;
+
+/** @brief Cycle counter ticks between consecutive reads of the fake counter */
+constexpr uint32_t CYCLES_PER_READ = 10;
+
+
+
+
+// Variables
+// ----------------------------------------------------------------------------
+MockUartInterface uart;
+MockOsInterface os;
+MockGpioInterface gpio;
+UART_HandleTypeDef UARTx = {0};
+UartDriver UARTxDriver(&os, &uart, &UARTx);
+
+GPIO_TypeDef dataDirPort;
+
+DaisyChainParams p;
+
+uint32_t cycles = 0;
+
+
+
+
+// Classes & structs
+// ----------------------------------------------------------------------------
+/**
+ * @brief Stands in for a single motor (Protocol 1.0) whose status packets
+ *        only arrive when its return delay time is at least minDelay
+ */
+struct SimulatedMotor{
+    uint16_t delay;
+    uint16_t minDelay;
+    uint8_t lastReadAddr = 0;
+    std::vector<uint16_t> delaysWritten{};
+
+    HAL_StatusTypeDef onTransmit(const uint8_t* arr){
+        const uint8_t instruction = arr[4];
+        if((instruction == 0x03) && (arr[5] == REG_RETURN_DELAY_TIME)){
+            delay = arr[6] << 1;
+            delaysWritten.push_back(delay);
+        }
+        else if(instruction == 0x02){
+            lastReadAddr = arr[5];
+        }
+
+        return HAL_OK;
+    }
+
+    HAL_StatusTypeDef onReceive(uint8_t* arr){
+        uint8_t value = 0;
+        switch(lastReadAddr){
+            case REG_RETURN_DELAY_TIME:
+                value = delay >> 1;
+                break;
+            case REG_CURRENT_TEMPERATURE:
+                if(delay < minDelay){
+                    return HAL_TIMEOUT;
+                }
+                value = 40;
+                break;
+            default:
+                return HAL_TIMEOUT;
+        }
+
+        uint8_t status[] = {0xFF, 0xFF, 0x01, 0x03, 0x00, value, 0x00};
+        status[6] = ~(0x01 + 0x03 + 0x00 + value) & 0xFF;
+        std::copy(status, status + sizeof(status), arr);
+        return HAL_OK;
+    }
+};
+
+class ReturnDelayTunerTest : public GlobalMockTest {
+protected:
+    ReturnDelayTunerTest() : GlobalMockTest(uart, os, gpio) {}
+
+    void SetUp() override {
+        p.uartDriver = &UARTxDriver;
+        p.gpioif = &gpio;
+        p.dataDirPort = &dataDirPort;
+        p.dataDirPinNum = 1;
+        p.protocol = Protocol::V1;
+    }
+
+    void attach(SimulatedMotor& sim){
+        EXPECT_CALL(uart, transmitPoll(_, _, _, _))
+            .WillRepeatedly(Invoke(
+                [&sim](const UART_HandleTypeDef*, uint8_t* arr, size_t, uint32_t){
+                    return sim.onTransmit(arr);
+                }
+            ));
+        EXPECT_CALL(uart, receivePoll(_, _, _, _))
+            .WillRepeatedly(Invoke(
+                [&sim](const UART_HandleTypeDef*, uint8_t* arr, size_t, uint32_t){
+                    return sim.onReceive(arr);
+                }
+            ));
+    }
+};
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+uint32_t readCycles(){
+    cycles += CYCLES_PER_READ;
+    return cycles;
+}
+
+TEST_F(ReturnDelayTunerTest, CanBeCreated){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    ReturnDelayTuner tuner(&group, readCycles);
+}
+
+TEST_F(ReturnDelayTunerTest, ReportsNoResultOutsideGroup){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    ReturnDelayTuner tuner(&group, readCycles);
+
+    ASSERT_FALSE(tuner.result(1).isReliable());
+}
+
+TEST_F(ReturnDelayTunerTest, FindsSmallestReliableReturnDelay){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    ReturnDelayTuner tuner(&group, readCycles, 5);
+
+    SimulatedMotor sim{100, 20};
+    attach(sim);
+
+    ASSERT_TRUE(tuner.tune(true));
+
+    const ReturnDelayStats& best = tuner.result(0);
+    EXPECT_EQ(best.delay, 20);
+    EXPECT_EQ(best.numTrials, 5);
+    EXPECT_EQ(best.numSuccesses, 5);
+    EXPECT_EQ(best.meanLatency, CYCLES_PER_READ);
+
+    // The sweep stops at the first unreliable delay, then settles
+    EXPECT_EQ(sim.delaysWritten[sim.delaysWritten.size() - 2], 16);
+    EXPECT_EQ(sim.delay, 20);
+}
+
+TEST_F(ReturnDelayTunerTest, RestoresOriginalReturnDelayWhenNotPersisting){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    ReturnDelayTuner tuner(&group, readCycles, 5);
+
+    SimulatedMotor sim{100, 50};
+    attach(sim);
+
+    ASSERT_TRUE(tuner.tune(false));
+    EXPECT_EQ(tuner.result(0).delay, 50);
+    EXPECT_EQ(sim.delay, 100);
+}
+
+TEST_F(ReturnDelayTunerTest, FailsWhenNoReturnDelayIsReliable){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    ReturnDelayTuner tuner(&group, readCycles, 5);
+
+    SimulatedMotor sim{100, 1000};
+    attach(sim);
+
+    ASSERT_FALSE(tuner.tune(true));
+    EXPECT_FALSE(tuner.result(0).isReliable());
+    EXPECT_EQ(sim.delay, 100);
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - ReturnDelayTuner_Test */
@@ -0,0 +1,246 @@
+/**
+  *****************************************************************************
+  * @file    StaticSpscRing_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup StaticSpscRing_Test
+  * @ingroup  StaticSpscRing
+  * @brief    Unit test driver for the single-producer single-consumer ring
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "StaticSpscRing.h"
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using buffer::StaticSpscRing;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Number of elements passed through the ring in the stress tests */
+constexpr uint32_t NUM_STRESS_ITEMS = 1000000;
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+void countNotification(void* context){
+    ++*static_cast<uint32_t*>(context);
+}
+
+TEST(StaticSpscRingTest, StartsEmpty){
+    StaticSpscRing<uint8_t, 8> ring;
+    uint8_t item;
+
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.size(), 0);
+    EXPECT_EQ(ring.capacity(), 8);
+    EXPECT_FALSE(ring.pop(item));
+}
+
+TEST(StaticSpscRingTest, PopsInOrderPushed){
+    StaticSpscRing<uint16_t, 4> ring;
+
+    ASSERT_TRUE(ring.push(10));
+    ASSERT_TRUE(ring.push(20));
+    ASSERT_TRUE(ring.push(30));
+    EXPECT_EQ(ring.size(), 3);
+
+    uint16_t item;
+    ASSERT_TRUE(ring.pop(item));
+    EXPECT_EQ(item, 10);
+    ASSERT_TRUE(ring.pop(item));
+    EXPECT_EQ(item, 20);
+    ASSERT_TRUE(ring.pop(item));
+    EXPECT_EQ(item, 30);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(StaticSpscRingTest, DropsWhenFull){
+    StaticSpscRing<uint8_t, 4> ring;
+
+    for(uint8_t i = 0; i < 4; ++i){
+        ASSERT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(ring.size(), 4);
+    EXPECT_EQ(ring.getNumDropped(), 1);
+
+    // The oldest element is kept, not the newest
+    uint8_t item;
+    ASSERT_TRUE(ring.pop(item));
+    EXPECT_EQ(item, 0);
+    EXPECT_TRUE(ring.push(5));
+}
+
+TEST(StaticSpscRingTest, WrapsAround){
+    StaticSpscRing<uint32_t, 4> ring;
+    uint32_t item;
+
+    for(uint32_t i = 0; i < 10; ++i){
+        ASSERT_TRUE(ring.push(i));
+        ASSERT_TRUE(ring.push(i + 100));
+        ASSERT_TRUE(ring.pop(item));
+        EXPECT_EQ(item, i);
+        ASSERT_TRUE(ring.pop(item));
+        EXPECT_EQ(item, i + 100);
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(StaticSpscRingTest, WritesAndReadsInBulk){
+    StaticSpscRing<uint8_t, 8> ring;
+    const uint8_t in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint8_t out[10] = {0};
+
+    ASSERT_EQ(ring.write(in, 6), 6);
+    ASSERT_EQ(ring.read(out, 4), 4);
+
+    // Straddles the end of the storage, and only 6 of 10 fit
+    ASSERT_EQ(ring.write(in, 10), 6);
+    EXPECT_EQ(ring.getNumDropped(), 4);
+
+    ASSERT_EQ(ring.read(out, 10), 8);
+    const uint8_t expected[8] = {4, 5, 0, 1, 2, 3, 4, 5};
+    for(size_t i = 0; i < 8; ++i){
+        EXPECT_EQ(out[i], expected[i]);
+    }
+}
+
+TEST(StaticSpscRingTest, NotifiesOnlyWhenNoLongerEmpty){
+    StaticSpscRing<uint8_t, 4> ring;
+    uint32_t numNotifications = 0;
+    ring.setNotifier(countNotification, &numNotifications);
+
+    ASSERT_TRUE(ring.push(1));
+    EXPECT_EQ(numNotifications, 1);
+    ASSERT_TRUE(ring.push(2));
+    EXPECT_EQ(numNotifications, 1);
+
+    uint8_t item;
+    ASSERT_TRUE(ring.pop(item));
+    ASSERT_TRUE(ring.push(3));
+    EXPECT_EQ(numNotifications, 1);
+
+    ASSERT_TRUE(ring.pop(item));
+    ASSERT_TRUE(ring.pop(item));
+    ASSERT_TRUE(ring.push(4));
+    EXPECT_EQ(numNotifications, 2);
+
+    // Nothing was added, so there is nothing to notify about
+    ASSERT_TRUE(ring.push(5));
+    ASSERT_TRUE(ring.push(6));
+    ASSERT_TRUE(ring.push(7));
+    EXPECT_FALSE(ring.push(8));
+    EXPECT_EQ(numNotifications, 2);
+}
+
+TEST(StaticSpscRingTest, StressPassesEveryItemInOrder){
+    StaticSpscRing<uint32_t, 64> ring;
+
+    std::thread producer([&ring](){
+        for(uint32_t i = 0; i < NUM_STRESS_ITEMS;){
+            if(ring.push(i)){
+                ++i;
+            }
+            else{
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t numOutOfOrder = 0;
+    while(expected < NUM_STRESS_ITEMS){
+        uint32_t items[16];
+        const size_t n = ring.read(items, 16);
+        for(size_t i = 0; i < n; ++i){
+            if(items[i] != expected){
+                ++numOutOfOrder;
+            }
+            ++expected;
+        }
+        if(n == 0){
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_EQ(numOutOfOrder, 0);
+    EXPECT_TRUE(ring.empty());
+}
+
+/** @brief Context for the notifier in StressNeverMissesNotification */
+struct WakeContext{
+    std::atomic<uint32_t> numWakes{0};
+};
+
+void wake(void* context){
+    static_cast<WakeContext*>(context)->numWakes.fetch_add(1);
+}
+
+TEST(StaticSpscRingTest, StressNeverMissesNotification){
+    // The consumer only looks at the ring after being notified and sleeps
+    // once it has emptied it, as a thread woken from an ISR would. A missed
+    // notification would leave it asleep with items in the ring
+    StaticSpscRing<uint32_t, 16> ring;
+    WakeContext ctx;
+    ring.setNotifier(wake, &ctx);
+
+    std::thread producer([&ring](){
+        for(uint32_t i = 0; i < NUM_STRESS_ITEMS;){
+            if(ring.push(i)){
+                ++i;
+            }
+            else{
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t numWakesSeen = 0;
+    uint32_t numOutOfOrder = 0;
+    while(expected < NUM_STRESS_ITEMS){
+        const uint32_t numWakes = ctx.numWakes.load();
+        if(numWakes == numWakesSeen){
+            std::this_thread::yield();
+            continue;
+        }
+        numWakesSeen = numWakes;
+
+        uint32_t item;
+        while(ring.pop(item)){
+            if(item != expected){
+                ++numOutOfOrder;
+            }
+            ++expected;
+        }
+    }
+
+    producer.join();
+    EXPECT_EQ(numOutOfOrder, 0);
+    EXPECT_TRUE(ring.empty());
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - StaticSpscRing_Test */
@@ -0,0 +1,230 @@
+/**
+  *****************************************************************************
+  * @file    StatusPacketDecoder_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup StatusPacketDecoder_Test
+  * @ingroup  StatusPacketDecoder
+  * @brief    Unit test driver for the status packet decoder
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "StatusPacketDecoder.h"
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using dynamixel::Protocol;
+using dynamixel::StatusPacket;
+using dynamixel::StatusPacketDecoder;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Status packet from motor 1 with 1 parameter (0x20) */
+constexpr uint8_t STATUS_1_PARAM[] = {0xFF, 0xFF, 0x01, 0x03, 0x00, 0x20, 0xDB};
+
+/** @brief Status packet from motor 2 with 2 parameters (0x00, 0x02) */
+constexpr uint8_t STATUS_2_PARAMS[] = {
+    0xFF, 0xFF, 0x02, 0x04, 0x00, 0x00, 0x02, 0xF7
+};
+
+/** @brief Protocol 2.0 ping response from motor 1 (e-manual example) */
+constexpr uint8_t STATUS2_PING[] = {
+    0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x55, 0x00, 0x06, 0x04, 0x26,
+    0x65, 0x5D
+};
+
+
+
+
+// Classes & structs
+// ----------------------------------------------------------------------------
+/** @brief A copy of a reported packet that outlives the handler call */
+struct Reported{
+    uint8_t id;
+    uint8_t error;
+    std::vector<uint8_t> params;
+};
+
+class StatusPacketDecoderTest : public ::testing::Test {
+protected:
+    static void record(const StatusPacket& packet, void* context){
+        auto* reported = static_cast<std::vector<Reported>*>(context);
+        reported->push_back({
+            packet.id,
+            packet.error,
+            std::vector<uint8_t>(
+                packet.params,
+                packet.params + packet.numParams
+            )
+        });
+    }
+
+    void attach(StatusPacketDecoder& decoder){
+        decoder.setHandler(record, &reported);
+    }
+
+    std::vector<Reported> reported;
+};
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+TEST_F(StatusPacketDecoderTest, DecodesSinglePacket){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    ASSERT_EQ(decoder.feed(STATUS_1_PARAM, sizeof(STATUS_1_PARAM)), 1);
+    ASSERT_EQ(reported.size(), 1);
+    EXPECT_EQ(reported[0].id, 1);
+    EXPECT_EQ(reported[0].error, 0);
+    EXPECT_EQ(reported[0].params, std::vector<uint8_t>({0x20}));
+    EXPECT_EQ(decoder.getNumPackets(), 1);
+    EXPECT_EQ(decoder.getNumDiscardedBytes(), 0);
+}
+
+TEST_F(StatusPacketDecoderTest, DecodesBackToBackPacketsOfDifferentLengths){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    std::vector<uint8_t> stream(STATUS_2_PARAMS, std::end(STATUS_2_PARAMS));
+    stream.insert(stream.end(), STATUS_1_PARAM, std::end(STATUS_1_PARAM));
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 2);
+    ASSERT_EQ(reported.size(), 2);
+    EXPECT_EQ(reported[0].id, 2);
+    EXPECT_EQ(reported[0].params, std::vector<uint8_t>({0x00, 0x02}));
+    EXPECT_EQ(reported[1].id, 1);
+}
+
+TEST_F(StatusPacketDecoderTest, DecodesPacketFedOneByteAtATime){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    for(size_t i = 0; i < sizeof(STATUS_2_PARAMS) - 1; ++i){
+        ASSERT_EQ(decoder.feed(&STATUS_2_PARAMS[i], 1), 0);
+    }
+    ASSERT_EQ(decoder.feed(&STATUS_2_PARAMS[sizeof(STATUS_2_PARAMS) - 1], 1), 1);
+    EXPECT_EQ(reported[0].id, 2);
+}
+
+TEST_F(StatusPacketDecoderTest, SkipsLeadingGarbage){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    std::vector<uint8_t> stream = {0x12, 0x00, 0xFF, 0x34};
+    stream.insert(stream.end(), STATUS_1_PARAM, std::end(STATUS_1_PARAM));
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 1);
+    EXPECT_EQ(reported[0].id, 1);
+    EXPECT_EQ(decoder.getNumDiscardedBytes(), 4);
+}
+
+TEST_F(StatusPacketDecoderTest, FindsHeaderAfterExtraHeaderByte){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    std::vector<uint8_t> stream = {0xFF};
+    stream.insert(stream.end(), STATUS_1_PARAM, std::end(STATUS_1_PARAM));
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 1);
+    EXPECT_EQ(reported[0].id, 1);
+    EXPECT_EQ(decoder.getNumDiscardedBytes(), 1);
+}
+
+TEST_F(StatusPacketDecoderTest, ResynchronizesAfterDroppedByte){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    // The first packet loses its ERROR byte, so its LENGTH field claims the
+    // header of the next packet, whose checksum then fails
+    std::vector<uint8_t> stream = {0xFF, 0xFF, 0x02, 0x04, 0x00, 0x02, 0xF7};
+    stream.insert(stream.end(), STATUS_1_PARAM, std::end(STATUS_1_PARAM));
+    stream.insert(stream.end(), STATUS_2_PARAMS, std::end(STATUS_2_PARAMS));
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 2);
+    ASSERT_EQ(reported.size(), 2);
+    EXPECT_EQ(reported[0].id, 1);
+    EXPECT_EQ(reported[1].id, 2);
+    EXPECT_EQ(decoder.getNumChecksumErrors(), 1);
+}
+
+TEST_F(StatusPacketDecoderTest, CountsChecksumErrors){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    std::vector<uint8_t> stream(STATUS_1_PARAM, std::end(STATUS_1_PARAM));
+    stream.back() ^= 0x01;
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 0);
+    EXPECT_TRUE(reported.empty());
+    EXPECT_EQ(decoder.getNumChecksumErrors(), 1);
+    EXPECT_EQ(decoder.getNumPackets(), 0);
+}
+
+TEST_F(StatusPacketDecoderTest, RejectsOversizedLength){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    std::vector<uint8_t> stream = {0xFF, 0xFF, 0x01, 0xF0};
+    stream.insert(stream.end(), STATUS_1_PARAM, std::end(STATUS_1_PARAM));
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 1);
+    EXPECT_EQ(reported[0].id, 1);
+}
+
+TEST_F(StatusPacketDecoderTest, DiscardsPartialPacketOnReset){
+    StatusPacketDecoder decoder(Protocol::V1);
+    attach(decoder);
+
+    ASSERT_EQ(decoder.feed(STATUS_2_PARAMS, 4), 0);
+    decoder.reset();
+    ASSERT_EQ(decoder.feed(STATUS_1_PARAM, sizeof(STATUS_1_PARAM)), 1);
+    EXPECT_EQ(reported[0].id, 1);
+}
+
+TEST_F(StatusPacketDecoderTest, DecodesProtocol2Packet){
+    StatusPacketDecoder decoder(Protocol::V2);
+    attach(decoder);
+
+    std::vector<uint8_t> stream = {0x00, 0xFF};
+    stream.insert(stream.end(), STATUS2_PING, std::end(STATUS2_PING));
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 1);
+    EXPECT_EQ(reported[0].id, 1);
+    EXPECT_EQ(reported[0].error, 0);
+    EXPECT_EQ(reported[0].params, std::vector<uint8_t>({0x06, 0x04, 0x26}));
+}
+
+TEST_F(StatusPacketDecoderTest, CountsProtocol2CrcErrors){
+    StatusPacketDecoder decoder(Protocol::V2);
+    attach(decoder);
+
+    std::vector<uint8_t> stream(STATUS2_PING, std::end(STATUS2_PING));
+    stream[9] ^= 0x01;
+
+    ASSERT_EQ(decoder.feed(stream.data(), stream.size()), 0);
+    EXPECT_EQ(decoder.getNumChecksumErrors(), 1);
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - StatusPacketDecoder_Test */
@@ -0,0 +1,287 @@
+/**
+  *****************************************************************************
+  * @file    TelemetryScheduler_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup TelemetryScheduler_Test
+  * @ingroup  TelemetryScheduler
+  * @brief    Unit test driver for the telemetry scheduler
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "TelemetryScheduler.h"
+#include "MX28.h"
+
+#include "MockUartInterface.h"
+#include "MockOsInterface.h"
+#include "MockGpioInterface.h"
+#include "GlobalMockTest.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::Return;
+
+using uart::UartDriver;
+
+using mocks::MockOsInterface;
+using mocks::MockUartInterface;
+using mocks::MockGpioInterface;
+using mocks::GlobalMockTest;
+
+using dynamixel::DaisyChainParams;
+using dynamixel::DaisyChain;
+using dynamixel::Protocol;
+using dynamixel::MX28;
+using dynamixel::MotorGroup;
+using dynamixel::Telemetry;
+using dynamixel::TelemetryRead;
+using dynamixel::TelemetryScheduler;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Rate at which the control loop advances the schedules */
+constexpr uint32_t CYCLE_RATE_HZ = 500;
+
+
+
+
+// Variables
+// ----------------------------------------------------------------------------
+MockUartInterface uart;
+MockOsInterface os;
+MockGpioInterface gpio;
+UART_HandleTypeDef UARTx = {0};
+UartDriver UARTxDriver(&os, &uart, &UARTx);
+
+GPIO_TypeDef dataDirPort;
+
+DaisyChainParams p;
+
+
+
+
+// Classes & structs
+// ----------------------------------------------------------------------------
+class TelemetrySchedulerTest : public GlobalMockTest {
+protected:
+    TelemetrySchedulerTest() : GlobalMockTest(uart, os, gpio) {}
+
+    void SetUp() override {
+        EXPECT_CALL(uart, getBaudRate(_)).WillRepeatedly(Return(1000000));
+        p.uartDriver = &UARTxDriver;
+        p.gpioif = &gpio;
+        p.dataDirPort = &dataDirPort;
+        p.dataDirPinNum = 1;
+        p.protocol = Protocol::V1;
+    }
+
+    /** @brief Counts the picked readings of one quantity */
+    static size_t count(const TelemetryRead* reads, size_t n, Telemetry item){
+        size_t total = 0;
+        for(size_t i = 0; i < n; ++i){
+            if(reads[i].item == item){
+                ++total;
+            }
+        }
+        return total;
+    }
+};
+
+
+
+
+// Functions
+// ----------------------------------------------------------------------------
+TEST_F(TelemetrySchedulerTest, SchedulesNothingByDefault){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    ASSERT_EQ(scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS), 0);
+}
+
+TEST_F(TelemetrySchedulerTest, RejectsMotorsOutsideGroup){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    ASSERT_FALSE(scheduler.setRate(1, Telemetry::LOAD, 100));
+    ASSERT_TRUE(scheduler.setRate(0, Telemetry::LOAD, 100));
+}
+
+TEST_F(TelemetrySchedulerTest, ReadsEachQuantityAtItsRate){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    ASSERT_TRUE(scheduler.setRate(Telemetry::POSITION, 500));
+    ASSERT_TRUE(scheduler.setRate(Telemetry::LOAD, 100));
+    ASSERT_TRUE(scheduler.setRate(Telemetry::TEMPERATURE, 2));
+
+    size_t numReadings[dynamixel::NUM_TELEMETRY] = {0};
+    TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    for(uint32_t cycle = 0; cycle < CYCLE_RATE_HZ; ++cycle){
+        size_t n = scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS);
+        ASSERT_EQ(count(reads, n, Telemetry::POSITION), 3);
+        for(size_t j = 0; j < dynamixel::NUM_TELEMETRY; ++j){
+            numReadings[j] += count(reads, n, static_cast<Telemetry>(j));
+        }
+    }
+
+    EXPECT_EQ(numReadings[static_cast<size_t>(Telemetry::POSITION)], 3 * 500);
+    EXPECT_EQ(numReadings[static_cast<size_t>(Telemetry::LOAD)], 3 * 100);
+    EXPECT_EQ(numReadings[static_cast<size_t>(Telemetry::TEMPERATURE)], 3 * 2);
+    EXPECT_EQ(numReadings[static_cast<size_t>(Telemetry::VOLTAGE)], 0);
+}
+
+TEST_F(TelemetrySchedulerTest, AppliesRatesPerMotor){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    ASSERT_TRUE(scheduler.setRate(0, Telemetry::POSITION, 500));
+    ASSERT_TRUE(scheduler.setRate(1, Telemetry::POSITION, 50));
+
+    size_t numReadings[2] = {0};
+    TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    for(uint32_t cycle = 0; cycle < CYCLE_RATE_HZ; ++cycle){
+        size_t n = scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS);
+        for(size_t i = 0; i < n; ++i){
+            ++numReadings[reads[i].motorIdx];
+        }
+    }
+
+    EXPECT_EQ(numReadings[0], 500);
+    EXPECT_EQ(numReadings[1], 50);
+}
+
+TEST_F(TelemetrySchedulerTest, NeverDefersFastestReads){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MX28 m3(3, &chain);
+    MotorGroup group(&chain, {&m1, &m2, &m3});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    ASSERT_TRUE(scheduler.setRate(Telemetry::POSITION, 500));
+    ASSERT_TRUE(scheduler.setRate(Telemetry::TEMPERATURE, 100));
+
+    // Not even enough for the positions
+    scheduler.setCycleBudget(group.estimateReadTime(Telemetry::POSITION));
+
+    TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    size_t n = scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS);
+    ASSERT_EQ(n, 3);
+    EXPECT_EQ(count(reads, n, Telemetry::POSITION), 3);
+    EXPECT_EQ(scheduler.getNumDeferred(), 3);
+}
+
+TEST_F(TelemetrySchedulerTest, PacksSlowReadsIntoLeftoverTime){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    ASSERT_TRUE(scheduler.setRate(Telemetry::POSITION, 500));
+    ASSERT_TRUE(scheduler.setRate(Telemetry::LOAD, 100));
+
+    // Room for the positions and one load reading per cycle
+    const uint32_t positionTime = group.estimateReadTime(Telemetry::POSITION);
+    const uint32_t loadTime = group.estimateReadTime(Telemetry::LOAD);
+    scheduler.setCycleBudget(2 * positionTime + loadTime);
+
+    TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    size_t n = scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS);
+    EXPECT_EQ(count(reads, n, Telemetry::POSITION), 2);
+    EXPECT_EQ(count(reads, n, Telemetry::LOAD), 1);
+    EXPECT_EQ(scheduler.getNumDeferred(), 1);
+
+    // The deferred load reading goes out in the next cycle
+    n = scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS);
+    EXPECT_EQ(count(reads, n, Telemetry::POSITION), 2);
+    ASSERT_EQ(count(reads, n, Telemetry::LOAD), 1);
+    EXPECT_EQ(reads[n - 1].motorIdx, 1);
+}
+
+TEST_F(TelemetrySchedulerTest, FillsGapWithCheaperRead){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    // The load reading comes first, being more frequent, but is wider than
+    // the room left
+    ASSERT_TRUE(scheduler.setRate(Telemetry::POSITION, 500));
+    ASSERT_TRUE(scheduler.setRate(Telemetry::LOAD, 100));
+    ASSERT_TRUE(scheduler.setRate(Telemetry::TEMPERATURE, 2));
+
+    const uint32_t positionTime = group.estimateReadTime(Telemetry::POSITION);
+    const uint32_t temperatureTime =
+        group.estimateReadTime(Telemetry::TEMPERATURE);
+    ASSERT_LT(temperatureTime, group.estimateReadTime(Telemetry::LOAD));
+    scheduler.setCycleBudget(positionTime + temperatureTime);
+
+    TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    size_t n = scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS);
+    EXPECT_EQ(count(reads, n, Telemetry::POSITION), 1);
+    EXPECT_EQ(count(reads, n, Telemetry::LOAD), 0);
+    EXPECT_EQ(count(reads, n, Telemetry::TEMPERATURE), 1);
+}
+
+TEST_F(TelemetrySchedulerTest, StopsAtCapacity){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MX28 m2(2, &chain);
+    MotorGroup group(&chain, {&m1, &m2});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    ASSERT_TRUE(scheduler.setRate(Telemetry::POSITION, 500));
+
+    TelemetryRead reads[1];
+    ASSERT_EQ(scheduler.schedule(reads, 1), 1);
+    EXPECT_EQ(scheduler.getNumDeferred(), 1);
+}
+
+TEST_F(TelemetrySchedulerTest, DisablesReadsAtZeroRate){
+    DaisyChain chain(p);
+    MX28 m1(1, &chain);
+    MotorGroup group(&chain, {&m1});
+    TelemetryScheduler scheduler(&group, CYCLE_RATE_HZ);
+
+    ASSERT_TRUE(scheduler.setRate(Telemetry::LOAD, 500));
+    ASSERT_TRUE(scheduler.setRate(Telemetry::LOAD, 0));
+
+    TelemetryRead reads[dynamixel::MAX_TELEMETRY_READS];
+    ASSERT_EQ(scheduler.schedule(reads, dynamixel::MAX_TELEMETRY_READS), 0);
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - TelemetryScheduler_Test */
@@ -0,0 +1,237 @@
+/**
+  *****************************************************************************
+  * @file    TrajectoryBuffer_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup TrajectoryBuffer_Test
+  * @ingroup  TrajectoryBuffer
+  * @brief    Unit test driver for the goal trajectory buffer
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "TrajectoryBuffer.h"
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+using trajectory::TrajectoryBuffer;
+using trajectory::Interpolation;
+using trajectory::Setpoint;
+using trajectory::NUM_JOINTS;
+using trajectory::TRAJECTORY_CAPACITY;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Functions
+// ----------------------------------------------------------------------------
+/** @brief Builds a setpoint with every joint at the same angle */
+Setpoint makeSetpoint(float angle, uint32_t durationMs, bool replace = false){
+    Setpoint setpoint;
+    setpoint.durationMs = durationMs;
+    setpoint.replace = replace;
+    std::fill(setpoint.angles, setpoint.angles + NUM_JOINTS, angle);
+    return setpoint;
+}
+
+/** @brief Samples the first joint's angle */
+float sampleAngle(TrajectoryBuffer& trajectory, uint32_t nowMs){
+    float angles[NUM_JOINTS];
+    EXPECT_TRUE(trajectory.sample(nowMs, angles));
+    return angles[0];
+}
+
+TEST(TrajectoryBufferTest, HasNothingToSampleAtFirst){
+    TrajectoryBuffer trajectory;
+    float angles[NUM_JOINTS];
+    EXPECT_FALSE(trajectory.sample(0, angles));
+    EXPECT_FALSE(trajectory.isMoving(0));
+}
+
+TEST(TrajectoryBufferTest, JumpsToFirstSetpoint){
+    TrajectoryBuffer trajectory;
+    ASSERT_TRUE(trajectory.push(makeSetpoint(30.0f, 100), 1000));
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 1000), 30.0f);
+    EXPECT_FALSE(trajectory.isMoving(1000));
+}
+
+TEST(TrajectoryBufferTest, InterpolatesLinearly){
+    TrajectoryBuffer trajectory(Interpolation::LINEAR);
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(100.0f, 100), 0);
+    trajectory.push(makeSetpoint(50.0f, 50), 0);
+
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 0), 0.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 25), 25.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 100), 100.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 125), 75.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 150), 50.0f);
+    EXPECT_FALSE(trajectory.isMoving(150));
+}
+
+TEST(TrajectoryBufferTest, HermitePassesThroughSetpointsSmoothly){
+    TrajectoryBuffer trajectory;
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(10.0f, 100), 0);
+    trajectory.push(makeSetpoint(30.0f, 100), 0);
+    trajectory.push(makeSetpoint(30.0f, 100), 0);
+
+    // The speed is continuous through each setpoint, so no step between
+    // samples is much different from the one before it
+    float last = sampleAngle(trajectory, 0);
+    float lastStep = 0.0f;
+    for(uint32_t t = 1; t <= 300; ++t){
+        const float angle = sampleAngle(trajectory, t);
+        const float step = angle - last;
+        EXPECT_NEAR(step, lastStep, 0.01f) << "at " << t << " ms";
+        last = angle;
+        lastStep = step;
+
+        if(t == 100){
+            EXPECT_FLOAT_EQ(angle, 10.0f);
+        }
+        else if(t == 200){
+            EXPECT_FLOAT_EQ(angle, 30.0f);
+        }
+    }
+    EXPECT_FLOAT_EQ(last, 30.0f);
+}
+
+TEST(TrajectoryBufferTest, HermiteDoesNotOvershootSetpoints){
+    TrajectoryBuffer trajectory;
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(290.0f, 100), 0);
+    trajectory.push(makeSetpoint(300.0f, 100), 0);
+    trajectory.push(makeSetpoint(0.0f, 100), 0);
+
+    // Averaging the slopes through 290 would carry the joint past 300, which
+    // is out of range for the motors
+    float last = sampleAngle(trajectory, 0);
+    for(uint32_t t = 1; t <= 200; ++t){
+        const float angle = sampleAngle(trajectory, t);
+        EXPECT_GE(angle, last) << "at " << t << " ms";
+        EXPECT_LE(angle, 300.0f) << "at " << t << " ms";
+        last = angle;
+    }
+    for(uint32_t t = 201; t <= 300; ++t){
+        const float angle = sampleAngle(trajectory, t);
+        EXPECT_LE(angle, last) << "at " << t << " ms";
+        EXPECT_GE(angle, 0.0f) << "at " << t << " ms";
+        last = angle;
+    }
+}
+
+TEST(TrajectoryBufferTest, ReplacingDoesNotOvershootSetpoint){
+    TrajectoryBuffer trajectory;
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(100.0f, 100), 0);
+    trajectory.push(makeSetpoint(200.0f, 100), 0);
+
+    // The joint is moving fast when it's sent to a setpoint just ahead
+    const float start = sampleAngle(trajectory, 100);
+    trajectory.push(makeSetpoint(110.0f, 100, true), 100);
+    for(uint32_t t = 100; t <= 300; ++t){
+        const float angle = sampleAngle(trajectory, t);
+        EXPECT_GE(angle, start) << "at " << t << " ms";
+        EXPECT_LE(angle, 110.0f) << "at " << t << " ms";
+    }
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 200), 110.0f);
+}
+
+TEST(TrajectoryBufferTest, ComesToRestWhenStarved){
+    TrajectoryBuffer trajectory;
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(20.0f, 100), 0);
+
+    EXPECT_TRUE(trajectory.isMoving(50));
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 50), 10.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 100), 20.0f);
+    EXPECT_FALSE(trajectory.isMoving(100));
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 500), 20.0f);
+
+    // A late setpoint is moved to from where the joints came to rest, over
+    // its whole duration
+    trajectory.push(makeSetpoint(40.0f, 100), 500);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 500), 20.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 550), 30.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 600), 40.0f);
+}
+
+TEST(TrajectoryBufferTest, ReplacingKeepsPositionAndSpeed){
+    TrajectoryBuffer trajectory(Interpolation::LINEAR);
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(100.0f, 100), 0);
+    trajectory.push(makeSetpoint(-100.0f, 100), 0);
+
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 40), 40.0f);
+    trajectory.push(makeSetpoint(60.0f, 20, true), 40);
+    EXPECT_EQ(trajectory.size(), 0);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 40), 40.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 50), 50.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 60), 60.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 200), 60.0f);
+}
+
+TEST(TrajectoryBufferTest, HoldDiscardsQueuedSetpoints){
+    TrajectoryBuffer trajectory;
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(100.0f, 100), 0);
+
+    float angles[NUM_JOINTS];
+    std::fill(angles, angles + NUM_JOINTS, -5.0f);
+    trajectory.hold(angles, 10);
+    EXPECT_FALSE(trajectory.isMoving(10));
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 50), -5.0f);
+}
+
+TEST(TrajectoryBufferTest, DropsSetpointsWhenFull){
+    TrajectoryBuffer trajectory;
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    for(size_t i = 0; i < TRAJECTORY_CAPACITY; ++i){
+        ASSERT_TRUE(trajectory.push(makeSetpoint(1.0f * i, 10), 0));
+    }
+    EXPECT_FALSE(trajectory.push(makeSetpoint(99.0f, 10), 0));
+    EXPECT_EQ(trajectory.getNumDropped(), 1);
+    EXPECT_EQ(trajectory.size(), TRAJECTORY_CAPACITY);
+
+    // Room is made as setpoints are reached
+    sampleAngle(trajectory, 10);
+    EXPECT_TRUE(trajectory.push(makeSetpoint(99.0f, 10), 10));
+}
+
+TEST(TrajectoryBufferTest, HandlesClockWrap){
+    TrajectoryBuffer trajectory(Interpolation::LINEAR);
+    const uint32_t start = UINT32_MAX - 49;
+    trajectory.push(makeSetpoint(0.0f, 0), start);
+    trajectory.push(makeSetpoint(100.0f, 100), start);
+
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, start + 50), 50.0f);
+    EXPECT_TRUE(trajectory.isMoving(start + 50));
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, start + 75), 75.0f);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, start + 100), 100.0f);
+    EXPECT_FALSE(trajectory.isMoving(start + 100));
+}
+
+TEST(TrajectoryBufferTest, JumpsToInstantSetpoints){
+    TrajectoryBuffer trajectory;
+    trajectory.push(makeSetpoint(0.0f, 0), 0);
+    trajectory.push(makeSetpoint(10.0f, 0), 5);
+    EXPECT_FLOAT_EQ(sampleAngle(trajectory, 5), 10.0f);
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - TrajectoryBuffer_Test */
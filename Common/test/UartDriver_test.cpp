@@ -19,12 +19,15 @@
 
 #include "MockUartInterface.h"
 #include "MockOsInterface.h"
+#include "MockTimerInterface.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 
 using ::testing::DoAll;
+using ::testing::InSequence;
+using ::testing::InvokeWithoutArgs;
 using ::testing::SetArgPointee;
 using ::testing::Return;
 using ::testing::_;
@@ -32,6 +35,7 @@ using ::testing::_;
 
 using uart::UartDriver;
 using mocks::MockOsInterface;
+using mocks::MockTimerInterface;
 using mocks::MockUartInterface;
 
 
@@ -39,8 +43,43 @@ using mocks::MockUartInterface;
 
 /******************************** File-local *********************************/
 namespace{
+// Constants
+// ----------------------------------------------------------------------------
+/** @brief Microsecond timeout used by the tests that set one */
+constexpr uint32_t MAX_BLOCK_TIME_US = 300;
+
+/** @brief Cycles the fake cycle counter advances by each time a task blocks */
+constexpr uint32_t CYCLES_PER_WAIT = 50;
+
+
+
+
+// Variables
+// ----------------------------------------------------------------------------
+/** @brief Fake cycle counter, counting one cycle per microsecond */
+uint32_t cycles = 0;
+
+
+
+
 // Functions
 // ----------------------------------------------------------------------------
+uint32_t readCycles(){
+    return cycles;
+}
+
+/**
+ * @brief Sets up a driver with microsecond timeouts at 1 Mbps. Time only
+ *        passes when the tests make it
+ */
+void useMicrosecondTimeouts(UartDriver& driver, MockUartInterface& uart){
+    cycles = 0;
+    driver.setCycleCounter(readCycles, 1);
+    driver.setMaxBlockTimeUs(MAX_BLOCK_TIME_US);
+
+    EXPECT_CALL(uart, getBaudRate(_)).WillRepeatedly(Return(1000000));
+}
+
 TEST(UartDriver, CanGetIOType){
     UartDriver UARTxDriver;
 
@@ -597,6 +636,467 @@ TEST(UartDriver, DMAReceiveCanSucceed){
     ASSERT_TRUE(success);
 }
 
+TEST(UartDriver, SupportsBaudRatesWithinTolerance){
+    MockUartInterface uart;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(nullptr, &uart, &UARTx);
+
+    EXPECT_CALL(uart, getAttainableBaudRate(_, 3000000)).WillOnce(
+        Return(2812500)
+    );
+    EXPECT_CALL(uart, getAttainableBaudRate(_, 2250000)).WillOnce(
+        Return(2250000)
+    );
+    EXPECT_CALL(uart, getAttainableBaudRate(_, 1000000)).WillOnce(
+        Return(1011235)
+    );
+
+    ASSERT_FALSE(UARTxDriver.supportsBaudRate(3000000));
+    ASSERT_TRUE(UARTxDriver.supportsBaudRate(2250000));
+    ASSERT_TRUE(UARTxDriver.supportsBaudRate(1000000));
+}
+
+TEST(UartDriver, ShouldNotSetUnattainableBaudRate){
+    MockUartInterface uart;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(nullptr, &uart, &UARTx);
+
+    EXPECT_CALL(uart, getAttainableBaudRate(_, _)).WillOnce(Return(0));
+    EXPECT_CALL(uart, setBaudRate(_, _)).Times(0);
+
+    ASSERT_FALSE(UARTxDriver.setBaudRate(3000000));
+}
+
+TEST(UartDriver, CanSetBaudRate){
+    MockUartInterface uart;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(nullptr, &uart, &UARTx);
+
+    EXPECT_CALL(uart, getAttainableBaudRate(_, 2000000)).WillOnce(
+        Return(2000000)
+    );
+    EXPECT_CALL(uart, setBaudRate(_, 2000000)).WillOnce(Return(HAL_OK));
+
+    ASSERT_TRUE(UARTxDriver.setBaudRate(2000000));
+}
+
+TEST(UartDriver, ReceiveToIdleReturnsWhatArrivedBeforeIdleLine){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+
+    uint8_t arr[10] = {0};
+    EXPECT_CALL(uart, receiveToIdleDMA(_, arr, sizeof(arr)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, _))
+        .WillOnce(
+            DoAll(SetArgPointee<2>(NOTIFIED_FROM_RX_ISR), Return(pdTRUE))
+        );
+    EXPECT_CALL(uart, getDmaRxInstanceNDTR(_)).WillOnce(Return(6));
+    EXPECT_CALL(uart, abortReceive(_)).Times(1);
+
+    size_t numReceived = 0;
+    ASSERT_TRUE(UARTxDriver.receiveToIdle(arr, sizeof(arr), numReceived));
+    EXPECT_EQ(numReceived, 4);
+}
+
+TEST(UartDriver, ReceiveToIdleFailsWhenNothingArrives){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+
+    uint8_t arr[10] = {0};
+    EXPECT_CALL(uart, receiveToIdleDMA(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_,_,_,_)).WillOnce(Return(pdFALSE));
+    EXPECT_CALL(uart, getDmaRxInstanceNDTR(_))
+        .WillOnce(Return(sizeof(arr)));
+    EXPECT_CALL(uart, abortReceive(_)).Times(1);
+
+    size_t numReceived = 1;
+    ASSERT_FALSE(UARTxDriver.receiveToIdle(arr, sizeof(arr), numReceived));
+    EXPECT_EQ(numReceived, 0);
+}
+
+TEST(UartDriver, PolledReceiveToIdleReceivesExactly){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::POLL);
+
+    uint8_t arr[10] = {0};
+    EXPECT_CALL(uart, receiveToIdleDMA(_, _, _)).Times(0);
+    EXPECT_CALL(uart, receivePoll(_, arr, sizeof(arr), _))
+        .WillOnce(Return(HAL_OK));
+
+    size_t numReceived = 0;
+    ASSERT_TRUE(UARTxDriver.receiveToIdle(arr, sizeof(arr), numReceived));
+    EXPECT_EQ(numReceived, sizeof(arr));
+}
+
+TEST(UartDriver, DMATransceiveArmsReceptionFirst){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+
+    uint8_t request[8] = {0};
+    uint8_t reply[8] = {0};
+    {
+        InSequence s;
+        EXPECT_CALL(uart, receiveDMA(_, reply, sizeof(reply)))
+            .WillOnce(Return(HAL_OK));
+        EXPECT_CALL(uart, transmitDMA(_, request, sizeof(request)))
+            .WillOnce(Return(HAL_OK));
+
+        // Only woken up once, by the reception
+        EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, _))
+            .WillOnce(
+                DoAll(SetArgPointee<2>(NOTIFIED_FROM_RX_ISR), Return(pdTRUE))
+            );
+    }
+
+    ASSERT_TRUE(
+        UARTxDriver.transceive(request, sizeof(request), reply, sizeof(reply))
+    );
+    EXPECT_FALSE(UARTxDriver.isTransceiving());
+}
+
+TEST(UartDriver, ShouldFailAndAbortBothTransfersWhenTransceiveTimesOut){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::IT);
+
+    EXPECT_CALL(uart, receiveIT(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, transmitIT(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_,_,_,_)).WillOnce(Return(pdFALSE));
+    EXPECT_CALL(uart, abortTransmit(_)).Times(1);
+    EXPECT_CALL(uart, abortReceive(_)).Times(1);
+
+    uint8_t request[8] = {0};
+    uint8_t reply[8] = {0};
+    ASSERT_FALSE(
+        UARTxDriver.transceive(request, sizeof(request), reply, sizeof(reply))
+    );
+    EXPECT_FALSE(UARTxDriver.isTransceiving());
+}
+
+TEST(UartDriver, ShouldNotTransmitWhenTransceiveCannotArmReception){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+
+    EXPECT_CALL(uart, receiveDMA(_, _, _)).WillOnce(Return(HAL_ERROR));
+    EXPECT_CALL(uart, transmitDMA(_, _, _)).Times(0);
+
+    uint8_t request[8] = {0};
+    uint8_t reply[8] = {0};
+    ASSERT_FALSE(
+        UARTxDriver.transceive(request, sizeof(request), reply, sizeof(reply))
+    );
+}
+
+TEST(UartDriver, BeginTransceiveReturnsWithoutWaitingForTransmission){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+
+    uint8_t request[8] = {0};
+    EXPECT_CALL(uart, transmitDMA(_, request, sizeof(request)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, _, _, _)).Times(0);
+    EXPECT_CALL(uart, abortTransmit(_)).Times(0);
+
+    ASSERT_TRUE(UARTxDriver.beginTransceive(request, sizeof(request)));
+    EXPECT_TRUE(UARTxDriver.isTransceiving());
+
+    UARTxDriver.endTransceive(true);
+    EXPECT_FALSE(UARTxDriver.isTransceiving());
+}
+
+TEST(UartDriver, ShouldAbortTransmissionWhenEndingFailedTransceive){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::IT);
+
+    uint8_t request[8] = {0};
+    EXPECT_CALL(uart, transmitIT(_, request, sizeof(request)))
+        .WillOnce(Return(HAL_OK));
+    EXPECT_CALL(uart, abortTransmit(_)).Times(1);
+
+    ASSERT_TRUE(UARTxDriver.beginTransceive(request, sizeof(request)));
+    UARTxDriver.endTransceive(false);
+    EXPECT_FALSE(UARTxDriver.isTransceiving());
+}
+
+TEST(UartDriver, ShouldNotBeginTransceiveWithPolledIO){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::POLL);
+
+    EXPECT_CALL(uart, transmitPoll(_, _, _, _)).Times(0);
+
+    uint8_t request[8] = {0};
+    ASSERT_FALSE(UARTxDriver.beginTransceive(request, sizeof(request)));
+    EXPECT_FALSE(UARTxDriver.isTransceiving());
+}
+
+TEST(UartDriver, DMAReceiveTimesOutInMicroseconds){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+
+    // The first tick comes early, so the task blocks again for the rest of
+    // the timeout, rounded up to a whole tick
+    EXPECT_CALL(uart, receiveDMA(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, 1))
+        .WillOnce(
+            DoAll(InvokeWithoutArgs([](){ cycles += 150; }), Return(pdFALSE))
+        )
+        .WillOnce(
+            DoAll(InvokeWithoutArgs([](){ cycles += 1000; }), Return(pdFALSE))
+        );
+    EXPECT_CALL(uart, abortReceive(_)).Times(1);
+
+    // 10 bytes take 100 us at 1 Mbps, on top of the timeout
+    uint8_t arr[10] = {0};
+    ASSERT_FALSE(UARTxDriver.receive(arr, sizeof(arr)));
+    EXPECT_GE(cycles, MAX_BLOCK_TIME_US + 100);
+}
+
+TEST(UartDriver, BlocksForRemainingTicksOfMicrosecondTimeout){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+    UARTxDriver.setMaxBlockTimeUs(2500);
+
+    // 2600 us is 3 ticks, and 1900 us are left after the first wakeup
+    InSequence s;
+    EXPECT_CALL(uart, receiveDMA(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, 3))
+        .WillOnce(
+            DoAll(InvokeWithoutArgs([](){ cycles += 700; }), Return(pdFALSE))
+        );
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, 2))
+        .WillOnce(
+            DoAll(InvokeWithoutArgs([](){ cycles += 2000; }), Return(pdFALSE))
+        );
+    EXPECT_CALL(uart, abortReceive(_)).Times(1);
+
+    uint8_t arr[10] = {0};
+    ASSERT_FALSE(UARTxDriver.receive(arr, sizeof(arr)));
+}
+
+TEST(UartDriver, ITTransmitCanSucceedWithMicrosecondTimeout){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::IT);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+
+    // A spurious wakeup part way through the timeout is waited past
+    EXPECT_CALL(uart, transmitIT(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_TX_ISR, _, 1))
+        .WillOnce(
+            DoAll(InvokeWithoutArgs([](){ cycles += 100; }), Return(pdFALSE))
+        )
+        .WillOnce(
+            DoAll(SetArgPointee<2>(NOTIFIED_FROM_TX_ISR), Return(pdTRUE))
+        );
+    EXPECT_CALL(uart, abortTransmit(_)).Times(0);
+
+    uint8_t arr[10] = {0};
+    ASSERT_TRUE(UARTxDriver.transmit(arr, sizeof(arr)));
+    EXPECT_EQ(cycles, 100u);
+}
+
+TEST(UartDriver, PollReceiveRoundsMicrosecondTimeoutUpToMilliseconds){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::POLL);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+
+    EXPECT_CALL(uart, receivePoll(_, _, _, 1)).WillOnce(Return(HAL_OK));
+
+    uint8_t arr[10] = {0};
+    ASSERT_TRUE(UARTxDriver.receive(arr, sizeof(arr)));
+}
+
+TEST(UartDriver, WakesUpFromTimerAtMicrosecondTimeout){
+    MockUartInterface uart;
+    MockOsInterface os;
+    MockTimerInterface timer;
+    UART_HandleTypeDef UARTx = {0};
+    TIM_HandleTypeDef htim = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+    UARTxDriver.setWakeupTimer(&timer, &htim, TIM_CHANNEL_2);
+
+    // 10 bytes take 100 us at 1 Mbps, on top of the timeout. The OS only
+    // times out the wait a tick after the timer is due
+    InSequence s;
+    EXPECT_CALL(uart, receiveDMA(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(
+        timer,
+        startOneShot(&htim, TIM_CHANNEL_2, MAX_BLOCK_TIME_US + 100)
+    );
+    EXPECT_CALL(
+        os,
+        OS_xTaskNotifyWait(
+            _,
+            NOTIFIED_FROM_RX_ISR | NOTIFIED_FROM_TIMER_ISR,
+            _,
+            2
+        )
+    ).WillOnce(
+        DoAll(
+            InvokeWithoutArgs([](){ cycles += MAX_BLOCK_TIME_US + 100; }),
+            SetArgPointee<2>(NOTIFIED_FROM_TIMER_ISR),
+            Return(pdTRUE)
+        )
+    );
+    EXPECT_CALL(timer, stopOneShot(&htim, TIM_CHANNEL_2));
+    EXPECT_CALL(uart, abortReceive(_)).Times(1);
+
+    uint8_t arr[10] = {0};
+    ASSERT_FALSE(UARTxDriver.receive(arr, sizeof(arr)));
+}
+
+TEST(UartDriver, StopsWakeupTimerWhenTransferCompletes){
+    MockUartInterface uart;
+    MockOsInterface os;
+    MockTimerInterface timer;
+    UART_HandleTypeDef UARTx = {0};
+    TIM_HandleTypeDef htim = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    UARTxDriver.setIOType(uart::IO_Type::DMA);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+    UARTxDriver.setWakeupTimer(&timer, &htim, TIM_CHANNEL_1);
+
+    InSequence s;
+    EXPECT_CALL(uart, transmitDMA(_, _, _)).WillOnce(Return(HAL_OK));
+    EXPECT_CALL(timer, startOneShot(&htim, TIM_CHANNEL_1, _));
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, _, _, _)).WillOnce(
+        DoAll(SetArgPointee<2>(NOTIFIED_FROM_TX_ISR), Return(pdTRUE))
+    );
+    EXPECT_CALL(timer, stopOneShot(&htim, TIM_CHANNEL_1));
+    EXPECT_CALL(uart, abortTransmit(_)).Times(0);
+
+    uint8_t arr[10] = {0};
+    ASSERT_TRUE(UARTxDriver.transmit(arr, sizeof(arr)));
+}
+
+TEST(UartDriver, StreamWaitBlocksOnReceiverUntilMicrosecondTimeout){
+    MockUartInterface uart;
+    MockOsInterface os;
+    UART_HandleTypeDef UARTx = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+
+    // Each wait is cut short by the receiver
+    EXPECT_CALL(os, OS_xTaskGetTickCount()).Times(0);
+    EXPECT_CALL(os, OS_xTaskNotifyWait(_, NOTIFIED_FROM_RX_ISR, _, 1))
+        .WillRepeatedly(
+            DoAll(
+                InvokeWithoutArgs([](){ cycles += CYCLES_PER_WAIT; }),
+                SetArgPointee<2>(NOTIFIED_FROM_RX_ISR),
+                Return(pdTRUE)
+            )
+        );
+
+    const TickType_t start = UARTxDriver.getTickCount();
+    size_t numWaits = 0;
+    while(UARTxDriver.waitForStream(start)){
+        ++numWaits;
+    }
+
+    EXPECT_EQ(numWaits, MAX_BLOCK_TIME_US / CYCLES_PER_WAIT);
+}
+
+TEST(UartDriver, StreamWaitArmsWakeupTimerForTimeLeft){
+    MockUartInterface uart;
+    MockOsInterface os;
+    MockTimerInterface timer;
+    UART_HandleTypeDef UARTx = {0};
+    TIM_HandleTypeDef htim = {0};
+
+    UartDriver UARTxDriver(&os, &uart, &UARTx);
+    useMicrosecondTimeouts(UARTxDriver, uart);
+    UARTxDriver.setWakeupTimer(&timer, &htim, TIM_CHANNEL_3);
+
+    const TickType_t start = UARTxDriver.getTickCount();
+    cycles += 120;
+
+    InSequence s;
+    EXPECT_CALL(
+        timer,
+        startOneShot(&htim, TIM_CHANNEL_3, MAX_BLOCK_TIME_US - 120)
+    );
+    EXPECT_CALL(
+        os,
+        OS_xTaskNotifyWait(
+            _,
+            NOTIFIED_FROM_RX_ISR | NOTIFIED_FROM_TIMER_ISR,
+            _,
+            2
+        )
+    ).WillOnce(
+        DoAll(
+            InvokeWithoutArgs([](){ cycles += MAX_BLOCK_TIME_US - 120; }),
+            SetArgPointee<2>(NOTIFIED_FROM_TIMER_ISR),
+            Return(pdTRUE)
+        )
+    );
+    EXPECT_CALL(timer, stopOneShot(&htim, TIM_CHANNEL_3));
+
+    EXPECT_TRUE(UARTxDriver.waitForStream(start));
+    EXPECT_FALSE(UARTxDriver.waitForStream(start));
+}
+
 } // end anonymous namespace
 
 /**
@@ -0,0 +1,349 @@
+/**
+  *****************************************************************************
+  * @file    WireFormat_test.cpp
+  * @author  Tyler Gamvrelis
+  *
+  * @defgroup WireFormat_Test
+  * @ingroup  WireFormat
+  * @brief    Unit test driver for the PC link's fixed-point encoding
+  * @{
+  *****************************************************************************
+  */
+
+
+
+
+/********************************* Includes **********************************/
+#include "WireFormat.h"
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+using comm::FieldType;
+using comm::fieldScale;
+using comm::NUM_GOAL_JOINTS;
+using comm::NUM_STATE_JOINTS;
+using comm::NUM_STATE_IMU;
+using comm::NUM_STATE_HEALTH;
+using comm::GOAL_MESSAGE_SIZE;
+using comm::STATE_MESSAGE_SIZE;
+
+
+
+
+/******************************** File-local *********************************/
+namespace{
+// Functions
+// ----------------------------------------------------------------------------
+/**
+ * @brief Returns the most a value of the field may be rounded by, allowing for
+ *        float error on values that sit exactly between two LSBs
+ */
+float halfLsb(FieldType type){
+    return fieldScale(type) / 2 + 1e-4f;
+}
+
+TEST(WireFormatTest, MessagesAreCompact){
+    // Preamble plus 2 bytes per field, versus 4 bytes per float before
+    EXPECT_EQ(GOAL_MESSAGE_SIZE, 40);
+    EXPECT_EQ(STATE_MESSAGE_SIZE, 68);
+}
+
+TEST(WireFormatTest, ScalesMatchSensorResolutions){
+    EXPECT_FLOAT_EQ(fieldScale(FieldType::JOINT_MX28), 300.0f / 4095.0f);
+    EXPECT_FLOAT_EQ(fieldScale(FieldType::JOINT_AX12A), 300.0f / 1023.0f);
+    EXPECT_FLOAT_EQ(fieldScale(FieldType::GYRO), 1.0f / 131.0f);
+    EXPECT_FLOAT_EQ(fieldScale(FieldType::ACCEL), 9.81f / 16384.0f);
+    EXPECT_FLOAT_EQ(fieldScale(FieldType::LOAD), 0.1f);
+    EXPECT_FLOAT_EQ(fieldScale(FieldType::TEMPERATURE), 1.0f);
+    EXPECT_FLOAT_EQ(fieldScale(FieldType::VOLTAGE), 0.1f);
+}
+
+TEST(WireFormatTest, GoalRoundTripsWithinHalfAnLsb){
+    float angles[NUM_GOAL_JOINTS];
+    for(size_t i = 0; i < NUM_GOAL_JOINTS; ++i){
+        angles[i] = -150.0f + 17.3f * i;
+    }
+
+    uint8_t message[GOAL_MESSAGE_SIZE];
+    comm::encodeGoal(0xBEEF, angles, message);
+    EXPECT_EQ(message[0], comm::WIRE_FORMAT_VERSION);
+    EXPECT_EQ(message[1], static_cast<uint8_t>(comm::MessageType::GOAL));
+    EXPECT_EQ(comm::goalMessageSize(message), GOAL_MESSAGE_SIZE);
+
+    uint16_t id = 0;
+    uint32_t jointMask = 0;
+    float decoded[NUM_GOAL_JOINTS];
+    ASSERT_TRUE(comm::decodeGoal(message, sizeof(message), id, jointMask, decoded));
+    EXPECT_EQ(id, 0xBEEF);
+    EXPECT_EQ(jointMask, comm::ALL_GOAL_JOINTS);
+    for(size_t i = 0; i < NUM_GOAL_JOINTS; ++i){
+        EXPECT_NEAR(
+            decoded[i],
+            angles[i],
+            halfLsb(comm::GOAL_FIELDS[i])
+        ) << "joint " << i;
+    }
+}
+
+TEST(WireFormatTest, StateRoundTripsWithinHalfAnLsb){
+    float angles[NUM_STATE_JOINTS];
+    for(size_t i = 0; i < NUM_STATE_JOINTS; ++i){
+        angles[i] = 10.0f * i - 60.0f;
+    }
+    const float imu[NUM_STATE_IMU] = {-200.0f, 0.5f, 249.9f, 9.81f, -3.2f, 0.0f};
+    float loads[NUM_STATE_JOINTS];
+    for(size_t i = 0; i < NUM_STATE_JOINTS; ++i){
+        loads[i] = 8.33f * i - 50.0f;
+    }
+    const float health[NUM_STATE_HEALTH] = {57.0f, 11.6f};
+
+    uint8_t message[STATE_MESSAGE_SIZE];
+    comm::encodeState(42, angles, imu, loads, health, message);
+
+    uint16_t id = 0;
+    float decodedAngles[NUM_STATE_JOINTS];
+    float decodedImu[NUM_STATE_IMU];
+    float decodedLoads[NUM_STATE_JOINTS];
+    float decodedHealth[NUM_STATE_HEALTH];
+    ASSERT_TRUE(
+        comm::decodeState(
+            message,
+            sizeof(message),
+            id,
+            decodedAngles,
+            decodedImu,
+            decodedLoads,
+            decodedHealth
+        )
+    );
+    EXPECT_EQ(id, 42);
+    for(size_t i = 0; i < NUM_STATE_JOINTS; ++i){
+        EXPECT_NEAR(decodedAngles[i], angles[i], halfLsb(FieldType::JOINT_MX28));
+    }
+    for(size_t i = 0; i < NUM_STATE_IMU; ++i){
+        EXPECT_NEAR(
+            decodedImu[i],
+            imu[i],
+            halfLsb(comm::STATE_FIELDS[NUM_STATE_JOINTS + i])
+        ) << "IMU reading " << i;
+    }
+    for(size_t i = 0; i < NUM_STATE_JOINTS; ++i){
+        EXPECT_NEAR(decodedLoads[i], loads[i], halfLsb(FieldType::LOAD));
+    }
+    EXPECT_NEAR(
+        decodedHealth[comm::STATE_HEALTH_TEMPERATURE],
+        57.0f,
+        halfLsb(FieldType::TEMPERATURE)
+    );
+    EXPECT_NEAR(
+        decodedHealth[comm::STATE_HEALTH_VOLTAGE],
+        11.6f,
+        halfLsb(FieldType::VOLTAGE)
+    );
+}
+
+TEST(WireFormatTest, EncodesLittleEndianAndRoundsHalfAwayFromZero){
+    float angles[NUM_GOAL_JOINTS] = {};
+    const float tick = fieldScale(FieldType::JOINT_MX28);
+    angles[0] = 2.5f * tick;
+    angles[1] = -2.5f * tick;
+    angles[2] = 300.0f;
+
+    uint8_t message[GOAL_MESSAGE_SIZE];
+    comm::encodeGoal(0x0102, angles, message);
+
+    EXPECT_EQ(message[2], 0x02);
+    EXPECT_EQ(message[3], 0x01);
+    EXPECT_EQ(message[4], 3);
+    EXPECT_EQ(message[5], 0);
+    EXPECT_EQ(message[6], 0xFD);
+    EXPECT_EQ(message[7], 0xFF);
+    EXPECT_EQ(message[8] | (message[9] << 8), 4095);
+}
+
+TEST(WireFormatTest, SaturatesOutOfRangeValues){
+    float angles[NUM_STATE_JOINTS] = {};
+    angles[0] = 1e6f;
+    angles[1] = -1e6f;
+    const float imu[NUM_STATE_IMU] = {1000.0f, -1000.0f, 0, 0, 0, 0};
+    const float loads[NUM_STATE_JOINTS] = {};
+    const float health[NUM_STATE_HEALTH] = {};
+
+    uint8_t message[STATE_MESSAGE_SIZE];
+    comm::encodeState(0, angles, imu, loads, health, message);
+
+    uint16_t id;
+    float decodedAngles[NUM_STATE_JOINTS];
+    float decodedImu[NUM_STATE_IMU];
+    float decodedLoads[NUM_STATE_JOINTS];
+    float decodedHealth[NUM_STATE_HEALTH];
+    ASSERT_TRUE(
+        comm::decodeState(
+            message,
+            sizeof(message),
+            id,
+            decodedAngles,
+            decodedImu,
+            decodedLoads,
+            decodedHealth
+        )
+    );
+    EXPECT_FLOAT_EQ(decodedAngles[0], INT16_MAX * fieldScale(FieldType::JOINT_MX28));
+    EXPECT_FLOAT_EQ(decodedAngles[1], INT16_MIN * fieldScale(FieldType::JOINT_MX28));
+    EXPECT_FLOAT_EQ(decodedImu[0], INT16_MAX * fieldScale(FieldType::GYRO));
+    EXPECT_FLOAT_EQ(decodedImu[1], INT16_MIN * fieldScale(FieldType::GYRO));
+}
+
+TEST(WireFormatTest, SparseGoalCarriesOnlyMaskedJoints){
+    float angles[NUM_GOAL_JOINTS];
+    for(size_t i = 0; i < NUM_GOAL_JOINTS; ++i){
+        angles[i] = 5.0f * i;
+    }
+
+    // Head pan and tilt only
+    const uint32_t mask = (1u << 16) | (1u << 17);
+    uint8_t message[comm::MAX_SPARSE_GOAL_MESSAGE_SIZE];
+    const size_t size = comm::encodeSparseGoal(99, mask, angles, message);
+    EXPECT_EQ(size, 12);
+    EXPECT_EQ(comm::goalMessageSize(message), size);
+
+    uint16_t id = 0;
+    uint32_t jointMask = 0;
+    float decoded[NUM_GOAL_JOINTS];
+    std::fill(decoded, decoded + NUM_GOAL_JOINTS, -1.0f);
+    ASSERT_TRUE(comm::decodeGoal(message, size, id, jointMask, decoded));
+    EXPECT_EQ(id, 99);
+    EXPECT_EQ(jointMask, mask);
+    EXPECT_NEAR(decoded[16], 80.0f, halfLsb(FieldType::JOINT_AX12A));
+    EXPECT_NEAR(decoded[17], 85.0f, halfLsb(FieldType::JOINT_AX12A));
+    for(size_t i = 0; i < 16; ++i){
+        EXPECT_EQ(decoded[i], -1.0f) << "joint " << i;
+    }
+}
+
+TEST(WireFormatTest, SparseGoalsArePaddedToWholeWords){
+    const float angles[NUM_GOAL_JOINTS] = {};
+    uint8_t message[comm::MAX_SPARSE_GOAL_MESSAGE_SIZE];
+    EXPECT_EQ(comm::encodeSparseGoal(0, 0, angles, message), 8);
+    EXPECT_EQ(comm::encodeSparseGoal(0, 0x1, angles, message), 12);
+    EXPECT_EQ(comm::encodeSparseGoal(0, 0x3, angles, message), 12);
+    EXPECT_EQ(comm::encodeSparseGoal(0, 0x7, angles, message), 16);
+    EXPECT_EQ(
+        comm::encodeSparseGoal(0, comm::ALL_GOAL_JOINTS, angles, message),
+        comm::MAX_SPARSE_GOAL_MESSAGE_SIZE
+    );
+}
+
+TEST(WireFormatTest, RejectsOtherVersionsAndTypes){
+    float angles[NUM_GOAL_JOINTS] = {};
+    uint8_t message[GOAL_MESSAGE_SIZE];
+    comm::encodeGoal(7, angles, message);
+
+    uint16_t id = 0;
+    uint32_t jointMask = 0;
+    float decoded[NUM_GOAL_JOINTS];
+    EXPECT_FALSE(
+        comm::decodeGoal(message, sizeof(message) - 1, id, jointMask, decoded)
+    );
+
+    message[0] = comm::WIRE_FORMAT_VERSION + 1;
+    EXPECT_FALSE(comm::decodeGoal(message, sizeof(message), id, jointMask, decoded));
+    EXPECT_EQ(comm::goalMessageSize(message), 0);
+
+    message[0] = comm::WIRE_FORMAT_VERSION;
+    message[1] = static_cast<uint8_t>(comm::MessageType::STATE);
+    EXPECT_FALSE(comm::decodeGoal(message, sizeof(message), id, jointMask, decoded));
+    EXPECT_EQ(id, 0);
+
+    float imu[NUM_STATE_IMU];
+    float loads[NUM_STATE_JOINTS];
+    float health[NUM_STATE_HEALTH];
+    message[1] = static_cast<uint8_t>(comm::MessageType::GOAL);
+    EXPECT_FALSE(
+        comm::decodeState(
+            message,
+            sizeof(message),
+            id,
+            decoded,
+            imu,
+            loads,
+            health
+        )
+    );
+}
+
+TEST(WireFormatTest, RejectsSparseGoalsWithUnknownJoints){
+    const float angles[NUM_GOAL_JOINTS] = {};
+    uint8_t message[comm::MAX_SPARSE_GOAL_MESSAGE_SIZE];
+    const size_t size = comm::encodeSparseGoal(0, 0x1, angles, message);
+
+    message[comm::MESSAGE_PREAMBLE_SIZE + 2] = 0x04;
+    EXPECT_EQ(comm::goalMessageSize(message), 0);
+
+    uint16_t id;
+    uint32_t jointMask;
+    float decoded[NUM_GOAL_JOINTS];
+    EXPECT_FALSE(comm::decodeGoal(message, size, id, jointMask, decoded));
+}
+
+TEST(WireFormatTest, TimedGoalRoundTrips){
+    float angles[NUM_GOAL_JOINTS];
+    for(size_t i = 0; i < NUM_GOAL_JOINTS; ++i){
+        angles[i] = 90.0f - 9.0f * i;
+    }
+
+    uint8_t message[comm::TIMED_GOAL_MESSAGE_SIZE];
+    comm::encodeTimedGoal(7, 250, comm::TIMED_GOAL_REPLACE, angles, message);
+    EXPECT_EQ(comm::goalMessageSize(message), comm::TIMED_GOAL_MESSAGE_SIZE);
+
+    uint16_t id = 0;
+    uint16_t durationMs = 0;
+    uint8_t flags = 0;
+    float decoded[NUM_GOAL_JOINTS];
+    ASSERT_TRUE(
+        comm::decodeTimedGoal(message, sizeof(message), id, durationMs, flags, decoded)
+    );
+    EXPECT_EQ(id, 7);
+    EXPECT_EQ(durationMs, 250);
+    EXPECT_EQ(flags, comm::TIMED_GOAL_REPLACE);
+    for(size_t i = 0; i < NUM_GOAL_JOINTS; ++i){
+        EXPECT_NEAR(
+            decoded[i],
+            angles[i],
+            halfLsb(comm::GOAL_FIELDS[i])
+        ) << "joint " << i;
+    }
+
+    EXPECT_FALSE(
+        comm::decodeTimedGoal(message, sizeof(message) - 1, id, durationMs, flags, decoded)
+    );
+}
+
+TEST(WireFormatTest, TimedGoalsAreNotDecodedAsGoals){
+    const float angles[NUM_GOAL_JOINTS] = {};
+    uint8_t message[comm::TIMED_GOAL_MESSAGE_SIZE];
+    comm::encodeTimedGoal(0, 100, 0, angles, message);
+
+    uint16_t id;
+    uint32_t jointMask;
+    float decoded[NUM_GOAL_JOINTS];
+    EXPECT_FALSE(comm::decodeGoal(message, sizeof(message), id, jointMask, decoded));
+
+    uint16_t durationMs;
+    uint8_t flags;
+    comm::encodeGoal(0, angles, message);
+    EXPECT_FALSE(
+        comm::decodeTimedGoal(message, sizeof(message), id, durationMs, flags, decoded)
+    );
+}
+
+} // end anonymous namespace
+
+
+
+
+/**
+ * @}
+ */
+/* end - WireFormat_Test */
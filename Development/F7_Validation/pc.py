@@ -13,62 +13,149 @@ import struct
 from datetime import datetime
 from prettytable import PrettyTable
 
-def rxDecoder(raw, decodeHeader=True):
-    ''' Decodes raw bytes received from the microcontroller. As per the agreed
-        upon protocol, the first 4 bytes are for a header while the remaining
-        80 bytes contain floats for each motor.
+# Wire format shared with the MCU (see WireFormat.h). Each message is the
+# version, the message type and a 16-bit ID, followed by one little-endian
+# int16 per field, in units of the field's resolution. A sparse goal has a
+# 32-bit joint mask after the ID and only the fields of the joints in it,
+# zero-padded to a multiple of 4 bytes. A timed goal has a 16-bit duration in
+# ms, a flags byte and a zero byte after the ID, then every joint's field
+WIRE_FORMAT_VERSION = 3
+GOAL_TYPE = 1
+STATE_TYPE = 2
+SPARSE_GOAL_TYPE = 3
+TIMED_GOAL_TYPE = 4
+TIMED_GOAL_REPLACE = 0x01
+MX28_SCALE = 300.0 / 4095    # deg per position tick
+AX12A_SCALE = 300.0 / 1023   # deg per position tick
+GYRO_SCALE = 1.0 / 131       # deg/s per LSB at +/- 250 deg/s
+ACCEL_SCALE = 9.81 / 16384   # m/s^2 per LSB at +/- 2 g
+LOAD_SCALE = 0.1             # % of max torque per LSB
+TEMPERATURE_SCALE = 1.0      # deg C per LSB
+VOLTAGE_SCALE = 0.1          # V per LSB
+GOAL_SCALES = [MX28_SCALE] * 12 + [AX12A_SCALE] * 6
+STATE_SCALES = ([MX28_SCALE] * 12 + [GYRO_SCALE] * 3 + [ACCEL_SCALE] * 3 +
+                [LOAD_SCALE] * 12 + [TEMPERATURE_SCALE, VOLTAGE_SCALE])
+GOAL_MESSAGE_SIZE = 4 + 2 * len(GOAL_SCALES)
+STATE_MESSAGE_SIZE = 4 + 2 * len(STATE_SCALES)
+STATE_FRAME_SIZE = 4 + STATE_MESSAGE_SIZE + 4
+
+def toFixed(value, scale):
+    ''' Converts a value to the nearest LSB of its field, rounding halves away
+        from zero and saturating to the int16 range like the MCU does.
     '''
+    lsbs = value / scale
+    lsbs = int(lsbs + 0.5) if lsbs >= 0 else int(lsbs - 0.5)
+    return max(-32768, min(32767, lsbs))
+
+def encodeGoal(id, angles):
+    ''' Encodes a goal message holding the ID and 18 joint angles in degrees.
+    '''
+    message = struct.pack('<BBH', WIRE_FORMAT_VERSION, GOAL_TYPE, id)
+    for (angle, scale) in zip(angles, GOAL_SCALES):
+        message = message + struct.pack('<h', toFixed(angle, scale))
+    return message
+
+def encodeSparseGoal(id, angles, jointMask):
+    ''' Encodes a sparse goal message holding the ID and the angles in degrees
+        of the joints whose bits are set in jointMask.
+    '''
+    message = struct.pack('<BBHL', WIRE_FORMAT_VERSION, SPARSE_GOAL_TYPE, id,
+                          jointMask)
+    for i in range(len(GOAL_SCALES)):
+        if(jointMask & (1 << i)):
+            message = message + struct.pack('<h',
+                                             toFixed(angles[i], GOAL_SCALES[i]))
+    while(len(message) % 4 != 0):
+        message = message + struct.pack('<B', 0x00)
+    return message
+
+def encodeTimedGoal(id, angles, durationMs, replace=False):
+    ''' Encodes a timed goal message holding the ID, the time in ms to reach
+        the angles from the previous timed goal, and 18 joint angles in
+        degrees. If replace is set, the goals queued on the MCU are dropped
+        and the angles are reached from wherever the joints are.
+    '''
+    flags = TIMED_GOAL_REPLACE if replace else 0
+    message = struct.pack('<BBHHBB', WIRE_FORMAT_VERSION, TIMED_GOAL_TYPE, id,
+                          durationMs, flags, 0)
+    for (angle, scale) in zip(angles, GOAL_SCALES):
+        message = message + struct.pack('<h', toFixed(angle, scale))
+    return message
+
+def changedJoints(angles, lastAngles):
+    ''' Returns the mask of the joints whose goals differ once encoded.
+    '''
+    jointMask = 0
+    for i in range(len(GOAL_SCALES)):
+        if(toFixed(angles[i], GOAL_SCALES[i]) != 
+           toFixed(lastAngles[i], GOAL_SCALES[i])):
+            jointMask = jointMask | (1 << i)
+    return jointMask
+
+def rxDecoder(message):
+    ''' Decodes a state message received from the microcontroller into its
+        ID, 12 joint angles in degrees, 6 IMU readings, 12 joint loads in
+        percent, and the hottest motor temperature and lowest motor voltage.
+        Returns None if the message is of another version or layout.
+    '''
+    (version, type, id) = struct.unpack('<BBH', message[0:4])
+    if(version != WIRE_FORMAT_VERSION or type != STATE_TYPE):
+        return None
     
-    motors = list()
-    imu = list()
-    
-    if(decodeHeader):
-        header = struct.unpack('<L',raw[0:4])[0]
-        for i in range(12):
-            # Here, we only unpack for 12 motors since that's all we have connected
-            # in our current setup
-            motors.append(struct.unpack('<f',raw[8 + i * 4:12 + i * 4])[0])
-        for i in range(6):
-            # Unpack IMU Data
-            imu.append(struct.unpack('<f', raw[56 + i * 4: 60 + i * 4])[0])
-        return (header, motors, imu)
-    else:
-        for i in range(12):
-            # Here, we only unpack for 12 motors since that's all we have connected
-            # in our current setup
-            motors.append(struct.unpack('<f',raw[4 + i * 4:8 + i * 4])[0])
-        for i in range(6):
-            # Unpack IMU Data
-            imu.append(struct.unpack('<f', raw[52 + i * 4: 56 + i * 4])[0])
-        return (motors, imu)
+    values = list()
+    for i in range(len(STATE_SCALES)):
+        lsbs = struct.unpack('<h', message[4 + i * 2:6 + i * 2])[0]
+        values.append(lsbs * STATE_SCALES[i])
+    return (id, values[0:12], values[12:18], values[18:30], values[30],
+            values[31])
     
 def logString(userMsg):
     ''' Prints the desired string to the shell, precedded by the date and time.
     '''
     print(datetime.now().strftime('%H.%M.%S.%f') + " " + userMsg)
 
-def sendPacketToMCU(byteStream):
-    ''' Sends bytes to the MCU with the header sequence attached.
+def crc32Stm32(payload):
+    ''' Computes the CRC of a payload the same way as the MCU's CRC unit does:
+        polynomial 0x04C11DB7, initial value 0xFFFFFFFF, fed one little-endian
+        32-bit word at a time, without reflection or a final XOR.
+    '''
+    crc = 0xFFFFFFFF
+    for i in range(0, len(payload) - 3, 4):
+        crc ^= struct.unpack('<L', payload[i:i+4])[0]
+        for _ in range(32):
+            if(crc & 0x80000000):
+                crc = ((crc << 1) ^ 0x04C11DB7) & 0xFFFFFFFF
+            else:
+                crc = (crc << 1) & 0xFFFFFFFF
+    return crc
+
+def sendPacketToMCU(angles, lastAngles=None):
+    ''' Sends a goal message for the joint angles to the MCU with the header
+        sequence attached, followed by the CRC of the message. Goals whose CRC
+        does not match are dropped. If the last angles sent are given, only
+        the joints that changed are sent, when that is shorter.
     '''
     header = struct.pack('<L', 0xFFFFFFFF)
-    id = struct.pack('<I', 0x1234)
-    padding = bytes(''.encode())
-    footer = struct.pack('<L', 0x00000000)
-    
-    numBytes = len(byteStream)
-    if(numBytes < 80):
-        padding = struct.pack('<B', 0x00) * (80 - numBytes)
+    payload = encodeGoal(0x1234, angles)
+    if(lastAngles is not None):
+        sparse = encodeSparseGoal(0x1234, angles,
+                                  changedJoints(angles, lastAngles))
+        if(len(sparse) < len(payload)):
+            payload = sparse
+    footer = struct.pack('<L', crc32Stm32(payload))
         
-    ser.write(header + id + byteStream + padding + footer)
-    
-def vec2bytes(vec):
-    ''' Transforms a numpy vector to a byte array, with entries interpreted as
-        32-bit floats.
+    ser.write(header + payload + footer)
+
+def sendTimedPacketToMCU(angles, durationMs, replace=False):
+    ''' Sends a timed goal message for the joint angles to the MCU, framed
+        like sendPacketToMCU. The MCU queues a few of these and interpolates
+        between them, so they can be sent ahead of time at a low rate.
     '''
-    byteArr = bytes(''.encode())
-    for element in vec:
-        byteArr = byteArr + struct.pack('f', element)
-    return byteArr
+    header = struct.pack('<L', 0xFFFFFFFF)
+    payload = encodeTimedGoal(0x1234, angles, durationMs, replace)
+    footer = struct.pack('<L', crc32Stm32(payload))
+
+    ser.write(header + payload + footer)
 
 def printAsAngles(vec1, vec2):
     ''' Prints out 2 numpy vectors side-by-side, where the first vector entry
@@ -96,9 +183,8 @@ def printAsIMUData(vec1):
     print(t)
     
 def receivePacketFromMCU():
-    ''' Receives 80 bytes of the MCU provided that there is a valid 4-byte 
-        header attached to the front. Returns the list of data interpreted as
-        32-bit floats.
+    ''' Receives a state message and its CRC from the MCU provided that there
+        is a valid 4-byte header attached to the front.
     '''
     BUFF_SIZE = 4
     totalBytesRead = 0
@@ -114,14 +200,14 @@ def receivePacketFromMCU():
             if(startSeqCount == 4):
                 buff = buff + rawData[i:i+1]
                 totalBytesRead = totalBytesRead + 1
-                if(totalBytesRead == 84):
+                if(totalBytesRead == STATE_MESSAGE_SIZE + 4):
                     break
             else:
                 if(struct.unpack('<B', rawData[i:i+1])[0] == 0xFF):
                     startSeqCount = startSeqCount + 1
                 else:
                     startSeqCount = 0
-        if(totalBytesRead == 84):
+        if(totalBytesRead == STATE_MESSAGE_SIZE + 4):
             break
     return buff
     
@@ -130,8 +216,18 @@ def receiveWithChecks():
         for data integrity. Also decodes the packet and prints a data readout 
         every so often.
     '''
-    (recvAngles, recvIMUData) = rxDecoder(receivePacketFromMCU(),
-                                            decodeHeader=False)
+    buff = receivePacketFromMCU()
+    message = buff[0:STATE_MESSAGE_SIZE]
+    crc = struct.unpack('<L', buff[STATE_MESSAGE_SIZE:])[0]
+    if(crc != crc32Stm32(message)):
+        logString("CRC mismatch")
+        return
+    
+    decoded = rxDecoder(message)
+    if(decoded is None):
+        logString("Unknown wire format version")
+        return
+    (id, recvAngles, recvIMUData, _, _, _) = decoded
     
     if(numTransfers % 50 == 0):
         print('\n')
@@ -146,11 +242,14 @@ def receiveWithoutChecks():
         and doing no checks whatsoever. Also decodes the packet and prints
         a data readout every so often.
     '''
-    while(ser.in_waiting < 92):
+    while(ser.in_waiting < STATE_FRAME_SIZE):
         time.sleep(0.001)
-    rawData = ser.read(92)
+    rawData = ser.read(STATE_FRAME_SIZE)
                     
-    (header, recvAngles, recvIMUData) = rxDecoder(rawData)
+    header = struct.unpack('<L', rawData[0:4])[0]
+    (id, recvAngles, recvIMUData, _, _, _) = rxDecoder(
+        rawData[4:4 + STATE_MESSAGE_SIZE]
+    )
     
     if(numTransfers % 50 == 0):
         print('\n')
@@ -171,11 +270,13 @@ if __name__ == "__main__":
         logString("Opened port " + ser.name)
         
         numTransfers = 0
+        lastAngles = None
         while(ser.isOpen()):
             #dummy=input('') # Uncomment this if you want to step through the trajectories via user input
             #angles = trajectory[:, i:i+1]
             angles = np.zeros((18, 1))
-            sendPacketToMCU(vec2bytes(angles))
+            sendPacketToMCU(angles.flatten(), lastAngles)
+            lastAngles = angles.flatten()
             
             numTransfers = numTransfers + 1
             